@@ -0,0 +1,139 @@
+#include "common.h"
+#include "array.h"
+
+/*
+	Array get/set in sequential and in random order, tau is the argument.
+*/
+
+static void BM_ArrayGetSequential(benchmark::State& state)
+{
+	Integer tau = Integer(state.range(0));
+	ds::Array a(BENCHMARK_ELEMENTS, tau);
+	for (auto _ : state)
+	{
+		Integer sum = 0;
+		for (Integer i = 0; i < BENCHMARK_ELEMENTS; i++)sum += a.get(i);
+		benchmark::DoNotOptimize(sum);
+	}
+	reportRates(state, BENCHMARK_ELEMENTS, BENCHMARK_ELEMENTS * tau / 8);
+}
+BENCHMARK(BM_ArrayGetSequential)->Arg(1)->Arg(7)->Arg(13)->Arg(16)->Arg(31)->Arg(32)->Arg(47)->Arg(64);
+
+static void BM_ArraySetSequential(benchmark::State& state)
+{
+	Integer tau = Integer(state.range(0));
+	ds::Array a(BENCHMARK_ELEMENTS, tau);
+	Integer mask = tau == IntegerBitSize ? ~Integer(0) : (Integer(1) << tau) - 1;
+	for (auto _ : state)
+	{
+		for (Integer i = 0; i < BENCHMARK_ELEMENTS; i++)a.set(i, i & mask);
+		benchmark::ClobberMemory();
+	}
+	reportRates(state, BENCHMARK_ELEMENTS, BENCHMARK_ELEMENTS * tau / 8);
+}
+BENCHMARK(BM_ArraySetSequential)->Arg(1)->Arg(7)->Arg(13)->Arg(16)->Arg(31)->Arg(32)->Arg(47)->Arg(64);
+
+static void BM_ArrayGetRandom(benchmark::State& state)
+{
+	Integer tau = Integer(state.range(0));
+	ds::Array a(BENCHMARK_ELEMENTS, tau);
+	std::vector<Integer> indices = randomIndices(BENCHMARK_ELEMENTS, BENCHMARK_ELEMENTS);
+	for (auto _ : state)
+	{
+		Integer sum = 0;
+		for (Integer i : indices)sum += a.get(i);
+		benchmark::DoNotOptimize(sum);
+	}
+	reportRates(state, BENCHMARK_ELEMENTS, BENCHMARK_ELEMENTS * tau / 8);
+}
+BENCHMARK(BM_ArrayGetRandom)->Arg(1)->Arg(7)->Arg(13)->Arg(16)->Arg(31)->Arg(32)->Arg(47)->Arg(64);
+
+static void BM_ArraySetRandom(benchmark::State& state)
+{
+	Integer tau = Integer(state.range(0));
+	ds::Array a(BENCHMARK_ELEMENTS, tau);
+	std::vector<Integer> indices = randomIndices(BENCHMARK_ELEMENTS, BENCHMARK_ELEMENTS);
+	Integer mask = tau == IntegerBitSize ? ~Integer(0) : (Integer(1) << tau) - 1;
+	for (auto _ : state)
+	{
+		for (Integer i : indices)a.set(i, i & mask);
+		benchmark::ClobberMemory();
+	}
+	reportRates(state, BENCHMARK_ELEMENTS, BENCHMARK_ELEMENTS * tau / 8);
+}
+BENCHMARK(BM_ArraySetRandom)->Arg(1)->Arg(7)->Arg(13)->Arg(16)->Arg(31)->Arg(32)->Arg(47)->Arg(64);
+
+static void BM_ArrayGetRange(benchmark::State& state)
+{
+	Integer tau = Integer(state.range(0));
+	ds::Array a(BENCHMARK_ELEMENTS, tau);
+	std::vector<uint64_t> out(BENCHMARK_ELEMENTS);
+	for (auto _ : state)
+	{
+		a.getRange(0, BENCHMARK_ELEMENTS, out.data());
+		benchmark::DoNotOptimize(out.data());
+	}
+	reportRates(state, BENCHMARK_ELEMENTS, BENCHMARK_ELEMENTS * tau / 8);
+}
+BENCHMARK(BM_ArrayGetRange)->Arg(1)->Arg(7)->Arg(13)->Arg(16)->Arg(31)->Arg(32)->Arg(47)->Arg(64);
+
+/*
+	DynamicArray::push_back of values, which grow up to state.range(0) bits, so tau is widened on the way. The result of
+	push_back, set and changeTau is compared with the input once before the measurement.
+*/
+static std::vector<Integer> growingValues(Integer tau)
+{
+	std::mt19937_64 random(42);
+	std::vector<Integer> values(BENCHMARK_ELEMENTS);
+	for (Integer i = 0; i < BENCHMARK_ELEMENTS; i++)
+	{
+		Integer bits = 1 + i * tau / BENCHMARK_ELEMENTS;
+		values[i] = Integer(random()) & (bits == IntegerBitSize ? ~Integer(0) : (Integer(1) << bits) - 1);
+	}
+	return values;
+}
+
+static const char* dynamicArrayMismatch(const std::vector<Integer>& values)
+{
+	ds::DynamicArray a;
+	for (Integer value : values)a.push_back(value);
+	for (Integer i = 0; i < a.length(); i++)
+	{
+		if (a.get(i) != values[i])return "DynamicArray::push_back does not restore the input";
+	}
+	for (Integer i = 0; i < a.length(); i += 3)a.set(i, values[a.length() - 1 - i]);
+	std::vector<uint64_t> out(a.length());
+	a.getRange(0, a.length(), out.data());
+	for (Integer i = 0; i < a.length(); i++)
+	{
+		if (out[i] != (i % 3 == 0 ? values[a.length() - 1 - i] : values[i]))return "DynamicArray::set does not restore the input";
+	}
+	Integer tau = a.tau();
+	a.changeTau(IntegerBitSize);
+	a.changeTau(tau);
+	for (Integer i = 0; i < a.length(); i++)
+	{
+		if (a.get(i) != out[i])return "DynamicArray::changeTau does not restore the input";
+	}
+	return nullptr;
+}
+
+static void BM_DynamicArrayPushBack(benchmark::State& state)
+{
+	std::vector<Integer> values = growingValues(Integer(state.range(0)));
+	const char* mismatch = dynamicArrayMismatch(values);
+	if (mismatch)
+	{
+		state.SkipWithError(mismatch);
+		return;
+	}
+	for (auto _ : state)
+	{
+		ds::DynamicArray a;
+		for (Integer value : values)a.push_back(value);
+		benchmark::DoNotOptimize(a.length());
+		state.counters["tau"] = double(a.tau());
+	}
+	reportRates(state, BENCHMARK_ELEMENTS, 0);
+}
+BENCHMARK(BM_DynamicArrayPushBack)->Arg(7)->Arg(20)->Arg(64);
@@ -0,0 +1,313 @@
+#include <memory>
+#include "common.h"
+#include "genericBinaryTree.h"
+#include "binaryTree.h"
+
+/*
+	BinaryTree insert of random keys and range queries over 1/1000 of the key space.
+*/
+#define BINARYTREE_BENCHMARK_ELEMENTS (Integer(1) << 16)
+
+class Border : public ds::RangeBorder<Integer>
+{
+private:
+	Integer m_value;
+public:
+	Border(Integer value) : m_value(value) {}
+	bool greaterThen(const Integer e) { return e > m_value; }
+	bool equals(const Integer e) { return e == m_value; }
+};
+
+static void BM_BinaryTreeInsert(benchmark::State& state)
+{
+	std::vector<Integer> keys = randomIndices(BINARYTREE_BENCHMARK_ELEMENTS, ~Integer(0));
+	for (auto _ : state)
+	{
+		ds::BinaryTree<Integer> tree;
+		for (Integer key : keys)tree.insert(key);
+		benchmark::ClobberMemory();
+	}
+	reportRates(state, BINARYTREE_BENCHMARK_ELEMENTS, BINARYTREE_BENCHMARK_ELEMENTS * sizeof(Integer));
+}
+BENCHMARK(BM_BinaryTreeInsert);
+
+static void BM_BinaryTreeRangeQuery(benchmark::State& state)
+{
+	std::vector<Integer> keys = randomIndices(BINARYTREE_BENCHMARK_ELEMENTS, BINARYTREE_BENCHMARK_ELEMENTS * 1000);
+	ds::BinaryTree<Integer> tree;
+	for (Integer key : keys)tree.insert(key);
+	std::vector<Integer> starts = randomIndices(1024, BINARYTREE_BENCHMARK_ELEMENTS * 999);
+	Integer width = BINARYTREE_BENCHMARK_ELEMENTS;
+	for (auto _ : state)
+	{
+		Integer found = 0;
+		for (Integer start : starts)
+		{
+			std::shared_ptr<ds::RangeBorder<Integer>> min = std::make_shared<Border>(start);
+			std::shared_ptr<ds::RangeBorder<Integer>> max = std::make_shared<Border>(start + width);
+			found += tree.rangeQuery(min, max).size();
+		}
+		benchmark::DoNotOptimize(found);
+	}
+	reportRates(state, starts.size(), 0);
+}
+BENCHMARK(BM_BinaryTreeRangeQuery);
+
+/*
+	The same queries through the allocation free API: argument 0 visitRange with a lambda, argument 1 rangeQuery into a caller buffer.
+*/
+static void BM_BinaryTreeVisitRange(benchmark::State& state)
+{
+	std::vector<Integer> keys = randomIndices(BINARYTREE_BENCHMARK_ELEMENTS, BINARYTREE_BENCHMARK_ELEMENTS * 1000);
+	ds::BinaryTree<Integer> tree;
+	for (Integer key : keys)tree.insert(key);
+	std::vector<Integer> starts = randomIndices(1024, BINARYTREE_BENCHMARK_ELEMENTS * 999);
+	std::vector<Integer> buffer(BINARYTREE_BENCHMARK_ELEMENTS);
+	Integer width = BINARYTREE_BENCHMARK_ELEMENTS;
+	for (auto _ : state)
+	{
+		Integer found = 0;
+		for (Integer start : starts)
+		{
+			if (state.range(0))
+			{
+				found += tree.rangeQuery(start, start + width, buffer.data(), buffer.size());
+			}
+			else
+			{
+				tree.visitRange(start, start + width, [&](const Integer& e) { found += e; });
+			}
+		}
+		benchmark::DoNotOptimize(found);
+	}
+	reportRates(state, starts.size(), 0);
+}
+BENCHMARK(BM_BinaryTreeVisitRange)->Arg(0)->Arg(1);
+
+/*
+	BinaryTree::contains on the node tree (argument 0) and on the frozen Eytzinger layout (argument 1).
+*/
+static void BM_BinaryTreeContains(benchmark::State& state)
+{
+	std::vector<Integer> keys = randomIndices(BINARYTREE_BENCHMARK_ELEMENTS, BINARYTREE_BENCHMARK_ELEMENTS * 2);
+	ds::BinaryTree<Integer> tree;
+	for (Integer key : keys)tree.insert(key);
+	if (state.range(0))tree.freeze();
+	std::vector<Integer> lookups = randomIndices(BINARYTREE_BENCHMARK_ELEMENTS, BINARYTREE_BENCHMARK_ELEMENTS * 2, 7);
+	for (auto _ : state)
+	{
+		Integer found = 0;
+		for (Integer key : lookups)found += tree.contains(key);
+		benchmark::DoNotOptimize(found);
+	}
+	reportRates(state, BINARYTREE_BENCHMARK_ELEMENTS, 0);
+}
+BENCHMARK(BM_BinaryTreeContains)->Arg(0)->Arg(1);
+
+/*
+	Insert orders: 0 random, 1 sorted, 2 reverse sorted, 3 zigzag (alternating from both ends).
+	Sorted input degrades BinaryTree into a list, so it is measured with BINARYTREE_ORDER_ELEMENTS only.
+*/
+#define BINARYTREE_ORDER_ELEMENTS (Integer(1) << 12)
+
+static std::vector<Integer> keysInOrder(Integer order, Integer n)
+{
+	std::vector<Integer> keys(n);
+	if (order == 0)return randomIndices(n, ~Integer(0));
+	for (Integer i = 0; i < n; i++)
+	{
+		if (order == 1)keys[i] = i;
+		else if (order == 2)keys[i] = n - i;
+		else keys[i] = i % 2 == 0 ? i / 2 : n - i / 2;
+	}
+	return keys;
+}
+
+static void BM_BinaryTreeInsertOrder(benchmark::State& state)
+{
+	std::vector<Integer> keys = keysInOrder(Integer(state.range(0)), BINARYTREE_ORDER_ELEMENTS);
+	for (auto _ : state)
+	{
+		ds::BinaryTree<Integer> tree;
+		for (Integer key : keys)tree.insert(key);
+		benchmark::ClobberMemory();
+	}
+	reportRates(state, BINARYTREE_ORDER_ELEMENTS, 0);
+}
+BENCHMARK(BM_BinaryTreeInsertOrder)->DenseRange(0, 3, 1);
+
+static void BM_AVLTreeInsertOrder(benchmark::State& state)
+{
+	Integer n = Integer(state.range(1));
+	std::vector<Integer> keys = keysInOrder(Integer(state.range(0)), n);
+	for (auto _ : state)
+	{
+		ds::AVLTree<Integer> tree;
+		for (Integer key : keys)tree.insert(key);
+		benchmark::DoNotOptimize(tree.height());
+	}
+	reportRates(state, n, 0);
+}
+BENCHMARK(BM_AVLTreeInsertOrder)->ArgsProduct({ { 0, 1, 2, 3 }, { int64_t(BINARYTREE_ORDER_ELEMENTS), int64_t(1) << 20 } });
+
+static void BM_AVLTreeContains(benchmark::State& state)
+{
+	std::vector<Integer> keys = keysInOrder(1, BINARYTREE_BENCHMARK_ELEMENTS);
+	ds::AVLTree<Integer> tree;
+	for (Integer key : keys)tree.insert(key);
+	std::vector<Integer> lookups = randomIndices(BINARYTREE_BENCHMARK_ELEMENTS, BINARYTREE_BENCHMARK_ELEMENTS * 2, 7);
+	for (auto _ : state)
+	{
+		Integer found = 0;
+		for (Integer key : lookups)found += tree.contains(key);
+		benchmark::DoNotOptimize(found);
+	}
+	reportRates(state, BINARYTREE_BENCHMARK_ELEMENTS, 0);
+}
+BENCHMARK(BM_AVLTreeContains);
+
+/*
+	Building and destroying a tree with nodes from the heap and from a NodeArena, which releases all nodes at once.
+*/
+template<typename T>
+static void BM_TreeBuildAndRelease(benchmark::State& state)
+{
+	std::vector<Integer> keys = randomIndices(BINARYTREE_BENCHMARK_ELEMENTS, ~Integer(0));
+	for (auto _ : state)
+	{
+		T tree;
+		for (Integer key : keys)tree.insert(key);
+		benchmark::ClobberMemory();
+	}
+	reportRates(state, BINARYTREE_BENCHMARK_ELEMENTS, 0);
+}
+BENCHMARK_TEMPLATE(BM_TreeBuildAndRelease, ds::BinaryTree<Integer>);
+BENCHMARK_TEMPLATE(BM_TreeBuildAndRelease, ds::BinaryTree<Integer, ds::DefaultNodeComperator<Integer>, ds::NodeArena>);
+BENCHMARK_TEMPLATE(BM_TreeBuildAndRelease, ds::AVLTree<Integer>);
+BENCHMARK_TEMPLATE(BM_TreeBuildAndRelease, ds::AVLTree<Integer, ds::DefaultNodeComperator<Integer>, ds::NodeArena>);
+
+/*
+	Inserting random keys into an AVLTree and removing every second one again. The balance factors live in the low bits of the
+	left child pointer, so the result is checked once before the measurement, with nodes from the heap and from a NodeArena.
+*/
+template<typename T>
+static const char* avlTreeMismatch(const std::vector<Integer>& keys)
+{
+	T tree;
+	for (Integer key : keys)tree.insert(key);
+	for (Integer i = 0; i < keys.size(); i += 2)
+	{
+		if (!tree.remove(keys[i]))return "AVLTree::remove does not find an inserted key";
+	}
+	if (tree.size() != keys.size() / 2)return "AVLTree::size differs after remove";
+	for (Integer i = 0; i < keys.size(); i++)
+	{
+		if (tree.contains(keys[i]) != (i % 2 == 1))return "AVLTree::contains differs after remove";
+	}
+	//an AVL tree with n nodes is lower than 1.45 * log2(n + 2)
+	Integer bound = 2;
+	while ((Integer(1) << (bound * 2 / 3)) < keys.size())bound++;
+	if (tree.height() > bound)return "AVLTree is not balanced after remove";
+	return nullptr;
+}
+
+template<typename T>
+static void BM_AVLTreeInsertRemove(benchmark::State& state)
+{
+	std::vector<Integer> keys = keysInOrder(0, BINARYTREE_BENCHMARK_ELEMENTS);
+	const char* mismatch = avlTreeMismatch<T>(keys);
+	if (mismatch)
+	{
+		state.SkipWithError(mismatch);
+		return;
+	}
+	for (auto _ : state)
+	{
+		T tree;
+		for (Integer key : keys)tree.insert(key);
+		for (Integer i = 0; i < keys.size(); i += 2)tree.remove(keys[i]);
+		benchmark::DoNotOptimize(tree.height());
+	}
+	reportRates(state, BINARYTREE_BENCHMARK_ELEMENTS + BINARYTREE_BENCHMARK_ELEMENTS / 2, 0);
+}
+BENCHMARK_TEMPLATE(BM_AVLTreeInsertRemove, ds::AVLTree<Integer>);
+BENCHMARK_TEMPLATE(BM_AVLTreeInsertRemove, ds::AVLTree<Integer, ds::DefaultNodeComperator<Integer>, ds::NodeArena>);
+
+/*
+	Bulk loading random keys with a pool of state.range(0) threads against inserting them one by one (argument 0).
+*/
+static void BM_BinaryTreeBulkLoad(benchmark::State& state)
+{
+	std::vector<Integer> keys = randomIndices(Integer(1) << 20, ~Integer(0));
+	Integer threads = Integer(state.range(0));
+	ds::ThreadPool pool(threads == 0 ? 1 : threads);
+	for (auto _ : state)
+	{
+		ds::BinaryTree<Integer, ds::DefaultNodeComperator<Integer>, ds::NodeArena> tree;
+		if (threads == 0)
+		{
+			for (Integer key : keys)tree.insert(key);
+		}
+		else
+		{
+			tree.bulkLoad(keys.begin(), keys.end(), pool);
+		}
+		benchmark::ClobberMemory();
+	}
+	reportRates(state, keys.size(), 0);
+}
+BENCHMARK(BM_BinaryTreeBulkLoad)->Arg(0)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+
+/*
+	Wide range queries (about 1/8 of the tree each) with a pool of state.range(0) threads.
+*/
+static void BM_BinaryTreeParallelRangeQuery(benchmark::State& state)
+{
+	std::vector<Integer> keys = randomIndices(Integer(1) << 20, Integer(1) << 40);
+	ds::ThreadPool pool(Integer(state.range(0)));
+	ds::BinaryTree<Integer> tree;
+	tree.bulkLoad(keys.begin(), keys.end(), pool);
+	std::vector<Integer> starts = randomIndices(16, (Integer(1) << 40) - (Integer(1) << 37));
+	for (auto _ : state)
+	{
+		Integer found = 0;
+		for (Integer start : starts)found += tree.parallelRangeQuery(start, start + (Integer(1) << 37), pool).size();
+		benchmark::DoNotOptimize(found);
+	}
+	reportRates(state, starts.size(), 0);
+}
+BENCHMARK(BM_BinaryTreeParallelRangeQuery)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+
+/*
+	BalancedBinaryTree: the pointer free tree in 20 bit slots, inserts in the orders of keysInOrder and lookups.
+*/
+static void BM_BalancedBinaryTreeInsertOrder(benchmark::State& state)
+{
+	std::vector<Integer> keys = keysInOrder(Integer(state.range(0)), BINARYTREE_BENCHMARK_ELEMENTS);
+	for (Integer& key : keys)key %= Integer(1) << 20;
+	for (auto _ : state)
+	{
+		ds::BalancedBinaryTree tree(0, 20);
+		for (Integer key : keys)tree.insert(key);
+		benchmark::DoNotOptimize(tree.count());
+	}
+	reportRates(state, BINARYTREE_BENCHMARK_ELEMENTS, 0);
+}
+BENCHMARK(BM_BalancedBinaryTreeInsertOrder)->DenseRange(0, 3, 1);
+
+static void BM_BalancedBinaryTreeContains(benchmark::State& state)
+{
+	std::vector<Integer> keys = randomIndices(BINARYTREE_BENCHMARK_ELEMENTS, BINARYTREE_BENCHMARK_ELEMENTS * 2);
+	ds::BalancedBinaryTree tree(0, 20);
+	for (Integer key : keys)tree.insert(key);
+	std::vector<Integer> lookups = randomIndices(BINARYTREE_BENCHMARK_ELEMENTS, BINARYTREE_BENCHMARK_ELEMENTS * 2, 7);
+	for (auto _ : state)
+	{
+		Integer found = 0;
+		for (Integer key : lookups)found += tree.contains(key);
+		benchmark::DoNotOptimize(found);
+	}
+	reportRates(state, BINARYTREE_BENCHMARK_ELEMENTS, 0);
+	state.counters["bytes"] = double(tree.byteSize());
+}
+BENCHMARK(BM_BalancedBinaryTreeContains);
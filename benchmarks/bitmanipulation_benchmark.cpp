@@ -0,0 +1,83 @@
+#include <string>
+#include "common.h"
+
+/*
+	Sequential reads and writes of tau bit blocks with the 64 bit kernels (tau as runtime argument)
+	and with getBlockEnv/setBlockEnv (tau as template argument) for every tau.
+*/
+
+static void BM_getBlock64(benchmark::State& state)
+{
+	uint8_t tau = uint8_t(state.range(0));
+	std::vector<uint64_t> content(BENCHMARK_ELEMENTS * tau / 64 + 1, 0x5555555555555555ULL);
+	for (auto _ : state)
+	{
+		uint64_t sum = 0;
+		for (uint64_t i = 0; i < BENCHMARK_ELEMENTS; i++)sum += ds::getBlock64(i * tau, tau, content.data());
+		benchmark::DoNotOptimize(sum);
+	}
+	reportRates(state, BENCHMARK_ELEMENTS, BENCHMARK_ELEMENTS * tau / 8);
+}
+BENCHMARK(BM_getBlock64)->DenseRange(1, 64, 1);
+
+static void BM_setBlock64(benchmark::State& state)
+{
+	uint64_t tau = uint64_t(state.range(0));
+	std::vector<uint64_t> content(BENCHMARK_ELEMENTS * tau / 64 + 1, 0);
+	uint64_t mask = tau == 64 ? ~uint64_t(0) : (uint64_t(1) << tau) - 1;
+	for (auto _ : state)
+	{
+		for (uint64_t i = 0; i < BENCHMARK_ELEMENTS; i++)ds::setBlock64(i * tau, tau, i & mask, content.data());
+		benchmark::ClobberMemory();
+	}
+	reportRates(state, BENCHMARK_ELEMENTS, BENCHMARK_ELEMENTS * tau / 8);
+}
+BENCHMARK(BM_setBlock64)->DenseRange(1, 64, 1);
+
+template<Integer t_tau>
+static void BM_getBlockEnv(benchmark::State& state)
+{
+	std::vector<Integer> content(BENCHMARK_ELEMENTS * t_tau / IntegerBitSize + 1, Integer(0x5555555555555555ULL));
+	for (auto _ : state)
+	{
+		Integer sum = 0;
+		for (Integer i = 0; i < BENCHMARK_ELEMENTS; i++)sum += ds::getBlockEnv<t_tau>(i * t_tau, content.data());
+		benchmark::DoNotOptimize(sum);
+	}
+	reportRates(state, BENCHMARK_ELEMENTS, BENCHMARK_ELEMENTS * t_tau / 8);
+}
+
+template<Integer t_tau>
+static void BM_setBlockEnv(benchmark::State& state)
+{
+	std::vector<Integer> content(BENCHMARK_ELEMENTS * t_tau / IntegerBitSize + 1, 0);
+	Integer mask = t_tau == IntegerBitSize ? ~Integer(0) : (Integer(1) << t_tau) - 1;
+	for (auto _ : state)
+	{
+		for (Integer i = 0; i < BENCHMARK_ELEMENTS; i++)ds::setBlockEnv<t_tau>(i * t_tau, i & mask, content.data());
+		benchmark::ClobberMemory();
+	}
+	reportRates(state, BENCHMARK_ELEMENTS, BENCHMARK_ELEMENTS * t_tau / 8);
+}
+
+/*
+	Registers the template benchmarks for tau = t_tau, ... , 1.
+*/
+template<Integer t_tau>
+struct RegisterBlockEnv
+{
+	static void run()
+	{
+		RegisterBlockEnv<t_tau - 1>::run();
+		benchmark::RegisterBenchmark(("BM_getBlockEnv/" + std::to_string(t_tau)).c_str(), BM_getBlockEnv<t_tau>);
+		benchmark::RegisterBenchmark(("BM_setBlockEnv/" + std::to_string(t_tau)).c_str(), BM_setBlockEnv<t_tau>);
+	}
+};
+
+template<>
+struct RegisterBlockEnv<0>
+{
+	static void run() {}
+};
+
+static int s_registerBlockEnv = (RegisterBlockEnv<IntegerBitSize>::run(), 0);
@@ -0,0 +1,81 @@
+#include "common.h"
+#include "bitstring.h"
+
+/*
+	Bitstring: bit access, rank and select on a bitstring with every third bit set.
+*/
+
+static ds::Bitstring makeBitstring()
+{
+	ds::Bitstring bits(uint32_t(BENCHMARK_ELEMENTS));
+	for (uint32_t i = 0; i < BENCHMARK_ELEMENTS; i += 3)bits.setBit(i);
+	bits.freeze();
+	return bits;
+}
+
+static void BM_BitstringIsBitSet(benchmark::State& state)
+{
+	ds::Bitstring bits = makeBitstring();
+	std::vector<Integer> indices = randomIndices(BENCHMARK_ELEMENTS, BENCHMARK_ELEMENTS);
+	for (auto _ : state)
+	{
+		uint32_t count = 0;
+		for (Integer i : indices)count += bits.isBitSet(uint32_t(i));
+		benchmark::DoNotOptimize(count);
+	}
+	reportRates(state, BENCHMARK_ELEMENTS, BENCHMARK_ELEMENTS / 8);
+}
+BENCHMARK(BM_BitstringIsBitSet);
+
+static void BM_BitstringSetBit(benchmark::State& state)
+{
+	ds::Bitstring bits(uint32_t(BENCHMARK_ELEMENTS));
+	std::vector<Integer> indices = randomIndices(BENCHMARK_ELEMENTS, BENCHMARK_ELEMENTS);
+	for (auto _ : state)
+	{
+		for (Integer i : indices)bits.setBit(uint32_t(i));
+		benchmark::ClobberMemory();
+	}
+	reportRates(state, BENCHMARK_ELEMENTS, BENCHMARK_ELEMENTS / 8);
+}
+BENCHMARK(BM_BitstringSetBit);
+
+static void BM_BitstringFreeze(benchmark::State& state)
+{
+	ds::Bitstring bits = makeBitstring();
+	for (auto _ : state)
+	{
+		bits.freeze();
+		benchmark::ClobberMemory();
+	}
+	reportRates(state, 1, BENCHMARK_ELEMENTS / 8);
+}
+BENCHMARK(BM_BitstringFreeze);
+
+static void BM_BitstringRank1(benchmark::State& state)
+{
+	ds::Bitstring bits = makeBitstring();
+	std::vector<Integer> indices = randomIndices(BENCHMARK_ELEMENTS, BENCHMARK_ELEMENTS);
+	for (auto _ : state)
+	{
+		uint64_t sum = 0;
+		for (Integer i : indices)sum += bits.rank1(uint32_t(i));
+		benchmark::DoNotOptimize(sum);
+	}
+	reportRates(state, BENCHMARK_ELEMENTS, 0);
+}
+BENCHMARK(BM_BitstringRank1);
+
+static void BM_BitstringSelect1(benchmark::State& state)
+{
+	ds::Bitstring bits = makeBitstring();
+	std::vector<Integer> indices = randomIndices(BENCHMARK_ELEMENTS, bits.numberOfOnes());
+	for (auto _ : state)
+	{
+		uint64_t sum = 0;
+		for (Integer i : indices)sum += bits.select1(uint32_t(i));
+		benchmark::DoNotOptimize(sum);
+	}
+	reportRates(state, BENCHMARK_ELEMENTS, 0);
+}
+BENCHMARK(BM_BitstringSelect1);
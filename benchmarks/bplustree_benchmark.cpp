@@ -0,0 +1,114 @@
+#include <memory>
+#include <algorithm>
+#include "common.h"
+#include "bplustree.h"
+
+/*
+	BPlusTree with 32 bit keys, the same key sets and range widths as binarytree_benchmark.cpp so the numbers can be compared.
+*/
+#define BPLUSTREE_BENCHMARK_ELEMENTS (Integer(1) << 16)
+
+class BPlusTreeBorder : public ds::RangeBorder<Integer>
+{
+private:
+	Integer m_value;
+public:
+	BPlusTreeBorder(Integer value) : m_value(value) {}
+	bool greaterThen(const Integer e) { return e > m_value; }
+	bool equals(const Integer e) { return e == m_value; }
+};
+
+static void BM_BPlusTreeInsert(benchmark::State& state)
+{
+	std::vector<Integer> keys = randomIndices(BPLUSTREE_BENCHMARK_ELEMENTS, Integer(1) << 32);
+	for (auto _ : state)
+	{
+		ds::BPlusTree<32> tree;
+		for (Integer key : keys)tree.insert(key);
+		benchmark::DoNotOptimize(tree.size());
+	}
+	reportRates(state, BPLUSTREE_BENCHMARK_ELEMENTS, 0);
+}
+BENCHMARK(BM_BPlusTreeInsert);
+
+/*
+	Argument 0: bounds as RangeBorder (binary search in the inner nodes), argument 1: integer bounds (SIMD search).
+*/
+static void BM_BPlusTreeRangeQuery(benchmark::State& state)
+{
+	std::vector<Integer> keys = randomIndices(BPLUSTREE_BENCHMARK_ELEMENTS, BPLUSTREE_BENCHMARK_ELEMENTS * 1000);
+	ds::BPlusTree<32> tree;
+	for (Integer key : keys)tree.insert(key);
+	std::vector<Integer> starts = randomIndices(1024, BPLUSTREE_BENCHMARK_ELEMENTS * 999);
+	Integer width = BPLUSTREE_BENCHMARK_ELEMENTS;
+	for (auto _ : state)
+	{
+		Integer found = 0;
+		for (Integer start : starts)
+		{
+			if (state.range(0))
+			{
+				found += tree.rangeQuery(start, start + width).size();
+			}
+			else
+			{
+				std::shared_ptr<ds::RangeBorder<Integer>> min = std::make_shared<BPlusTreeBorder>(start);
+				std::shared_ptr<ds::RangeBorder<Integer>> max = std::make_shared<BPlusTreeBorder>(start + width);
+				found += tree.rangeQuery(min, max).size();
+			}
+		}
+		benchmark::DoNotOptimize(found);
+	}
+	reportRates(state, starts.size(), 0);
+}
+BENCHMARK(BM_BPlusTreeRangeQuery)->Arg(0)->Arg(1);
+
+static void BM_BPlusTreeContains(benchmark::State& state)
+{
+	std::vector<Integer> keys = randomIndices(BPLUSTREE_BENCHMARK_ELEMENTS, BPLUSTREE_BENCHMARK_ELEMENTS * 2);
+	ds::BPlusTree<32> tree;
+	for (Integer key : keys)tree.insert(key);
+	std::vector<Integer> lookups = randomIndices(BPLUSTREE_BENCHMARK_ELEMENTS, BPLUSTREE_BENCHMARK_ELEMENTS * 2, 7);
+	std::sort(keys.begin(), keys.end());
+	for (Integer key : lookups)
+	{
+		if (tree.contains(key) != std::binary_search(keys.begin(), keys.end(), key))
+		{
+			state.SkipWithError("BPlusTree::contains differs from std::binary_search");
+			return;
+		}
+	}
+	for (auto _ : state)
+	{
+		Integer found = 0;
+		for (Integer key : lookups)found += tree.contains(key);
+		benchmark::DoNotOptimize(found);
+	}
+	reportRates(state, BPLUSTREE_BENCHMARK_ELEMENTS, 0);
+}
+BENCHMARK(BM_BPlusTreeContains);
+
+/*
+	Full scan over the linked leaves, reported per key.
+*/
+class BPlusTreeSum : public ds::ChangeStrategie<Integer>
+{
+public:
+	Integer m_sum = 0;
+	void change(Integer e) { m_sum += e; }
+};
+
+static void BM_BPlusTreeScan(benchmark::State& state)
+{
+	std::vector<Integer> keys = randomIndices(BENCHMARK_ELEMENTS, Integer(1) << 32);
+	ds::BPlusTree<32> tree;
+	for (Integer key : keys)tree.insert(key);
+	std::shared_ptr<BPlusTreeSum> sum = std::make_shared<BPlusTreeSum>();
+	for (auto _ : state)
+	{
+		tree.foreach(sum);
+		benchmark::DoNotOptimize(sum->m_sum);
+	}
+	reportRates(state, BENCHMARK_ELEMENTS, tree.byteSize());
+}
+BENCHMARK(BM_BPlusTreeScan);
@@ -0,0 +1,38 @@
+#ifndef __BENCHMARKS_COMMON_H__
+
+#define __BENCHMARKS_COMMON_H__
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <random>
+#include "bitmanipulation.h"
+
+/*
+	Number of elements of the containers, large enough to leave the L2 cache for tau >= 8.
+*/
+#define BENCHMARK_ELEMENTS (Integer(1) << 20)
+
+/*
+	Random indices in [0, n), drawn in advance so the generator is not measured.
+*/
+static std::vector<Integer> randomIndices(Integer count, Integer n, uint64_t seed = 42)
+{
+	std::mt19937_64 random(seed);
+	std::vector<Integer> indices(count);
+	for (Integer i = 0; i < count; i++)indices[i] = Integer(random() % n);
+	return indices;
+}
+
+/*
+	Reports the operations per second, the operations per iteration and, if bytesPerIteration > 0, the throughput of the touched payload.
+	"ops" is a plain per-iteration value, the time per operation is the Time column divided by "ops".
+*/
+static void reportRates(benchmark::State& state, Integer operationsPerIteration, Integer bytesPerIteration)
+{
+	Integer operations = Integer(state.iterations()) * operationsPerIteration;
+	state.SetItemsProcessed(int64_t(operations));
+	if (bytesPerIteration > 0)state.SetBytesProcessed(int64_t(Integer(state.iterations()) * bytesPerIteration));
+	state.counters["ops"] = benchmark::Counter(double(operationsPerIteration), benchmark::Counter::kAvgThreads);
+}
+
+#endif // !__BENCHMARKS_COMMON_H__
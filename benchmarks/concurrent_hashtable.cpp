@@ -0,0 +1,58 @@
+/*
+	Read scaling of ConcurrentHashtable: every thread looks up random keys of a table, which was filled in advance.
+	Prints the lookups per second for 1, 2, 4, ... , 32 threads and the speedup against one thread.
+*/
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cstdio>
+#include "hashtable.h"
+
+#define TABLE_SIZE (Integer(1) << 22)
+#define NUMBER_OF_KEYS (TABLE_SIZE / 2)
+#define LOOKUPS_PER_THREAD (Integer(1) << 24)
+#define MAX_THREADS 32
+
+typedef ds::ConcurrentHashtable<Integer, TABLE_SIZE> Table;
+
+static Integer lookup(const Table& table, Integer seed)
+{
+	std::mt19937_64 random(seed);
+	Integer found = 0;
+	for (Integer i = 0; i < LOOKUPS_PER_THREAD; i++)
+	{
+		Integer key = random() % NUMBER_OF_KEYS + 1;
+		const Integer* value = table.find(key);
+		if (value)found += *value;
+	}
+	return found;
+}
+
+int main()
+{
+	//too large for the stack
+	Table* table = new Table();
+	std::vector<Integer> values(NUMBER_OF_KEYS + 1);
+	for (Integer key = 1; key <= NUMBER_OF_KEYS; key++)
+	{
+		values[key] = key;
+		table->insert(key, &values[key]);
+	}
+
+	double single = 0;
+	for (Integer threads = 1; threads <= MAX_THREADS; threads *= 2)
+	{
+		std::vector<std::thread> workers;
+		std::vector<Integer> results(threads);
+		auto start = std::chrono::steady_clock::now();
+		for (Integer t = 0; t < threads; t++)workers.emplace_back([&, t]() { results[t] = lookup(*table, t + 1); });
+		for (std::thread& worker : workers)worker.join();
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		double rate = double(threads * LOOKUPS_PER_THREAD) / seconds;
+		if (threads == 1)single = rate;
+		printf("threads %2llu: %8.2f Mlookups/s, speedup %5.2f\n", (unsigned long long)threads, rate / 1e6, rate / single);
+	}
+	delete table;
+	return 0;
+}
@@ -0,0 +1,150 @@
+#include <algorithm>
+#include "common.h"
+#include "graph.h"
+#include "graphtraversal.h"
+
+/*
+	CompressedGraph: a random graph with GRAPH_BENCHMARK_NODES nodes and GRAPH_BENCHMARK_DEGREE edges per node, 16 bit weights.
+*/
+#define GRAPH_BENCHMARK_NODES (uint32_t(1) << 20)
+#define GRAPH_BENCHMARK_DEGREE 16
+
+static std::vector<ds::CompressedGraph::Edge> randomEdges()
+{
+	std::mt19937_64 random(42);
+	std::vector<ds::CompressedGraph::Edge> edges(Integer(GRAPH_BENCHMARK_NODES) * GRAPH_BENCHMARK_DEGREE);
+	for (ds::CompressedGraph::Edge& edge : edges)
+	{
+		edge.m_from = uint32_t(random() % GRAPH_BENCHMARK_NODES);
+		edge.m_to = uint32_t(random() % GRAPH_BENCHMARK_NODES);
+		edge.m_weight = int32_t(random() % 65536);
+	}
+	return edges;
+}
+
+static void BM_CompressedGraphBuild(benchmark::State& state)
+{
+	std::vector<ds::CompressedGraph::Edge> edges = randomEdges();
+	for (auto _ : state)
+	{
+		ds::CompressedGraph graph(GRAPH_BENCHMARK_NODES, edges, 16);
+		benchmark::DoNotOptimize(graph.numberOfEdges());
+		state.counters["bytes"] = double(graph.byteSize());
+	}
+	reportRates(state, edges.size(), 0);
+}
+BENCHMARK(BM_CompressedGraphBuild)->Unit(benchmark::kMillisecond);
+
+/*
+	hasEdge for random node pairs and for the edges themselves, both are compared with the sorted edge list first.
+*/
+static void BM_CompressedGraphHasEdge(benchmark::State& state)
+{
+	std::vector<ds::CompressedGraph::Edge> edges = randomEdges();
+	ds::CompressedGraph graph(GRAPH_BENCHMARK_NODES, edges, 16);
+	std::vector<Integer> nodes = randomIndices(2 * BENCHMARK_ELEMENTS, GRAPH_BENCHMARK_NODES);
+	std::vector<uint64_t> pairs(edges.size());
+	for (Integer e = 0; e < edges.size(); e++)pairs[e] = (uint64_t(edges[e].m_from) << 32) | edges[e].m_to;
+	std::sort(pairs.begin(), pairs.end());
+	for (Integer k = 0; k < 2 * 4096; k += 2)
+	{
+		uint64_t pair = (uint64_t(nodes[k]) << 32) | nodes[k + 1];
+		if (graph.hasEdge(uint32_t(nodes[k]), uint32_t(nodes[k + 1])) != std::binary_search(pairs.begin(), pairs.end(), pair)
+			|| !graph.hasEdge(uint32_t(pairs[k] >> 32), uint32_t(pairs[k])))
+		{
+			state.SkipWithError("CompressedGraph::hasEdge differs from the edge list");
+			return;
+		}
+	}
+	for (auto _ : state)
+	{
+		Integer found = 0;
+		for (Integer k = 0; k < nodes.size(); k += 2)found += graph.hasEdge(uint32_t(nodes[k]), uint32_t(nodes[k + 1]));
+		benchmark::DoNotOptimize(found);
+	}
+	reportRates(state, BENCHMARK_ELEMENTS, 0);
+}
+BENCHMARK(BM_CompressedGraphHasEdge);
+
+/*
+	Summing all weights row by row, once with edgeWeight per edge and once with the bulk decoding of targets/weights.
+*/
+static void BM_CompressedGraphScan(benchmark::State& state)
+{
+	ds::CompressedGraph graph(GRAPH_BENCHMARK_NODES, randomEdges(), 16);
+	std::vector<int64_t> buffer(256);
+	for (auto _ : state)
+	{
+		int64_t sum = 0;
+		if (state.range(0) == 0)
+		{
+			for (Integer e = 0; e < graph.numberOfEdges(); e++)sum += graph.edgeWeight(e);
+		}
+		else
+		{
+			for (Integer e = 0; e < graph.numberOfEdges(); e += 256)
+			{
+				Integer chunk = graph.numberOfEdges() - e < 256 ? graph.numberOfEdges() - e : 256;
+				graph.weights(e, chunk, buffer.data());
+				for (Integer k = 0; k < chunk; k++)sum += buffer[k];
+			}
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	reportRates(state, graph.numberOfEdges(), 0);
+}
+BENCHMARK(BM_CompressedGraphScan)->Arg(0)->Arg(1);
+
+/*
+	GraphTraversal on the random graph with a pool of state.range(0) threads: the symmetric graph (both directions of
+	every edge) for bfs and connectedComponents, the directed one with 16 bit weights for shortestPaths.
+*/
+static std::vector<ds::CompressedGraph::Edge> symmetricEdges()
+{
+	std::vector<ds::CompressedGraph::Edge> edges = randomEdges();
+	Integer count = edges.size();
+	for (Integer k = 0; k < count; k++)edges.push_back({ edges[k].m_to, edges[k].m_from, edges[k].m_weight });
+	return edges;
+}
+
+static void BM_GraphTraversalBfs(benchmark::State& state)
+{
+	ds::CompressedGraph graph(GRAPH_BENCHMARK_NODES, symmetricEdges());
+	ds::ThreadPool pool(Integer(state.range(0)));
+	ds::GraphTraversal traversal(graph, pool, true);
+	for (auto _ : state)
+	{
+		std::vector<uint32_t> levels = traversal.bfs(0);
+		benchmark::DoNotOptimize(levels.data());
+	}
+	reportRates(state, graph.numberOfEdges(), 0);
+}
+BENCHMARK(BM_GraphTraversalBfs)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_GraphTraversalShortestPaths(benchmark::State& state)
+{
+	ds::CompressedGraph graph(GRAPH_BENCHMARK_NODES, randomEdges(), 16);
+	ds::ThreadPool pool(Integer(state.range(0)));
+	ds::GraphTraversal traversal(graph, pool);
+	for (auto _ : state)
+	{
+		std::vector<uint64_t> distances = traversal.shortestPaths(0);
+		benchmark::DoNotOptimize(distances.data());
+	}
+	reportRates(state, graph.numberOfEdges(), 0);
+}
+BENCHMARK(BM_GraphTraversalShortestPaths)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_GraphTraversalConnectedComponents(benchmark::State& state)
+{
+	ds::CompressedGraph graph(GRAPH_BENCHMARK_NODES, symmetricEdges());
+	ds::ThreadPool pool(Integer(state.range(0)));
+	ds::GraphTraversal traversal(graph, pool, true);
+	for (auto _ : state)
+	{
+		std::vector<uint32_t> labels = traversal.connectedComponents();
+		benchmark::DoNotOptimize(labels.data());
+	}
+	reportRates(state, graph.numberOfEdges(), 0);
+}
+BENCHMARK(BM_GraphTraversalConnectedComponents)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond)->UseRealTime();
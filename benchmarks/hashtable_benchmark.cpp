@@ -0,0 +1,52 @@
+#include "common.h"
+#include "hashtable.h"
+
+/*
+	Hashtable insert and find at the load factors 1/4, 1/2, 3/4 and 7/8 of a table with HASHTABLE_BENCHMARK_CAPACITY slots.
+	The argument is the load factor in percent.
+*/
+#define HASHTABLE_BENCHMARK_CAPACITY (Integer(1) << 20)
+
+static Integer elementsFor(const benchmark::State& state)
+{
+	return HASHTABLE_BENCHMARK_CAPACITY * Integer(state.range(0)) / 100;
+}
+
+static void BM_HashtableInsert(benchmark::State& state)
+{
+	Integer n = elementsFor(state);
+	std::vector<Integer> keys = randomIndices(n, ~Integer(0));
+	Integer value = 0;
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		ds::Hashtable<Integer> table;
+		table.reserve(HASHTABLE_BENCHMARK_CAPACITY * 7 / 8);
+		state.ResumeTiming();
+		for (Integer key : keys)table.insert(key, &value);
+		benchmark::DoNotOptimize(table.size());
+	}
+	reportRates(state, n, n * (sizeof(Integer) + sizeof(Integer*)));
+}
+BENCHMARK(BM_HashtableInsert)->Arg(25)->Arg(50)->Arg(75)->Arg(87);
+
+static void BM_HashtableFind(benchmark::State& state)
+{
+	Integer n = elementsFor(state);
+	std::vector<Integer> keys = randomIndices(n, ~Integer(0));
+	Integer value = 0;
+	ds::Hashtable<Integer> table;
+	table.reserve(HASHTABLE_BENCHMARK_CAPACITY * 7 / 8);
+	for (Integer key : keys)table.insert(key, &value);
+	//half of the lookups miss
+	std::vector<Integer> lookups = randomIndices(n, ~Integer(0), 7);
+	for (Integer i = 0; i < n; i += 2)lookups[i] = keys[i];
+	for (auto _ : state)
+	{
+		Integer found = 0;
+		for (Integer key : lookups)found += table.find(key) != nullptr;
+		benchmark::DoNotOptimize(found);
+	}
+	reportRates(state, n, n * (sizeof(Integer) + sizeof(Integer*)));
+}
+BENCHMARK(BM_HashtableFind)->Arg(25)->Arg(50)->Arg(75)->Arg(87);
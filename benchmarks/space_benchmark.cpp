@@ -0,0 +1,192 @@
+#include "common.h"
+#include "space.h"
+
+/*
+	A sorted ArrayType of BENCHMARK_ELEMENTS integers with random gaps in [0, SPACE_BENCHMARK_GAP), 32 bits per integer.
+*/
+#define SPACE_BENCHMARK_GAP 64
+
+static ds::ArrayType sortedArray()
+{
+	std::vector<Integer> gaps = randomIndices(BENCHMARK_ELEMENTS, SPACE_BENCHMARK_GAP);
+	ds::ArrayType a(BENCHMARK_ELEMENTS, 32);
+	uint64_t value = 0;
+	for (Integer i = 0; i < BENCHMARK_ELEMENTS; i++)
+	{
+		value += gaps[i];
+		a.set(i, value);
+	}
+	return a;
+}
+
+/*
+	Building the Elias-Fano representation, the decoded sequence is compared with the input once before the measurement.
+*/
+static void BM_EliasFanoBuild(benchmark::State& state)
+{
+	ds::ArrayType a = sortedArray();
+	{
+		ds::EliasFano sequence(a);
+		for (Integer i = 0; i < BENCHMARK_ELEMENTS; i++)
+		{
+			if (sequence.access(i) != a[i])
+			{
+				state.SkipWithError("EliasFano does not decode its input");
+				free(a.array);
+				return;
+			}
+		}
+		state.counters["bits/element"] = double(sequence.bitSize()) / double(BENCHMARK_ELEMENTS);
+	}
+	for (auto _ : state)
+	{
+		ds::EliasFano sequence(a);
+		benchmark::DoNotOptimize(sequence.size());
+	}
+	reportRates(state, BENCHMARK_ELEMENTS, BENCHMARK_ELEMENTS * a.tau / 8);
+	free(a.array);
+}
+BENCHMARK(BM_EliasFanoBuild)->Unit(benchmark::kMillisecond);
+
+static void BM_EliasFanoAccess(benchmark::State& state)
+{
+	ds::ArrayType a = sortedArray();
+	ds::EliasFano sequence(a);
+	std::vector<Integer> indices = randomIndices(BENCHMARK_ELEMENTS, BENCHMARK_ELEMENTS);
+	for (auto _ : state)
+	{
+		uint64_t sum = 0;
+		for (Integer i : indices)sum += sequence.access(i);
+		benchmark::DoNotOptimize(sum);
+	}
+	reportRates(state, BENCHMARK_ELEMENTS, 0);
+	free(a.array);
+}
+BENCHMARK(BM_EliasFanoAccess);
+
+/*
+	nextGEQ for random lower bounds, checked against std::lower_bound on the decoded sequence first.
+*/
+static void BM_EliasFanoNextGEQ(benchmark::State& state)
+{
+	ds::ArrayType a = sortedArray();
+	ds::EliasFano sequence(a);
+	std::vector<Integer> bounds = randomIndices(BENCHMARK_ELEMENTS, sequence.universe() + 1);
+	std::vector<uint64_t> values(BENCHMARK_ELEMENTS);
+	a.getRange(0, BENCHMARK_ELEMENTS, values.data());
+	for (Integer k = 0; k < 1024; k++)
+	{
+		if (sequence.nextGEQ(bounds[k]) != uint64_t(std::lower_bound(values.begin(), values.end(), bounds[k]) - values.begin()))
+		{
+			state.SkipWithError("EliasFano::nextGEQ differs from std::lower_bound");
+			free(a.array);
+			return;
+		}
+	}
+	for (auto _ : state)
+	{
+		uint64_t sum = 0;
+		for (Integer x : bounds)sum += sequence.nextGEQ(x);
+		benchmark::DoNotOptimize(sum);
+	}
+	reportRates(state, BENCHMARK_ELEMENTS, 0);
+	free(a.array);
+}
+BENCHMARK(BM_EliasFanoNextGEQ);
+
+/*
+	BlockCodec on the sorted ArrayType (state.range(0) == 0, delta blocks) and on random integers with a small range per block
+	(state.range(0) == 1, frame of reference blocks).
+*/
+static ds::ArrayType blockCodecInput(Integer mode)
+{
+	if (mode == 0)return sortedArray();
+	std::vector<Integer> residuals = randomIndices(BENCHMARK_ELEMENTS, SPACE_BENCHMARK_GAP);
+	std::vector<Integer> references = randomIndices(BENCHMARK_ELEMENTS / BLOCK_CODEC_SIZE + 1, Integer(1) << 30, 7);
+	ds::ArrayType a(BENCHMARK_ELEMENTS, 32);
+	for (Integer i = 0; i < BENCHMARK_ELEMENTS; i++)a.set(i, references[i / BLOCK_CODEC_SIZE] + residuals[i]);
+	return a;
+}
+
+/*
+	Compares decode, decodeBlock and get of codec with a, returns the first mismatch or nullptr.
+*/
+static const char* blockCodecMismatch(const ds::BlockCodec& codec, const ds::ArrayType& a)
+{
+	std::vector<uint64_t> values(a.numberOfElements);
+	a.getRange(0, a.numberOfElements, values.data());
+	std::vector<uint64_t> decoded(a.numberOfElements);
+	codec.decode(decoded.data());
+	if (codec.size() != a.numberOfElements || decoded != values)return "BlockCodec::decode does not restore the input";
+	uint64_t block[BLOCK_CODEC_SIZE];
+	for (uint64_t b = 0; b < codec.numberOfBlocks(); b++)
+	{
+		uint64_t count = codec.decodeBlock(b, block);
+		if (!std::equal(block, block + count, values.begin() + b * BLOCK_CODEC_SIZE))return "BlockCodec::decodeBlock does not restore the input";
+	}
+	for (uint64_t i = 0; i < a.numberOfElements; i++)
+	{
+		if (codec.get(i) != values[i])return "BlockCodec::get does not restore the input";
+	}
+	return nullptr;
+}
+
+static void BM_BlockCodecEncode(benchmark::State& state)
+{
+	ds::ArrayType a = blockCodecInput(Integer(state.range(0)));
+	{
+		ds::BlockCodec codec(a);
+		const char* mismatch = blockCodecMismatch(codec, a);
+		if (mismatch)
+		{
+			state.SkipWithError(mismatch);
+			free(a.array);
+			return;
+		}
+		state.counters["bytes"] = double(codec.byteSize());
+	}
+	for (auto _ : state)
+	{
+		ds::BlockCodec codec(a);
+		benchmark::DoNotOptimize(codec.size());
+	}
+	reportRates(state, BENCHMARK_ELEMENTS, BENCHMARK_ELEMENTS * a.tau / 8);
+	free(a.array);
+}
+BENCHMARK(BM_BlockCodecEncode)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+static void BM_BlockCodecDecodeBlock(benchmark::State& state)
+{
+	ds::ArrayType a = blockCodecInput(Integer(state.range(0)));
+	ds::BlockCodec codec(a);
+	uint64_t block[BLOCK_CODEC_SIZE];
+	for (auto _ : state)
+	{
+		uint64_t sum = 0;
+		for (uint64_t b = 0; b < codec.numberOfBlocks(); b++)
+		{
+			codec.decodeBlock(b, block);
+			sum += block[0];
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	reportRates(state, BENCHMARK_ELEMENTS, BENCHMARK_ELEMENTS * sizeof(uint64_t));
+	free(a.array);
+}
+BENCHMARK(BM_BlockCodecDecodeBlock)->Arg(0)->Arg(1);
+
+static void BM_BlockCodecGet(benchmark::State& state)
+{
+	ds::ArrayType a = blockCodecInput(Integer(state.range(0)));
+	ds::BlockCodec codec(a);
+	std::vector<Integer> indices = randomIndices(BENCHMARK_ELEMENTS, BENCHMARK_ELEMENTS);
+	for (auto _ : state)
+	{
+		uint64_t sum = 0;
+		for (Integer i : indices)sum += codec.get(i);
+		benchmark::DoNotOptimize(sum);
+	}
+	reportRates(state, BENCHMARK_ELEMENTS, 0);
+	free(a.array);
+}
+BENCHMARK(BM_BlockCodecGet)->Arg(0)->Arg(1);
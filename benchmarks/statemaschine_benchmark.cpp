@@ -0,0 +1,204 @@
+#include "common.h"
+#include "statemaschine.h"
+#include "ahocorasick.h"
+#include <mutex>
+
+/*
+	Statemaschine::step over a random input. The automaton counts the symbol 'a' modulo STATEMASCHINE_BENCHMARK_STATES,
+	every state has an edge for each of the 4 symbols.
+*/
+#define STATEMASCHINE_BENCHMARK_STATES 64
+#define STATEMASCHINE_BENCHMARK_INPUT (Integer(1) << 20)
+
+class Callback
+{
+public:
+	void onStep() {}
+};
+
+static ds::Statemaschine<Callback, char> counter()
+{
+	ds::Statemaschine<Callback, char> automaton(STATEMASCHINE_BENCHMARK_STATES + 1);
+	for (uint32_t s = 1; s <= STATEMASCHINE_BENCHMARK_STATES; s++)
+	{
+		automaton.setEdge(s, s % STATEMASCHINE_BENCHMARK_STATES + 1, 'a');
+		for (char symbol = 'b'; symbol <= 'd'; symbol++)automaton.setEdge(s, s, symbol);
+	}
+	return automaton;
+}
+
+static std::vector<char> randomInput()
+{
+	std::vector<Integer> random = randomIndices(STATEMASCHINE_BENCHMARK_INPUT, 4);
+	std::vector<char> input(STATEMASCHINE_BENCHMARK_INPUT);
+	for (Integer i = 0; i < STATEMASCHINE_BENCHMARK_INPUT; i++)input[i] = char('a' + random[i]);
+	return input;
+}
+
+/*
+	state.range(0) == 1 compiles the automaton first, step then reads the dense table instead of the std::map.
+*/
+static void BM_StatemaschineStep(benchmark::State& state)
+{
+	ds::Statemaschine<Callback, char> automaton = counter();
+	if (state.range(0) == 1)automaton.compile();
+	std::vector<char> input = randomInput();
+	for (auto _ : state)
+	{
+		automaton.reset();
+		for (char symbol : input)automaton.step(symbol);
+		benchmark::DoNotOptimize(automaton.stateOf());
+	}
+	reportRates(state, STATEMASCHINE_BENCHMARK_INPUT, STATEMASCHINE_BENCHMARK_INPUT);
+}
+BENCHMARK(BM_StatemaschineStep)->Arg(0)->Arg(1);
+
+static void BM_StatemaschineRun(benchmark::State& state)
+{
+	ds::Statemaschine<Callback, char> automaton = counter();
+	automaton.compile();
+	std::vector<char> input = randomInput();
+	for (auto _ : state)
+	{
+		automaton.reset();
+		automaton.run(input.data(), input.data() + input.size());
+		benchmark::DoNotOptimize(automaton.stateOf());
+	}
+	reportRates(state, STATEMASCHINE_BENCHMARK_INPUT, STATEMASCHINE_BENCHMARK_INPUT);
+}
+BENCHMARK(BM_StatemaschineRun);
+
+/*
+	The same input cut into state.range(0) streams, which runStreams advances interleaved.
+*/
+static void BM_StatemaschineRunStreams(benchmark::State& state)
+{
+	ds::Statemaschine<Callback, char> automaton = counter();
+	automaton.compile();
+	std::vector<char> input = randomInput();
+	uint32_t count = uint32_t(state.range(0));
+	std::vector<const char*> begins(count);
+	std::vector<const char*> ends(count);
+	for (uint32_t k = 0; k < count; k++)
+	{
+		begins[k] = input.data() + k * input.size() / count;
+		ends[k] = input.data() + (k + 1) * input.size() / count;
+	}
+	std::vector<uint32_t> states(count);
+	for (auto _ : state)
+	{
+		for (uint32_t k = 0; k < count; k++)states[k] = automaton.startState();
+		automaton.runStreams(begins.data(), ends.data(), states.data(), count);
+		benchmark::DoNotOptimize(states.data());
+	}
+	reportRates(state, STATEMASCHINE_BENCHMARK_INPUT, STATEMASCHINE_BENCHMARK_INPUT);
+}
+BENCHMARK(BM_StatemaschineRunStreams)->Arg(1)->Arg(8)->Arg(16);
+
+/*
+	Every benchmark thread runs its own StatemaschineCursor over the input, all cursors share one compiled counter.
+*/
+static std::shared_ptr<const ds::CompiledStatemaschine<Callback, char>> sharedCounter()
+{
+	static std::shared_ptr<const ds::CompiledStatemaschine<Callback, char>> compiled;
+	static std::once_flag once;
+	std::call_once(once, []()
+	{
+		ds::Statemaschine<Callback, char> automaton = counter();
+		automaton.compile();
+		compiled = automaton.compiled();
+	});
+	return compiled;
+}
+
+static void BM_StatemaschineCursors(benchmark::State& state)
+{
+	ds::StatemaschineCursor<Callback, char> cursor(sharedCounter());
+	std::vector<char> input = randomInput();
+	for (auto _ : state)
+	{
+		cursor.reset();
+		cursor.run(input.data(), input.data() + input.size());
+		benchmark::DoNotOptimize(cursor.stateOf());
+	}
+	state.counters["bytes"] = benchmark::Counter(double(cursor.automaton().byteSize()), benchmark::Counter::kAvgThreads);
+	reportRates(state, STATEMASCHINE_BENCHMARK_INPUT, STATEMASCHINE_BENCHMARK_INPUT);
+}
+BENCHMARK(BM_StatemaschineCursors)->Threads(1)->Threads(4)->Threads(16)->UseRealTime();
+
+/*
+	minimize on the counter, where every state is split into STATEMASCHINE_BENCHMARK_COPIES equivalent copies.
+*/
+#define STATEMASCHINE_BENCHMARK_COPIES 64
+
+static void BM_StatemaschineMinimize(benchmark::State& state)
+{
+	uint32_t states = STATEMASCHINE_BENCHMARK_STATES * STATEMASCHINE_BENCHMARK_COPIES;
+	std::vector<Integer> copies = randomIndices(Integer(states) * 4, STATEMASCHINE_BENCHMARK_COPIES);
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		ds::Statemaschine<Callback, char> automaton(states + 1);
+		for (uint32_t s = 0; s < states; s++)
+		{
+			uint32_t count = s / STATEMASCHINE_BENCHMARK_COPIES;
+			uint32_t following = (count + 1) % STATEMASCHINE_BENCHMARK_STATES * STATEMASCHINE_BENCHMARK_COPIES;
+			automaton.setEdge(s + 1, following + uint32_t(copies[4 * s]) + 1, 'a');
+			for (char symbol = 'b'; symbol <= 'd'; symbol++)automaton.setEdge(s + 1, count * STATEMASCHINE_BENCHMARK_COPIES + uint32_t(copies[4 * s + symbol - 'a']) + 1, symbol);
+		}
+		for (uint32_t k = 1; k <= STATEMASCHINE_BENCHMARK_COPIES; k++)automaton.addAcceptingState(k);
+		state.ResumeTiming();
+		std::pair<uint32_t, uint32_t> counts = automaton.minimize();
+		state.counters["before"] = counts.first;
+		state.counters["after"] = counts.second;
+	}
+}
+BENCHMARK(BM_StatemaschineMinimize)->Unit(benchmark::kMillisecond);
+
+/*
+	AhoCorasick with AHO_CORASICK_BENCHMARK_PATTERNS random lowercase keywords of 4 - 11 letters on random lowercase text
+	with spaces.
+*/
+#define AHO_CORASICK_BENCHMARK_PATTERNS 20000
+#define AHO_CORASICK_BENCHMARK_TEXT (Integer(1) << 24)
+
+static std::vector<std::string> randomKeywords()
+{
+	std::mt19937_64 random(7);
+	std::vector<std::string> keywords(AHO_CORASICK_BENCHMARK_PATTERNS);
+	for (std::string& keyword : keywords)
+	{
+		Integer length = 4 + random() % 8;
+		for (Integer k = 0; k < length; k++)keyword.push_back(char('a' + random() % 26));
+	}
+	return keywords;
+}
+
+static void BM_AhoCorasickBuild(benchmark::State& state)
+{
+	std::vector<std::string> keywords = randomKeywords();
+	for (auto _ : state)
+	{
+		ds::AhoCorasick matcher(keywords);
+		benchmark::DoNotOptimize(matcher.numberOfStates());
+		state.counters["states"] = matcher.numberOfStates();
+	}
+}
+BENCHMARK(BM_AhoCorasickBuild)->Unit(benchmark::kMillisecond);
+
+static void BM_AhoCorasickMatch(benchmark::State& state)
+{
+	ds::AhoCorasick matcher(randomKeywords());
+	std::mt19937_64 random(8);
+	std::string text(AHO_CORASICK_BENCHMARK_TEXT, ' ');
+	for (char& symbol : text)symbol = random() % 8 == 0 ? ' ' : char('a' + random() % 26);
+	for (auto _ : state)
+	{
+		Integer hits = 0;
+		matcher.match(text.data(), text.data() + text.size(), matcher.start(), 0, [&](const ds::AhoCorasickHit*, Integer count) { hits += count; });
+		benchmark::DoNotOptimize(hits);
+		state.counters["hits"] = double(hits);
+	}
+	reportRates(state, AHO_CORASICK_BENCHMARK_TEXT, AHO_CORASICK_BENCHMARK_TEXT);
+}
+BENCHMARK(BM_AhoCorasickMatch)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,77 @@
+#include "common.h"
+#include "tree.h"
+
+/*
+	CompressedTree: navigation on a random tree with BENCHMARK_ELEMENTS nodes, every node hangs below a random node of the
+	path from the root to its predecessor (depth about 2 ln n).
+*/
+
+static ds::CompressedTree makeTree()
+{
+	std::mt19937_64 random(42);
+	std::vector<uint32_t> parents(BENCHMARK_ELEMENTS);
+	std::vector<uint32_t> path;
+	parents[0] = COMPRESSED_TREE_NONE;
+	path.push_back(0);
+	for (uint32_t v = 1; v < BENCHMARK_ELEMENTS; v++)
+	{
+		path.resize(1 + random() % path.size());
+		parents[v] = path.back();
+		path.push_back(v);
+	}
+	return ds::CompressedTree(parents);
+}
+
+static void BM_CompressedTreeBuild(benchmark::State& state)
+{
+	for (auto _ : state)
+	{
+		ds::CompressedTree tree = makeTree();
+		benchmark::DoNotOptimize(tree.size());
+	}
+	reportRates(state, BENCHMARK_ELEMENTS, 0);
+}
+BENCHMARK(BM_CompressedTreeBuild);
+
+static void BM_CompressedTreeParent(benchmark::State& state)
+{
+	ds::CompressedTree tree = makeTree();
+	std::vector<Integer> nodes = randomIndices(BENCHMARK_ELEMENTS, BENCHMARK_ELEMENTS);
+	for (auto _ : state)
+	{
+		uint32_t sum = 0;
+		for (Integer v : nodes)sum += tree.parent(uint32_t(v));
+		benchmark::DoNotOptimize(sum);
+	}
+	reportRates(state, BENCHMARK_ELEMENTS, 0);
+	state.counters["bits/node"] = double(tree.byteSize() * 8) / double(BENCHMARK_ELEMENTS);
+}
+BENCHMARK(BM_CompressedTreeParent);
+
+static void BM_CompressedTreeSubtreeSize(benchmark::State& state)
+{
+	ds::CompressedTree tree = makeTree();
+	std::vector<Integer> nodes = randomIndices(BENCHMARK_ELEMENTS, BENCHMARK_ELEMENTS);
+	for (auto _ : state)
+	{
+		uint32_t sum = 0;
+		for (Integer v : nodes)sum += tree.subtreeSize(uint32_t(v));
+		benchmark::DoNotOptimize(sum);
+	}
+	reportRates(state, BENCHMARK_ELEMENTS, 0);
+}
+BENCHMARK(BM_CompressedTreeSubtreeSize);
+
+static void BM_CompressedTreeLca(benchmark::State& state)
+{
+	ds::CompressedTree tree = makeTree();
+	std::vector<Integer> nodes = randomIndices(BENCHMARK_ELEMENTS, BENCHMARK_ELEMENTS);
+	for (auto _ : state)
+	{
+		uint32_t sum = 0;
+		for (Integer i = 0; i + 1 < nodes.size(); i += 2)sum += tree.lca(uint32_t(nodes[i]), uint32_t(nodes[i + 1]));
+		benchmark::DoNotOptimize(sum);
+	}
+	reportRates(state, BENCHMARK_ELEMENTS / 2, 0);
+}
+BENCHMARK(BM_CompressedTreeLca);
@@ -0,0 +1,86 @@
+#ifndef __AHOCORASICK_H__
+
+#define __AHOCORASICK_H__
+
+#include "includes.h"
+#include "statemaschine.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+/*
+	AhoCorasick::match sammelt bis zu AHO_CORASICK_BATCH Treffer, bevor es den Callback aufruft. AHO_CORASICK_NONE markiert
+	einen fehlenden Knoten oder Ausgabelink.
+*/
+#define AHO_CORASICK_BATCH 256
+#define AHO_CORASICK_NONE 0xFFFFFFFF
+
+namespace ds
+{
+	/*!
+		\brief Ein Treffer: das Muster m_pattern endet vor der Position m_end der Eingabe.
+	*/
+	struct AhoCorasickHit
+	{
+		Integer m_end;
+		uint32_t m_pattern;
+	};
+
+	/*!
+		\class AhoCorasick sucht eine Menge von Mustern (Bytefolgen) gleichzeitig in einem Text. Der Konstruktor baut den Trie
+		der Muster, berechnet die Fehlerlinks in Breitensuche und daraus die vollständige Übergangsfunktion, die als dichte
+		Tabelle in eine Statemaschine kompiliert wird (ein Übergang pro Byte, unabhängig von der Anzahl der Muster). Das
+		Alphabet sind die Bytes der Muster, alle anderen Bytes führen zur Wurzel. Zustand 0 ist der Fehlerzustand, 1 die
+		Wurzel (Startzustand), die Zustände, an denen ein Muster endet, sind akzeptierend und haben die größten Nummern, so
+		prüft match pro Byte nur einen Vergleich. Die Tabelle hat (Zustände) x (verschiedene Bytes + 1) Einträge, bei
+		Zehntausenden Mustern also einige 10 MB.
+	*/
+	class AhoCorasick
+	{
+	private:
+		Statemaschine<AhoCorasick, char> m_automaton;
+		/*!
+			\brief Die Muster, die in Zustand z enden: m_patterns[m_patternOffsets[z - m_firstAccepting], ... ], weitere Treffer
+			liefert der Ausgabelink (der nächste akzeptierende Zustand auf der Kette der Fehlerlinks).
+		*/
+		std::vector<uint32_t> m_patternOffsets;
+		std::vector<uint32_t> m_patterns;
+		std::vector<uint32_t> m_outputLinks;
+		uint32_t m_firstAccepting;
+		uint32_t m_numberOfStates;
+		uint32_t m_numberOfPatterns;
+	public:
+		/*!
+		* \brief Baut den Automaten in O(Gesamtlänge der Muster x Alphabetgröße).
+		*
+		* \param patterns	- Die Muster, die Nummer eines Musters ist sein Index. Leere Muster werden ignoriert, doppelte
+		*					  Muster werden beide gemeldet.
+		*/
+		AhoCorasick(const std::vector<std::string>& patterns);
+		~AhoCorasick();
+		/*!
+		* \brief Sucht alle Vorkommen der Muster in [begin, end) und meldet sie gesammelt in Blöcken von höchstens
+		* AHO_CORASICK_BATCH Treffern, in der Reihenfolge ihrer Endpositionen (bei gleicher Endposition das längere Muster
+		* zuerst). Eine in Stücken gelesene Eingabe wird mit dem Zustand fortgesetzt, den der vorherige Aufruf zurückgibt.
+		*
+		* \param state	- Der Zustand vor begin, start() für eine neue Eingabe.
+		* \param offset	- Die Position von begin in der ganzen Eingabe, die Endpositionen der Treffer sind relativ dazu.
+		* \param report	- Bekommt die Treffer und ihre Anzahl.
+		* \return		Der Zustand nach end.
+		*/
+		uint32_t match(const char* begin, const char* end, uint32_t state, Integer offset, const std::function<void(const AhoCorasickHit*, Integer)>& report) const;
+		/*!
+		* \brief Die Anzahl der Vorkommen aller Muster in [begin, end).
+		*/
+		Integer count(const char* begin, const char* end) const;
+		uint32_t start() const;
+		uint32_t numberOfStates() const;
+		uint32_t numberOfPatterns() const;
+		/*!
+		* \brief Der kompilierte Automat, etwa für runStreams oder isInAcceptingState.
+		*/
+		const Statemaschine<AhoCorasick, char>& automaton() const;
+	};
+};
+
+#endif // !__AHOCORASICK_H__
@@ -4,9 +4,13 @@
 
 #include "bitmanipulation.h"
 #include <mutex>
+#include <memory>
+#include <string>
 
 namespace ds
 {
+	class MappedFile;
+
 	template<Integer t_size, Integer t_tau>
 	class 
 #ifdef _WIN32 || _WIN64
@@ -26,16 +30,18 @@ namespace ds
 		FixedSizeArray(FixedSizeArray<t_size, t_tau>&& other) { *this = other; };
 		FixedSizeArray& operator=(const FixedSizeArray<t_size, t_tau>& other)
 		{
-			m_length = other.m_length;
 			for (Integer i = 0; i < t_size; i++) m_content[i] = other.m_content[i];
+			return *this;
 		};
-		FixedSizeArray& operator=(FixedSizeArray<t_size, t_tau>&& other) { *this = other; };
+		FixedSizeArray& operator=(FixedSizeArray<t_size, t_tau>&& other) { return *this = other; };
 		~FixedSizeArray() {};
 		//Integer operator[](Integer i) const { return getBlockSystem(i * t_tau, t_tau, m_content); };
 		Integer operator[](Integer i) const { return getBlockEnv<t_tau>(i * t_tau, m_content); };
 		void set(Integer i, Integer value) { setBlockEnv<t_tau>(i * t_tau, value, m_content); };
 		Integer get(Integer i) const { return operator[](i); };
-		Integer length() const { return t_size * sizeof(Integer) / m_tau; };
+		void getRange(Integer first, Integer n, uint64_t* out) const { unpack<t_tau>(m_content, first, n, out); };
+		void setRange(Integer first, Integer n, const uint64_t* in) { pack<t_tau>(in, first, n, m_content); };
+		Integer length() const { return t_size * IntegerBitSize / t_tau; };
 		Integer tau() const { return t_tau; };
 		Integer byteSize() const { return sizeof(*this); };
 	};
@@ -112,6 +118,9 @@ namespace ds
 		//__declspec(align(16)) uint32_t* m_content;
 		//__attribute__(aligned(16)) 
 		Integer* m_content;
+		//set, if m_content points into a mapped file (see fileformat.h), m_content is not freed then
+		std::shared_ptr<MappedFile> m_mapping;
+		void release();
 	public:
 		Array(Integer size, Integer tau);
 		Array();
@@ -123,7 +132,92 @@ namespace ds
 		Integer operator[](Integer i) const;
 		void set(Integer i, Integer value);
 		Integer get(Integer i) const;
+		/**
+		Decodes the elements [first, ... , first + n - 1] into out. See "unpack" in bitmanipulation.h.
+		*/
+		void getRange(Integer first, Integer n, uint64_t* out) const;
+		/**
+		Sets the elements [first, ... , first + n - 1] to in[0, ... , n - 1]. See "pack" in bitmanipulation.h.
+		*/
+		void setRange(Integer first, Integer n, const uint64_t* in);
+		/**
+		Writes the array as packed file (see fileformat.h) to path. Returns false, if the file could not be written.
+		*/
+		bool save(const std::string& path) const;
+		/**
+		Replaces the content with a packed file, which is mapped copy-on-write instead of being read: the words are
+		used in place, pages are loaded on first access and shared between processes mapping the same file.
+		set/setRange only change the private copy of the touched pages. verify recomputes the checksum (touches every page).
+		Returns false and leaves the array unchanged, if the file can not be mapped or is no packed Array.
+		*/
+		bool mapFile(const std::string& path, bool verify = false);
+		/**
+		true, if the content resides in a mapped file.
+		*/
+		bool isMapped() const;
+		Integer length() const;
+		Integer tau() const;
+		Integer byteSize() const;
+	};
+
+	/**
+	One dimensional growable array with tau bit for each element. push_back runs in amortized O(1), the capacity doubles.
+	If a value does not fit into tau bits, tau is widened to the bitlength of the value and all elements are repacked in bulk.
+	*/
+	class
+#ifdef _WIN32 || _WIN64
+		__declspec(align(CACHE_LINE_ALIGNMENT))
+#endif	
+	DynamicArray
+	{
+	private:
+		Integer m_tau;
+		Integer m_numElements;
+		Integer m_capacity;
+		Integer* m_content;
+		static Integer wordsFor(Integer capacity, Integer tau);
+		static Integer bitsFor(Integer value);
+		void reallocate(Integer capacity, Integer tau);
+	public:
+		DynamicArray();
+		DynamicArray(Integer tau);
+		DynamicArray(Integer size, Integer tau);
+		DynamicArray(const DynamicArray& other);
+		DynamicArray(DynamicArray&& other);
+		DynamicArray& operator=(const DynamicArray& other);
+		DynamicArray& operator=(DynamicArray&& other);
+		~DynamicArray();
+		Integer operator[](Integer i) const;
+		Integer get(Integer i) const;
+		/**
+		Sets the i-th element, widens tau if value does not fit.
+		*/
+		void set(Integer i, Integer value);
+		/**
+		Appends value, widens tau if value does not fit. Amortized O(1), O(n) if tau is widened.
+		*/
+		void push_back(Integer value);
+		void pop_back();
+		void getRange(Integer first, Integer n, uint64_t* out) const;
+		/**
+		Sets the elements [first, ... , first + n - 1] to in[0, ... , n - 1], widens tau once for the largest value.
+		*/
+		void setRange(Integer first, Integer n, const uint64_t* in);
+		/**
+		Grows the capacity to at least capacity elements.
+		*/
+		void reserve(Integer capacity);
+		/**
+		Reduces the capacity to length().
+		*/
+		void shrink_to_fit();
+		/**
+		Changes the bitlength of every element to tau, all elements are repacked in bulk (unpack/pack in chunks).
+		A smaller tau cuts off the high bits of the elements.
+		*/
+		void changeTau(Integer tau);
 		Integer length() const;
+		Integer capacity() const;
 		Integer tau() const;
 		Integer byteSize() const;
 	};
@@ -4,33 +4,96 @@
 
 #include "includes.h"
 #include "array.h"
+#include <vector>
+
 namespace ds
 {
-	/*
+	/**
+	Search tree without pointers: the nodes are stored implicitly in an Array of tau bit elements, the children of slot c are
+	the slots 2c + 1 and 2c + 2 and the array holds 2^levels - 1 slots. An empty slot holds the empty mask 2^tau - 1, so the
+	values have to be smaller than that, a larger value widens tau and repacks all slots in bulk. Equal values are allowed.
+	The depth is bounded by partial rebuilding: if an insert falls below the last level, the lowest ancestor, whose subtree
+	is filled to at most 1/2 + depth / (2 levels) of its slots, is rebuilt perfectly balanced. If the root is too full
+	for that, one level is added, so inserts keep the array at least 1/4 full and the height at most log2(n) + 2. Removes
+	shrink the array, when it is less than 1/8 full, the height stays below log2(n) + 4 then.
+	*/
 	class BalancedBinaryTree
 	{
 	private:
-		uint32_t m_emptyMask;
+		Integer m_emptyMask;
+		Integer m_levels;
+		Integer m_count;
 		Array m_content;
-		uint32_t left(uint32_t c);
-		uint32_t right(uint32_t c);
-		uint32_t parent(uint32_t c);
-		uint32_t height(uint32_t node) const;
-		bool isLeaft(uint32_t node) const;
-		void balance();
-		void resize(uint32_t size);
-		uint32_t find(uint32_t start, uint32_t val) const;
+		static Integer left(Integer c);
+		static Integer right(Integer c);
+		static Integer parent(Integer c);
+		static Integer depthOf(Integer c);
+		static Integer levelsFor(Integer size);
+		static Integer tauFor(Integer value);
+		Integer slot(Integer node) const;
+		void setSlot(Integer node, Integer value);
+		bool isEmpty(Integer node) const;
+		Integer find(Integer value) const;
+		Integer countNodes(Integer root) const;
+		void readSubtree(Integer root, std::vector<uint64_t>& slots) const;
+		void collect(Integer root, std::vector<Integer>& sorted) const;
+		static void fill(std::vector<uint64_t>& slots, Integer node, const std::vector<Integer>& sorted, Integer first, Integer last);
+		void place(Integer root, const std::vector<Integer>& sorted);
+		void resizeLevels(Integer levels);
 	public:
-		BalancedBinaryTree(uint32_t size, uint8_t tau);
+		/**
+		Description: 	Creates an empty tree.
+		Parameter:		size	- The number of slots to allocate in advance (rounded up to 2^levels - 1).
+						tau		- The bitlength of the slots, the values have to be smaller than 2^tau - 1.
+		*/
+		BalancedBinaryTree(Integer size, Integer tau);
 		~BalancedBinaryTree();
-		void insert(uint32_t value);
-		void remove(uint32_t value);
-		void count() const;
-		uint32_t height() const;
-		void changeTau(uint8_t tau);
-		uint8_t tau() const;
+		/**
+		Description: 	Inserts value, widens tau if value >= 2^tau - 1.
+		Preconditions:	value < 2^64 - 1.
+		Complexity: 	O(log n) plus an amortized O(log^2 n) for rebuilding.
+		*/
+		void insert(Integer value);
+		/**
+		Description: 	Removes one occurrence of value. A removed node is replaced by its predecessor or successor down to a
+						leaf, the array shrinks, when it is less than 1/8 full.
+		Result:			true, if value was found.
+		Complexity: 	O(log n), amortized.
+		*/
+		bool remove(Integer value);
+		bool contains(Integer value) const;
+		/**
+		Description: 	Appends all values in ascending order to sorted.
+		Complexity: 	O(slots).
+		*/
+		void collect(std::vector<Integer>& sorted) const;
+		/**
+		Result:			The number of values.
+		*/
+		Integer count() const;
+		/**
+		Result:			The number of levels with at least one node.
+		*/
+		Integer height() const;
+		/**
+		Description: 	Repacks all slots to tau bits in bulk (unpack/pack in chunks).
+		Result:			false and the tree is unchanged, if a value does not fit into tau bits (>= 2^tau - 1).
+		Complexity: 	O(slots).
+		*/
+		bool changeTau(Integer tau);
+		/**
+		Description: 	Sets the number of slots to the smallest 2^levels - 1, which holds size and all values. A smaller array
+						is filled with a perfectly balanced tree.
+		Complexity: 	O(slots).
+		*/
+		void resize(Integer size);
+		Integer tau() const;
+		/**
+		Result:			The number of slots, count() <= capacity().
+		*/
+		Integer capacity() const;
+		Integer byteSize() const;
 	};
-	*/
 };
 
-#endif
\ No newline at end of file
+#endif
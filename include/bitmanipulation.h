@@ -3,9 +3,15 @@
 
 #include <stdint.h>
 #include <iostream>
+#if _MSC_VER
+	#include <intrin.h>
+#endif
+#if __BMI2__
+	#include <immintrin.h>
+#endif
 
 #define DEBUG 1
-//#define SIMD 1
+#define SIMD 1
 
 #ifdef LINUX
 
@@ -72,23 +78,20 @@ namespace ds
 	static const uint64_t s_one64 = uint64_t(1);
 	static const uint64_t s_oneSystem = Integer(1);
 
-#ifdef _WIN32 || _WIN64
-	static __declspec(align(32)) const uint32_t s_maskTable32[33] = { uint32_t(0), uint32_t(1), uint32_t(3), uint32_t(7), uint32_t(15),uint32_t(31), uint32_t(63), uint32_t(127), uint32_t(255), uint32_t(511), uint32_t(1023), uint32_t(2047), uint32_t(4095), uint32_t(8191), uint32_t(16383), uint32_t(32767), uint32_t(65535), uint32_t(131071), uint32_t(262143), uint32_t(524287), uint32_t(1048575), uint32_t(2097151), uint32_t(4194303), uint32_t(8388607), uint32_t(16777215), uint32_t(33554431), uint32_t(67108863), uint32_t(134217727), uint32_t(268435455), uint32_t(536870911), uint32_t(1073741823), uint32_t(2147483647), uint32_t(4294967295) };
-	static __declspec(align(32)) const uint64_t s_maskTable64[65] = { uint64_t(0), uint64_t(1), uint64_t(3), uint64_t(7), uint64_t(15), uint64_t(31), uint64_t(63), uint64_t(127), uint64_t(255), uint64_t(511), uint64_t(1023), uint64_t(2047), uint64_t(4095), uint64_t(8191), uint64_t(16383), uint64_t(32767), uint64_t(65535), uint64_t(131071), uint64_t(262143), uint64_t(524287), uint64_t(1048575), uint64_t(2097151), uint64_t(4194303), uint64_t(8388607), uint64_t(16777215), uint64_t(33554431), uint64_t(67108863), uint64_t(134217727), uint64_t(268435455), uint64_t(536870911), uint64_t(1073741823), uint64_t(2147483647), uint64_t(4294967295), uint64_t((uint64_t(1) << uint64_t(33)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(34)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(35)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(36)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(37)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(38)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(39)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(40)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(41)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(42)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(43)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(44)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(45)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(46)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(47)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(48)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(49)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(50)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(51)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(52)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(53)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(54)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(55)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(56)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(57)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(58)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(59)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(60)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(61)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(62)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(63)) - uint64_t(1)), ~uint64_t(0) };
+	/*
+		Entry i of the mask tables holds the i lowest bits, entry i of the inverse shift tables IntegerBitSize - i.
+	*/
+	alignas(CACHE_LINE_ALIGNMENT) static const uint32_t s_maskTable32[33] = { uint32_t(0), uint32_t(1), uint32_t(3), uint32_t(7), uint32_t(15),uint32_t(31), uint32_t(63), uint32_t(127), uint32_t(255), uint32_t(511), uint32_t(1023), uint32_t(2047), uint32_t(4095), uint32_t(8191), uint32_t(16383), uint32_t(32767), uint32_t(65535), uint32_t(131071), uint32_t(262143), uint32_t(524287), uint32_t(1048575), uint32_t(2097151), uint32_t(4194303), uint32_t(8388607), uint32_t(16777215), uint32_t(33554431), uint32_t(67108863), uint32_t(134217727), uint32_t(268435455), uint32_t(536870911), uint32_t(1073741823), uint32_t(2147483647), uint32_t(4294967295) };
+	alignas(CACHE_LINE_ALIGNMENT) static const uint64_t s_maskTable64[65] = { uint64_t(0), uint64_t(1), uint64_t(3), uint64_t(7), uint64_t(15), uint64_t(31), uint64_t(63), uint64_t(127), uint64_t(255), uint64_t(511), uint64_t(1023), uint64_t(2047), uint64_t(4095), uint64_t(8191), uint64_t(16383), uint64_t(32767), uint64_t(65535), uint64_t(131071), uint64_t(262143), uint64_t(524287), uint64_t(1048575), uint64_t(2097151), uint64_t(4194303), uint64_t(8388607), uint64_t(16777215), uint64_t(33554431), uint64_t(67108863), uint64_t(134217727), uint64_t(268435455), uint64_t(536870911), uint64_t(1073741823), uint64_t(2147483647), uint64_t(4294967295), uint64_t((uint64_t(1) << uint64_t(33)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(34)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(35)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(36)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(37)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(38)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(39)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(40)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(41)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(42)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(43)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(44)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(45)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(46)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(47)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(48)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(49)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(50)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(51)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(52)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(53)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(54)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(55)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(56)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(57)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(58)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(59)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(60)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(61)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(62)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(63)) - uint64_t(1)), ~uint64_t(0) };
+
+	alignas(CACHE_LINE_ALIGNMENT) static const uint32_t s_inverseShiftTable32[33] = { uint32_t(32), uint32_t(31), uint32_t(30), uint32_t(29), uint32_t(28),uint32_t(27), uint32_t(26), uint32_t(25), uint32_t(24), uint32_t(23), uint32_t(22), uint32_t(21), uint32_t(20), uint32_t(19), uint32_t(18), uint32_t(17), uint32_t(16), uint32_t(15), uint32_t(14), uint32_t(13), uint32_t(12), uint32_t(11), uint32_t(10), uint32_t(9), uint32_t(8), uint32_t(7), uint32_t(6), uint32_t(5), uint32_t(4), uint32_t(3), uint32_t(2), uint32_t(1), uint32_t(0) };
+	alignas(CACHE_LINE_ALIGNMENT) static const uint64_t s_inverseShiftTable64[65] = { uint64_t(64), uint64_t(63), uint64_t(62), uint64_t(61), uint64_t(60),uint64_t(59), uint64_t(58), uint64_t(57), uint64_t(56), uint64_t(55), uint64_t(54), uint64_t(53), uint64_t(52), uint64_t(51), uint64_t(50), uint64_t(49), uint64_t(48), uint64_t(47), uint64_t(46), uint64_t(45), uint64_t(44), uint64_t(43), uint64_t(42), uint64_t(41), uint64_t(40), uint64_t(39), uint64_t(38), uint64_t(37), uint64_t(36), uint64_t(35), uint64_t(34), uint64_t(33), uint64_t(32), uint64_t(31), uint64_t(30), uint64_t(29), uint64_t(28),uint64_t(27), uint64_t(26), uint64_t(25), uint64_t(24), uint64_t(23), uint64_t(22), uint64_t(21), uint64_t(20), uint64_t(19), uint64_t(18), uint64_t(17), uint64_t(16), uint64_t(15), uint64_t(14), uint64_t(13), uint64_t(12), uint64_t(11), uint64_t(10), uint64_t(9), uint64_t(8), uint64_t(7), uint64_t(6), uint64_t(5), uint64_t(4), uint64_t(3), uint64_t(2), uint64_t(1), uint64_t(0) };
+
+#ifdef ENV64BIT
 	#define IntegerMaskTable s_maskTable64
-#else
-	static const uint32_t s_maskTable32[32] = { uint32_t(1), uint32_t(3), uint32_t(7), uint32_t(15),uint32_t(31), uint32_t(63), uint32_t(127), uint32_t(255), uint32_t(511), uint32_t(1023), uint32_t(2047), uint32_t(4095), uint32_t(8191), uint32_t(16383), uint32_t(32767), uint32_t(65535), uint32_t(131071), uint32_t(262143), uint32_t(524287), uint32_t(1048575), uint32_t(2097151), uint32_t(4194303), uint32_t(8388607), uint32_t(16777215), uint32_t(33554431), uint32_t(67108863), uint32_t(134217727), uint32_t(268435455), uint32_t(536870911), uint32_t(1073741823), uint32_t(2147483647), uint32_t(4294967295) };
-	static const uint64_t s_maskTable64[64] = { uint64_t(1), uint64_t(3), uint64_t(7), uint64_t(15), uint64_t(31), uint64_t(63), uint64_t(127), uint64_t(255), uint64_t(511), uint64_t(1023), uint64_t(2047), uint64_t(4095), uint64_t(8191), uint64_t(16383), uint64_t(32767), uint64_t(65535), uint64_t(131071), uint64_t(262143), uint64_t(524287), uint64_t(1048575), uint64_t(2097151), uint64_t(4194303), uint64_t(8388607), uint64_t(16777215), uint64_t(33554431), uint64_t(67108863), uint64_t(134217727), uint64_t(268435455), uint64_t(536870911), uint64_t(1073741823), uint64_t(2147483647), uint64_t(4294967295), uint64_t((uint64_t(1) << uint64_t(33)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(34)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(35)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(36)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(37)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(38)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(39)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(40)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(41)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(42)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(43)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(44)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(45)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(46)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(47)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(48)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(49)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(50)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(51)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(52)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(53)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(54)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(55)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(56)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(57)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(58)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(59)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(60)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(61)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(62)) - uint64_t(1)), uint64_t((uint64_t(1) << uint64_t(63)) - uint64_t(1)), ~uint64_t(0) };
-#define IntegerMaskTable s_maskTable32
-#endif
-	
-#ifdef _WIN32 || _WIN64	
-	static __declspec(align(32)) const uint32_t s_inverseShiftTable32[33] = { uint32_t(32), uint32_t(31), uint32_t(30), uint32_t(29), uint32_t(28),uint32_t(27), uint32_t(26), uint32_t(25), uint32_t(24), uint32_t(23), uint32_t(22), uint32_t(21), uint32_t(20), uint32_t(19), uint32_t(18), uint32_t(17), uint32_t(16), uint32_t(15), uint32_t(14), uint32_t(13), uint32_t(12), uint32_t(11), uint32_t(10), uint32_t(9), uint32_t(8), uint32_t(7), uint32_t(6), uint32_t(5), uint32_t(4), uint32_t(3), uint32_t(2), uint32_t(1), uint32_t(0) };
-	static __declspec(align(32)) const uint64_t s_inverseShiftTable64[65] = { uint64_t(64), uint64_t(63), uint64_t(62), uint64_t(61), uint64_t(60),uint64_t(59), uint64_t(58), uint64_t(57), uint64_t(56), uint64_t(55), uint64_t(54), uint64_t(53), uint64_t(52), uint64_t(51), uint64_t(50), uint64_t(49), uint64_t(48), uint64_t(47), uint64_t(46), uint64_t(45), uint64_t(44), uint64_t(43), uint64_t(42), uint64_t(41), uint64_t(40), uint64_t(39), uint64_t(38), uint64_t(37), uint64_t(36), uint64_t(35), uint64_t(34), uint64_t(33), uint64_t(32), uint64_t(31), uint64_t(30), uint64_t(29), uint64_t(28),uint64_t(27), uint64_t(26), uint64_t(25), uint64_t(24), uint64_t(23), uint64_t(22), uint64_t(21), uint64_t(20), uint64_t(19), uint64_t(18), uint64_t(17), uint64_t(16), uint64_t(15), uint64_t(14), uint64_t(13), uint64_t(12), uint64_t(11), uint64_t(10), uint64_t(9), uint64_t(8), uint64_t(7), uint64_t(6), uint64_t(5), uint64_t(4), uint64_t(3), uint64_t(2), uint64_t(1), uint64_t(0) };
 	#define IntegerInverseShiftTable s_inverseShiftTable64
 #else
-	static const uint32_t s_inverseShiftTable32[33] = { uint32_t(32), uint32_t(31), uint32_t(30), uint32_t(29), uint32_t(28),uint32_t(27), uint32_t(26), uint32_t(25), uint32_t(24), uint32_t(23), uint32_t(22), uint32_t(21), uint32_t(20), uint32_t(19), uint32_t(18), uint32_t(17), uint32_t(16), uint32_t(15), uint32_t(14), uint32_t(13), uint32_t(12), uint32_t(11), uint32_t(10), uint32_t(9), uint32_t(8), uint32_t(7), uint32_t(6), uint32_t(5), uint32_t(4), uint32_t(3), uint32_t(2), uint32_t(1), uint32_t(0) };
-	static const uint64_t s_inverseShiftTable64[65] = { uint64_t(64), uint64_t(63), uint64_t(62), uint64_t(61), uint64_t(60),uint64_t(59), uint64_t(58), uint64_t(57), uint64_t(56), uint64_t(55), uint64_t(54), uint64_t(53), uint64_t(52), uint64_t(51), uint64_t(50), uint64_t(49), uint64_t(48), uint64_t(47), uint64_t(46), uint64_t(45), uint64_t(44), uint64_t(43), uint64_t(42), uint64_t(41), uint64_t(40), uint64_t(39), uint64_t(38), uint64_t(37), uint64_t(36), uint64_t(35), uint64_t(34), uint64_t(33), uint64_t(32), uint64_t(31), uint64_t(30), uint64_t(29), uint64_t(28),uint64_t(27), uint64_t(26), uint64_t(25), uint64_t(24), uint64_t(23), uint64_t(22), uint64_t(21), uint64_t(20), uint64_t(19), uint64_t(18), uint64_t(17), uint64_t(16), uint64_t(15), uint64_t(14), uint64_t(13), uint64_t(12), uint64_t(11), uint64_t(10), uint64_t(9), uint64_t(8), uint64_t(7), uint64_t(6), uint64_t(5), uint64_t(4), uint64_t(3), uint64_t(2), uint64_t(1), uint64_t(0) };
+	#define IntegerMaskTable s_maskTable32
 	#define IntegerInverseShiftTable s_inverseShiftTable32
 #endif
 
@@ -123,6 +126,79 @@ namespace ds
 		return array[i / 32] & (s_one32 << (i & mod32mask));
 	}
 
+	static void resetBit32(uint32_t i, uint32_t* array)
+	{
+		array[i / 32] &= ~(s_one32 << (i & mod32mask));
+	}
+
+	/**
+	Description: 	Counts the set bits of a 64 bit word. Compiles to the popcnt instruction, if the target supports it.
+	Parameter:		x - The word.
+	Result:			The number of set bits in x.
+	Complexity: 	O(1)
+	*/
+	static uint32_t popcount64(uint64_t x)
+	{
+#if __GNUC__
+		return uint32_t(__builtin_popcountll(x));
+#elif _MSC_VER && _WIN64
+		return uint32_t(__popcnt64(x));
+#else
+		x = x - ((x >> 1) & uint64_t(0x5555555555555555));
+		x = (x & uint64_t(0x3333333333333333)) + ((x >> 2) & uint64_t(0x3333333333333333));
+		x = (x + (x >> 4)) & uint64_t(0x0f0f0f0f0f0f0f0f);
+		return uint32_t((x * uint64_t(0x0101010101010101)) >> 56);
+#endif
+	}
+
+	/**
+	Description: 	Returns the index of the lowest set bit of a 64 bit word.
+	Parameter:		x - The word.
+	Preconditions:	x != 0.
+	Result:			The number of trailing zeros of x.
+	Complexity: 	O(1)
+	*/
+	static uint32_t trailingZeros64(uint64_t x)
+	{
+#if __GNUC__
+		return uint32_t(__builtin_ctzll(x));
+#elif _MSC_VER && _WIN64
+		unsigned long index;
+		_BitScanForward64(&index, x);
+		return uint32_t(index);
+#else
+		uint32_t result = 0;
+		while ((x & s_one64) == 0) { x >>= 1; result++; }
+		return result;
+#endif
+	}
+
+	/**
+	Description: 	Returns the position of the r-th set bit (counted from 0) of a 64 bit word. Uses pdep, if the target supports BMI2.
+	Parameter:		x - The word.
+					r - The rank of the desired set bit.
+	Preconditions:	r < popcount64(x).
+	Result:			The index of the r-th set bit in x.
+	Complexity: 	O(1)
+	*/
+	static uint32_t select64(uint64_t x, uint32_t r)
+	{
+#if __BMI2__
+		return trailingZeros64(_pdep_u64(s_one64 << r, x));
+#else
+		uint32_t shift = 0;
+		uint32_t count = popcount64(x & uint64_t(0xffffffff));
+		if (r >= count) { r -= count; shift = 32; }
+		count = popcount64((x >> shift) & uint64_t(0xffff));
+		if (r >= count) { r -= count; shift += 16; }
+		count = popcount64((x >> shift) & uint64_t(0xff));
+		if (r >= count) { r -= count; shift += 8; }
+		x >>= shift;
+		for (uint32_t k = 0; k < r; k++)x &= x - 1;
+		return shift + trailingZeros64(x);
+#endif
+	}
+
 	/**
 	NO TESTED
 	Description: 	Sets the i-th bit in array to a value of 0. If the array is to short, undefined behavior has to be expected.
@@ -381,6 +457,175 @@ namespace ds
 		setBlock32(i, length, block, array);
 #endif
 	}
+
+	/*
+		Compile-time helpers for the bulk kernels "unpack" and "pack". A group of IntegerBitSize elements with t_tau bits each
+		occupies exactly t_tau words, so every word index and shift inside a group is a constant and the straddle test of
+		getBlockEnv is resolved by the compiler instead of being evaluated per element.
+	*/
+	template<Integer t_tau>
+	struct BitPackMask
+	{
+		static const Integer s_value = (~Integer(0)) >> (IntegerBitSize - t_tau);
+	};
+
+	template<Integer t_tau, Integer t_shift, bool t_straddles>
+	struct BitPackWord
+	{
+		static Integer get(const Integer* in)
+		{
+			return (in[0] >> t_shift) & BitPackMask<t_tau>::s_value;
+		}
+
+		static void set(Integer value, Integer* out)
+		{
+			out[0] |= value << t_shift;
+		}
+	};
+
+	template<Integer t_tau, Integer t_shift>
+	struct BitPackWord<t_tau, t_shift, true>
+	{
+		static Integer get(const Integer* in)
+		{
+			return ((in[0] >> t_shift) | (in[1] << (IntegerBitSize - t_shift))) & BitPackMask<t_tau>::s_value;
+		}
+
+		static void set(Integer value, Integer* out)
+		{
+			out[0] |= value << t_shift;
+			out[1] |= value >> (IntegerBitSize - t_shift);
+		}
+	};
+
+	template<Integer t_tau, Integer t_i>
+	struct BitPackGroup
+	{
+		static const Integer s_bit = t_i * t_tau;
+		static const Integer s_word = s_bit / IntegerBitSize;
+		static const Integer s_shift = s_bit & modmask;
+		static const bool s_straddles = s_shift + t_tau > IntegerBitSize;
+
+		static void unpack(const Integer* in, uint64_t* out)
+		{
+			out[t_i] = uint64_t(BitPackWord<t_tau, s_shift, s_straddles>::get(in + s_word));
+			BitPackGroup<t_tau, t_i + 1>::unpack(in, out);
+		}
+
+		static void pack(const uint64_t* in, Integer* out)
+		{
+			BitPackWord<t_tau, s_shift, s_straddles>::set(Integer(in[t_i]) & BitPackMask<t_tau>::s_value, out + s_word);
+			BitPackGroup<t_tau, t_i + 1>::pack(in, out);
+		}
+	};
+
+	template<Integer t_tau>
+	struct BitPackGroup<t_tau, IntegerBitSize>
+	{
+		static void unpack(const Integer*, uint64_t*) {}
+		static void pack(const uint64_t*, Integer*) {}
+	};
+
+	template<Integer t_tau>
+	static Integer unpackSingle(Integer i, const Integer* array)
+	{
+		Integer bit = i * t_tau;
+		Integer start = bit / IntegerBitSize;
+		Integer shift = bit & modmask;
+		Integer lo = array[start] >> shift;
+		Integer hi = shift + t_tau > IntegerBitSize ? array[start + 1] << (IntegerBitSize - shift) : Integer(0);
+		return (hi | lo) & BitPackMask<t_tau>::s_value;
+	}
+
+	template<Integer t_tau>
+	static void packSingle(Integer i, Integer value, Integer* array)
+	{
+		Integer bit = i * t_tau;
+		Integer start = bit / IntegerBitSize;
+		Integer shift = bit & modmask;
+		Integer mask = BitPackMask<t_tau>::s_value;
+		value &= mask;
+		array[start] = (array[start] & ~(mask << shift)) | (value << shift);
+		if (shift + t_tau > IntegerBitSize)
+		{
+			Integer inverseShift = IntegerBitSize - shift;
+			array[start + 1] = (array[start + 1] & ~(mask >> inverseShift)) | (value >> inverseShift);
+		}
+	}
+
+	/**
+	Description: 	Decodes the elements [first, ... , first + n - 1] of a tightly packed array with t_tau bits per element.
+					Elements up to the next multiple of IntegerBitSize are decoded one at a time, then whole groups of
+					IntegerBitSize elements (t_tau words each) are decoded without any data dependent branch.
+	Parameter:		src		- The array in which the blocks are stored.
+					first	- The index of the first element.
+					n		- The number of elements to decode.
+					out		- The destination, receives n values.
+	Preconditions:	1 <= t_tau <= IntegerBitSize. src has to store at least (first + n) * t_tau bits.
+	Postconditions: out[k] is equal to the element first + k for all k in [0, ... , n - 1].
+	Result:			--
+	Complexity: 	This function decodes in O(n) time and with O(1) bits of workspace n elements.
+	*/
+	template<Integer t_tau>
+	static void unpack(const Integer* src, Integer first, Integer n, uint64_t* out)
+	{
+		static_assert(t_tau > 0 && t_tau <= IntegerBitSize, "tau has to be in [1, IntegerBitSize]");
+		Integer last = first + n;
+		Integer groupStart = (first + modmask) & ~modmask;
+		if (groupStart > last) groupStart = last;
+
+		Integer i = first;
+		for (; i < groupStart; i++) *out++ = uint64_t(unpackSingle<t_tau>(i, src));
+		for (; i + IntegerBitSize <= last; i += IntegerBitSize)
+		{
+			BitPackGroup<t_tau, 0>::unpack(src + (i / IntegerBitSize) * t_tau, out);
+			out += IntegerBitSize;
+		}
+		for (; i < last; i++) *out++ = uint64_t(unpackSingle<t_tau>(i, src));
+	}
+
+	/**
+	Description: 	Encodes n values into the elements [first, ... , first + n - 1] of a tightly packed array with t_tau bits per element.
+					Whole groups of IntegerBitSize elements overwrite their t_tau words completely, all other elements are merged
+					into their words, so the neighbouring elements stay untouched.
+	Parameter:		in		- The source, holds n values. Only the lowest t_tau bits of each value are stored.
+					first	- The index of the first element.
+					n		- The number of elements to encode.
+					dst		- The array in which the blocks are stored.
+	Preconditions:	1 <= t_tau <= IntegerBitSize. dst has to store at least (first + n) * t_tau bits.
+	Postconditions: The element first + k is equal to in[k] & (2^t_tau - 1) for all k in [0, ... , n - 1].
+	Result:			--
+	Complexity: 	This function encodes in O(n) time and with O(1) bits of workspace n elements.
+	*/
+	template<Integer t_tau>
+	static void pack(const uint64_t* in, Integer first, Integer n, Integer* dst)
+	{
+		static_assert(t_tau > 0 && t_tau <= IntegerBitSize, "tau has to be in [1, IntegerBitSize]");
+		Integer last = first + n;
+		Integer groupStart = (first + modmask) & ~modmask;
+		if (groupStart > last) groupStart = last;
+
+		Integer i = first;
+		for (; i < groupStart; i++) packSingle<t_tau>(i, Integer(*in++), dst);
+		for (; i + IntegerBitSize <= last; i += IntegerBitSize)
+		{
+			Integer* group = dst + (i / IntegerBitSize) * t_tau;
+			for (Integer w = 0; w < t_tau; w++) group[w] = 0;
+			BitPackGroup<t_tau, 0>::pack(in, group);
+			in += IntegerBitSize;
+		}
+		for (; i < last; i++) packSingle<t_tau>(i, Integer(*in++), dst);
+	}
+
+	typedef void(*UnpackFunction)(const Integer*, Integer, Integer, uint64_t*);
+	typedef void(*PackFunction)(const uint64_t*, Integer, Integer, Integer*);
+
+	/*
+		Dispatch tables for a tau, which is only known at runtime (see Array). Index tau holds the kernel for tau bits, index 0 is unused.
+		The tables are defined in bitmanipulation.cpp, so the kernels are instantiated once and not in every translation unit.
+	*/
+	extern const UnpackFunction s_unpackTable[IntegerBitSize + 1];
+	extern const PackFunction s_packTable[IntegerBitSize + 1];
 }
 
 #endif
@@ -4,15 +4,40 @@
 
 #include "includes.h"
 #include "bitmanipulation.h"
+#include <memory>
+#include <string>
+
+/*
+	Layout of the rank/select directory (see Bitstring::freeze). Every block of RANK_BLOCK_BITS bits owns one 64 bit entry:
+	[0, ... ,31] number of ones in front of the block, [32 + 10s, ... ,41 + 10s] number of ones in the sub-block s (s < 3)
+	of RANK_SUBBLOCK_BITS bits. This costs 64 bits per 2048 bits (3.125%), the select samples add 32 bits per SELECT_SAMPLE_RATE ones (and zeros).
+*/
+#define RANK_BLOCK_BITS 2048
+#define RANK_SUBBLOCK_BITS 512
+#define SELECT_SAMPLE_RATE 8192
 
 namespace ds
 {
+	class MappedFile;
+
 	class Bitstring
 	{
 	private:
 		uint32_t* m_content;
 		uint32_t m_size;
 		uint32_t m_numElements;
+		uint64_t* m_rankDirectory;
+		uint32_t* m_selectSamples;
+		uint32_t* m_selectZeroSamples;
+		uint32_t m_numberOfBlocks;
+		uint32_t m_numberOfSamples;
+		uint32_t m_numberOfZeroSamples;
+		uint32_t m_numberOfOnes;
+		//set, if m_content points into a mapped file (see fileformat.h), m_content is not freed then
+		std::shared_ptr<MappedFile> m_mapping;
+		void releaseContent();
+		uint32_t zerosInFrontOf(uint32_t block) const;
+		void releaseDirectory();
 	public:
 		Bitstring(uint32_t size);
 		~Bitstring();
@@ -23,7 +48,72 @@ namespace ds
 		bool isBitSet(uint32_t i) const;
 		void setBit(uint32_t i);
 		void resetBit(uint32_t i);
+		/**
+		Description: 	Sets bit i with an atomic or, so threads may set bits of the same word concurrently (for example the
+						visited set of a parallel traversal). Unlike setBit the rank/select directory is kept, it is stale
+						afterwards and freeze has to be called before rank and select are used again.
+		Result:			true, if this call changed the bit from unset to set.
+		*/
+		bool testAndSetBit(uint32_t i);
+		/**
+		Description: 	Unsets all bits and drops the rank/select directory.
+		*/
+		void clear();
 		uint32_t numberOfElements() const;
+		/**
+		Description: 	Returns the bits [64j, ... , 64j + 63], bit i of the word is bit 64j + i of the bitstring.
+		Preconditions:	j <= numberOfElements() / 64, bits behind numberOfElements() are unset.
+		*/
+		uint64_t word64(uint32_t j) const;
+		/**
+		Description: 	Builds the rank/select directory. Has to be called again after the bitstring was changed,
+						setBit and resetBit drop the directory.
+		Complexity: 	O(n) time, n / 32 + O(number of ones / SELECT_SAMPLE_RATE) bits of space.
+		*/
+		void freeze();
+		/**
+		Result:			true, if the rank/select directory is built and up to date.
+		*/
+		bool isFrozen() const;
+		/**
+		Description: 	Counts the set bits in [0, ... , i - 1].
+		Preconditions:	isFrozen(), i <= numberOfElements().
+		Complexity: 	O(1), at most 3 directory counts and 8 popcounts.
+		*/
+		uint32_t rank1(uint32_t i) const;
+		/**
+		Description: 	Returns the position of the k-th set bit (counted from 0).
+		Preconditions:	isFrozen().
+		Result:			The position of the k-th set bit, numberOfElements() if there are not more than k set bits.
+		Complexity: 	O(1) for evenly spread ones (one sample, one block), O(log n) in the worst case.
+		*/
+		uint32_t select1(uint32_t k) const;
+		/**
+		Description: 	Returns the position of the k-th unset bit (counted from 0).
+		Preconditions:	isFrozen().
+		Result:			The position of the k-th unset bit, numberOfElements() if there are not more than k unset bits.
+		Complexity: 	See select1.
+		*/
+		uint32_t select0(uint32_t k) const;
+		/**
+		Result:			The number of set bits. Preconditions: isFrozen().
+		*/
+		uint32_t numberOfOnes() const;
+		/**
+		Description: 	Writes the bits as packed file (see fileformat.h) to path. The directory is not stored.
+		Result:			true, if the file was written completely.
+		*/
+		bool save(const std::string& path) const;
+		/**
+		Description: 	Replaces the bits with a packed file, which is mapped copy-on-write (zero-copy, pages are loaded on first
+						access and shared between processes). setBit and resetBit only change the private copy of a page.
+		Parameter:		path	- The file.
+						verify	- Recompute the checksum, this touches every page.
+		Postconditions: !isFrozen(), freeze has to be called again for rank and select.
+		Result:			true on success. false, if the file can not be mapped or is no packed Bitstring, the bitstring is unchanged then.
+		*/
+		bool mapFile(const std::string& path, bool verify = false);
+		bool isMapped() const;
 	};
 };
 
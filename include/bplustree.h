@@ -0,0 +1,507 @@
+#ifndef __BPLUSTREE_H__
+
+#define __BPLUSTREE_H__
+
+#include <new>
+#include "array.h"
+#include "genericBinaryTree.h"
+
+#if __SSE4_2__ || __AVX__
+	#include <nmmintrin.h>
+	#define BPLUSTREE_SSE42 1
+#endif
+
+/*
+	Default node sizes: a leaf (BPLUSTREE_LEAF_WORDS packed words, next pointer and count) and an inner node
+	(BPLUSTREE_INNER_KEYS keys, one child more and the count) both fill exactly 256 bytes = 4 cache lines.
+*/
+#define BPLUSTREE_LEAF_WORDS 30
+#define BPLUSTREE_INNER_KEYS 15
+#define BPLUSTREE_NODE_ALIGNMENT 64
+/*
+	Upper bound for the number of inner levels, with at least 3 children per inner node this is never reached.
+*/
+#define BPLUSTREE_MAX_HEIGHT 40
+
+namespace ds
+{
+	///////////////////////////////////////////////////////////////////////////
+	/// B+-Baum fuer Schluessel mit t_tau Bit. Die Blaetter speichern die
+	/// Schluessel sortiert und dicht gepackt in einem FixedSizeArray mit
+	/// t_leafWords Worten und sind zu einer Liste verkettet, eine Bereichsabfrage
+	/// sucht nur das erste Blatt und laeuft danach sequentiell ueber die Blaetter.
+	/// Die inneren Knoten speichern t_innerKeys ungepackte Trennschluessel, die
+	/// mit SSE4.2 je zwei auf einmal verglichen werden (ohne Spruenge, unbenutzte
+	/// Schluessel sind ~0). Fuer insert, remove und Bereichsabfragen wird ein
+	/// Blatt mit unpack am Stueck dekodiert und ebenso gezaehlt, contains sucht
+	/// binaer in den gepackten Worten.
+	/// Gleiche Schluessel sind erlaubt. remove gleicht nicht aus: Blaetter koennen
+	/// unterbesetzt oder leer sein, die Hoehe waechst nur durch insert.
+	/// Die Schnittstelle fuer Bereichsabfragen (rangeQuery, foreachInRange,
+	/// foreach) entspricht der von BinaryTree<Integer>.
+	///////////////////////////////////////////////////////////////////////////
+	template<Integer t_tau, Integer t_leafWords = BPLUSTREE_LEAF_WORDS, Integer t_innerKeys = BPLUSTREE_INNER_KEYS>
+	class BPlusTree
+	{
+		static_assert(t_tau > 0 && t_tau <= IntegerBitSize, "tau has to be in [1, IntegerBitSize]");
+		static_assert(t_innerKeys >= 2, "an inner node needs at least 3 children");
+	private:
+		static const Integer s_leafCapacity = t_leafWords * IntegerBitSize / t_tau;
+		static_assert(s_leafCapacity >= 2, "a leaf has to hold at least 2 keys");
+
+		struct LeafNode
+		{
+			FixedSizeArray<t_leafWords, t_tau> m_keys;
+			LeafNode* m_next;
+			Integer m_count;
+		};
+
+		struct InnerNode
+		{
+			/// Trennschluessel: alle Schluessel in m_children[i] liegen in [m_keys[i - 1], m_keys[i]]
+			Integer m_keys[t_innerKeys];
+			void* m_children[t_innerKeys + 1];
+			Integer m_count;
+		};
+
+		/// Blatt, wenn m_height == 0, sonst InnerNode
+		void* m_root;
+		/// Anzahl der Ebenen innerer Knoten
+		Integer m_height;
+		Integer m_size;
+		Integer m_leaves;
+		Integer m_innerNodes;
+
+		BPlusTree(const BPlusTree& other) = delete;
+		BPlusTree& operator=(const BPlusTree& other) = delete;
+
+		template<typename N>
+		static N* allocateNode()
+		{
+			Integer bytes = (sizeof(N) + BPLUSTREE_NODE_ALIGNMENT - 1) & ~Integer(BPLUSTREE_NODE_ALIGNMENT - 1);
+			return new (aligned_alloc(BPLUSTREE_NODE_ALIGNMENT, bytes)) N();
+		}
+
+		template<typename N>
+		static void releaseNode(N* node)
+		{
+			node->~N();
+			free(node);
+		}
+
+		LeafNode* newLeaf()
+		{
+			LeafNode* leaf = allocateNode<LeafNode>();
+			leaf->m_next = nullptr;
+			leaf->m_count = 0;
+			m_leaves++;
+			return leaf;
+		}
+
+		InnerNode* newInner()
+		{
+			InnerNode* inner = allocateNode<InnerNode>();
+			for (Integer i = 0; i < t_innerKeys; i++)inner->m_keys[i] = ~Integer(0);
+			for (Integer i = 0; i <= t_innerKeys; i++)inner->m_children[i] = nullptr;
+			inner->m_count = 0;
+			m_innerNodes++;
+			return inner;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Zaehlt die Schluessel < x (t_orEqual: <= x) unter keys[0, ... , n - 1].
+		/// Die Schleife hat keine datenabhaengigen Spruenge.
+		/////////////////////////////////////////////////////////////////////////////
+		template<bool t_orEqual>
+		static Integer countBelow(const uint64_t* keys, Integer n, Integer x)
+		{
+			Integer i = 0;
+			Integer result = 0;
+#ifdef BPLUSTREE_SSE42
+			//_mm_cmpgt_epi64 vergleicht vorzeichenbehaftet, das Vorzeichenbit wird daher umgedreht
+			const __m128i sign = _mm_set1_epi64x(int64_t(s_one64 << 63));
+			const __m128i value = _mm_xor_si128(_mm_set1_epi64x(int64_t(x)), sign);
+			__m128i sum = _mm_setzero_si128();
+			for (; i + 2 <= n; i += 2)
+			{
+				__m128i v = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i)), sign);
+				//t_orEqual: key <= x <=> !(key > x), gezaehlt wird dann key > x
+				__m128i mask = t_orEqual ? _mm_cmpgt_epi64(v, value) : _mm_cmpgt_epi64(value, v);
+				sum = _mm_sub_epi64(sum, mask);
+			}
+			uint64_t lanes[2];
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), sum);
+			result = t_orEqual ? i - Integer(lanes[0] + lanes[1]) : Integer(lanes[0] + lanes[1]);
+#endif
+			for (; i < n; i++)result += t_orEqual ? Integer(keys[i] <= x) : Integer(keys[i] < x);
+			return result;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Index des Kindes, in dem die Suche nach x weiterlaeuft. Es werden immer
+		/// alle t_innerKeys Schluessel verglichen, die unbenutzten (~0) werden
+		/// danach abgeschnitten.
+		/////////////////////////////////////////////////////////////////////////////
+		template<bool t_orEqual>
+		static Integer childIndex(const InnerNode* inner, Integer x)
+		{
+			Integer c = countBelow<t_orEqual>(reinterpret_cast<const uint64_t*>(inner->m_keys), t_innerKeys, x);
+			return c < inner->m_count ? c : inner->m_count;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Steigt zum Blatt ab, in dem x (t_orEqual = false: das erste Vorkommen,
+		/// sonst die Position hinter dem letzten Vorkommen) liegen muss.
+		/// path/slots nehmen den Weg auf, falls angegeben.
+		/////////////////////////////////////////////////////////////////////////////
+		template<bool t_orEqual>
+		LeafNode* descend(Integer x, InnerNode** path, Integer* slots) const
+		{
+			void* node = m_root;
+			for (Integer level = 0; level < m_height; level++)
+			{
+				InnerNode* inner = static_cast<InnerNode*>(node);
+				Integer c = childIndex<t_orEqual>(inner, x);
+				if (path)
+				{
+					path[level] = inner;
+					slots[level] = c;
+				}
+				node = inner->m_children[c];
+			}
+			return static_cast<LeafNode*>(node);
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Wie descend, aber mit der Grenze min einer Bereichsabfrage: es wird das
+		/// erste Kind gesucht, dessen Trennschluessel nicht kleiner als min ist.
+		/// Die Grenze ist nur ueber virtuelle Methoden erreichbar, daher binaere
+		/// Suche statt SIMD.
+		/////////////////////////////////////////////////////////////////////////////
+		static bool notBelow(const std::shared_ptr<RangeBorder<Integer>>& min, Integer key)
+		{
+			return min->greaterThen(key) || min->equals(key);
+		}
+
+		template<typename P>
+		static Integer firstMatching(const uint64_t* keys, Integer n, P predicate)
+		{
+			Integer low = 0;
+			while (n > 0)
+			{
+				Integer half = n / 2;
+				if (predicate(Integer(keys[low + half])))
+				{
+					n = half;
+				}
+				else
+				{
+					low += half + 1;
+					n -= half + 1;
+				}
+			}
+			return low;
+		}
+
+		LeafNode* descend(const std::shared_ptr<RangeBorder<Integer>>& min) const
+		{
+			void* node = m_root;
+			for (Integer level = 0; level < m_height; level++)
+			{
+				InnerNode* inner = static_cast<InnerNode*>(node);
+				Integer c = firstMatching(reinterpret_cast<const uint64_t*>(inner->m_keys), inner->m_count, [&](Integer key) { return notBelow(min, key); });
+				node = inner->m_children[c];
+			}
+			return static_cast<LeafNode*>(node);
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Laeuft ab Position pos von leaf ueber die verketteten Blaetter und ruft
+		/// visit fuer jeden Schluessel auf, bis visit false liefert. Jedes Blatt
+		/// wird am Stueck dekodiert, das naechste wird vorab geladen.
+		/////////////////////////////////////////////////////////////////////////////
+		template<typename V>
+		static void scan(const LeafNode* leaf, Integer pos, uint64_t* buffer, V visit)
+		{
+			while (leaf)
+			{
+				if (leaf->m_next)TREE_PREFETCH(leaf->m_next);
+				for (; pos < leaf->m_count; pos++)
+				{
+					if (!visit(Integer(buffer[pos])))return;
+				}
+				leaf = leaf->m_next;
+				pos = 0;
+				if (leaf)leaf->m_keys.getRange(0, leaf->m_count, buffer);
+			}
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Startpunkt einer Bereichsabfrage mit der Grenze min: das Blatt und die
+		/// Position des ersten Schluessels >= min, buffer enthaelt das dekodierte Blatt.
+		/////////////////////////////////////////////////////////////////////////////
+		const LeafNode* lowerBound(const std::shared_ptr<RangeBorder<Integer>>& min, Integer& pos, uint64_t* buffer) const
+		{
+			const LeafNode* leaf = descend(min);
+			leaf->m_keys.getRange(0, leaf->m_count, buffer);
+			pos = firstMatching(buffer, leaf->m_count, [&](Integer key) { return notBelow(min, key); });
+			return leaf;
+		}
+
+		const LeafNode* lowerBound(Integer min, Integer& pos, uint64_t* buffer) const
+		{
+			const LeafNode* leaf = descend<false>(min, nullptr, nullptr);
+			leaf->m_keys.getRange(0, leaf->m_count, buffer);
+			pos = countBelow<false>(buffer, leaf->m_count, min);
+			return leaf;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Fuegt nach der Teilung eines Knotens auf Ebene level - 1 den
+		/// Trennschluessel key und den neuen rechten Knoten right in den Vorgaenger
+		/// ein und teilt diesen bei Bedarf ebenfalls.
+		/////////////////////////////////////////////////////////////////////////////
+		void insertSeparator(InnerNode** path, Integer* slots, Integer level, Integer key, void* right)
+		{
+			while (level > 0)
+			{
+				level--;
+				InnerNode* inner = path[level];
+				Integer c = slots[level];
+				Integer keys[t_innerKeys + 1];
+				void* children[t_innerKeys + 2];
+				Integer n = inner->m_count;
+				for (Integer i = 0; i < c; i++)keys[i] = inner->m_keys[i];
+				keys[c] = key;
+				for (Integer i = c; i < n; i++)keys[i + 1] = inner->m_keys[i];
+				for (Integer i = 0; i <= c; i++)children[i] = inner->m_children[i];
+				children[c + 1] = right;
+				for (Integer i = c + 1; i <= n; i++)children[i + 1] = inner->m_children[i];
+				n++;
+
+				if (n <= t_innerKeys)
+				{
+					for (Integer i = 0; i < n; i++)inner->m_keys[i] = keys[i];
+					for (Integer i = 0; i <= n; i++)inner->m_children[i] = children[i];
+					inner->m_count = n;
+					return;
+				}
+
+				//der mittlere Schluessel wandert nach oben, beim Anhaengen am Ende bleibt der Knoten fast voll
+				Integer middle = c == n - 1 ? n - 2 : n / 2;
+				InnerNode* sibling = newInner();
+				for (Integer i = 0; i < t_innerKeys; i++)inner->m_keys[i] = ~Integer(0);
+				for (Integer i = 0; i < middle; i++)inner->m_keys[i] = keys[i];
+				for (Integer i = 0; i <= middle; i++)inner->m_children[i] = children[i];
+				for (Integer i = middle + 1; i <= t_innerKeys; i++)inner->m_children[i] = nullptr;
+				inner->m_count = middle;
+				for (Integer i = middle + 1; i < n; i++)sibling->m_keys[i - middle - 1] = keys[i];
+				for (Integer i = middle + 1; i <= n; i++)sibling->m_children[i - middle - 1] = children[i];
+				sibling->m_count = n - middle - 1;
+				key = keys[middle];
+				right = sibling;
+			}
+
+			InnerNode* root = newInner();
+			root->m_keys[0] = key;
+			root->m_children[0] = m_root;
+			root->m_children[1] = right;
+			root->m_count = 1;
+			m_root = root;
+			m_height++;
+		}
+
+		void release(void* node, Integer level)
+		{
+			if (level == m_height)
+			{
+				releaseNode(static_cast<LeafNode*>(node));
+				return;
+			}
+			InnerNode* inner = static_cast<InnerNode*>(node);
+			for (Integer i = 0; i <= inner->m_count; i++)release(inner->m_children[i], level + 1);
+			releaseNode(inner);
+		}
+	public:
+		BPlusTree() : m_root(nullptr), m_height(0), m_size(0), m_leaves(0), m_innerNodes(0)
+		{
+			m_root = newLeaf();
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Gibt alle Knoten frei, die Rekursionstiefe ist die Hoehe des Baums.
+		/////////////////////////////////////////////////////////////////////////////
+		~BPlusTree() { release(m_root, 0); }
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Anzahl der Elemente, O(1).
+		/////////////////////////////////////////////////////////////////////////////
+		Integer size() const { return m_size; }
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Anzahl der Ebenen innerer Knoten (0, solange alles in ein Blatt passt).
+		/////////////////////////////////////////////////////////////////////////////
+		Integer height() const { return m_height; }
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Anzahl der Schluessel pro Blatt.
+		/////////////////////////////////////////////////////////////////////////////
+		static Integer leafCapacity() { return s_leafCapacity; }
+
+		Integer byteSize() const { return sizeof(*this) + m_leaves * sizeof(LeafNode) + m_innerNodes * sizeof(InnerNode); }
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Fuegt key ein (nur die unteren t_tau Bit werden gespeichert). Gleiche
+		/// Schluessel werden hinter die vorhandenen einsortiert. O(log n) Knoten,
+		/// ein volles Blatt wird in zwei halbe Blaetter geteilt.
+		/////////////////////////////////////////////////////////////////////////////
+		void insert(Integer key)
+		{
+			key &= BitPackMask<t_tau>::s_value;
+			InnerNode* path[BPLUSTREE_MAX_HEIGHT];
+			Integer slots[BPLUSTREE_MAX_HEIGHT];
+			LeafNode* leaf = descend<true>(key, path, slots);
+
+			uint64_t buffer[s_leafCapacity + 1];
+			Integer n = leaf->m_count;
+			leaf->m_keys.getRange(0, n, buffer);
+			Integer pos = countBelow<true>(buffer, n, key);
+			for (Integer i = n; i > pos; i--)buffer[i] = buffer[i - 1];
+			buffer[pos] = uint64_t(key);
+			n++;
+			m_size++;
+
+			if (n <= s_leafCapacity)
+			{
+				leaf->m_keys.setRange(pos, n - pos, buffer + pos);
+				leaf->m_count = n;
+				return;
+			}
+
+			//wird am Ende des letzten Blatts angehaengt (sortierte Eingabe), bleibt das Blatt voll
+			Integer half = pos == n - 1 && !leaf->m_next ? n - 1 : n / 2;
+			LeafNode* sibling = newLeaf();
+			sibling->m_keys.setRange(0, n - half, buffer + half);
+			sibling->m_count = n - half;
+			sibling->m_next = leaf->m_next;
+			leaf->m_keys.setRange(pos, half > pos ? half - pos : 0, buffer + pos);
+			leaf->m_count = half;
+			leaf->m_next = sibling;
+			insertSeparator(path, slots, m_height, Integer(buffer[half]), sibling);
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Entfernt ein Vorkommen von key. Das Blatt wird nicht mit seinen Nachbarn
+		/// zusammengelegt.
+		/// \return true, wenn ein Element entfernt wurde.
+		/////////////////////////////////////////////////////////////////////////////
+		bool remove(Integer key)
+		{
+			uint64_t buffer[s_leafCapacity];
+			Integer pos;
+			LeafNode* leaf = const_cast<LeafNode*>(lowerBound(key, pos, buffer));
+			//das erste Vorkommen kann nach leeren Blaettern im naechsten Blatt liegen
+			while (leaf && pos == leaf->m_count)
+			{
+				leaf = leaf->m_next;
+				pos = 0;
+				if (leaf)leaf->m_keys.getRange(0, leaf->m_count, buffer);
+			}
+			if (!leaf || Integer(buffer[pos]) != key)return false;
+			Integer n = leaf->m_count - 1;
+			leaf->m_keys.setRange(pos, n - pos, buffer + pos + 1);
+			leaf->m_count = n;
+			m_size--;
+			return true;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Prueft, ob key enthalten ist. O(log n), pro Ebene ein Knoten.
+		/////////////////////////////////////////////////////////////////////////////
+		bool contains(Integer key) const
+		{
+			//ein einzelner Schluessel: binaere Suche direkt auf den gepackten Worten statt das Blatt zu dekodieren,
+			//jeder Schluessel wird mit demselben Kern (unpackSingle) gelesen wie beim Dekodieren des Blatts
+			const LeafNode* leaf = descend<false>(key, nullptr, nullptr);
+			Integer low = 0;
+			Integer n = leaf->m_count;
+			uint64_t current;
+			while (n > 0)
+			{
+				Integer half = n / 2;
+				leaf->m_keys.getRange(low + half, 1, &current);
+				bool below = Integer(current) < key;
+				low = below ? low + half + 1 : low;
+				n = below ? n - half - 1 : half;
+			}
+			while (leaf && low == leaf->m_count)
+			{
+				leaf = leaf->m_next;
+				low = 0;
+			}
+			if (!leaf)return false;
+			leaf->m_keys.getRange(low, 1, &current);
+			return Integer(current) == key;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Gibt alle Elemente im Intervall [min,max] sortiert zurueck (min und max
+		/// inklusive), wie BinaryTree::rangeQuery.
+		/////////////////////////////////////////////////////////////////////////////
+		std::vector<Integer> rangeQuery(std::shared_ptr<RangeBorder<Integer>> min, std::shared_ptr<RangeBorder<Integer>> max) const
+		{
+			std::vector<Integer> result;
+			uint64_t buffer[s_leafCapacity];
+			Integer pos;
+			const LeafNode* leaf = lowerBound(min, pos, buffer);
+			scan(leaf, pos, buffer, [&](Integer e) { if (max->greaterThen(e))return false; result.push_back(e); return true; });
+			return result;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Wie oben mit festen Grenzen, dann wird auch der Abstieg mit SIMD gesucht.
+		/////////////////////////////////////////////////////////////////////////////
+		std::vector<Integer> rangeQuery(Integer min, Integer max) const
+		{
+			std::vector<Integer> result;
+			uint64_t buffer[s_leafCapacity];
+			Integer pos;
+			const LeafNode* leaf = lowerBound(min, pos, buffer);
+			scan(leaf, pos, buffer, [&](Integer e) { if (e > max)return false; result.push_back(e); return true; });
+			return result;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Ruft func fuer alle Elemente im Intervall [min,max] in sortierter
+		/// Reihenfolge auf.
+		/////////////////////////////////////////////////////////////////////////////
+		void foreachInRange(std::shared_ptr<ChangeStrategie<Integer>> func, std::shared_ptr<RangeBorder<Integer>> min, std::shared_ptr<RangeBorder<Integer>> max) const
+		{
+			uint64_t buffer[s_leafCapacity];
+			Integer pos;
+			const LeafNode* leaf = lowerBound(min, pos, buffer);
+			scan(leaf, pos, buffer, [&](Integer e) { if (max->greaterThen(e))return false; func->change(e); return true; });
+		}
+
+		void foreachInRange(std::shared_ptr<ChangeStrategie<Integer>> func, Integer min, Integer max) const
+		{
+			uint64_t buffer[s_leafCapacity];
+			Integer pos;
+			const LeafNode* leaf = lowerBound(min, pos, buffer);
+			scan(leaf, pos, buffer, [&](Integer e) { if (e > max)return false; func->change(e); return true; });
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Ruft func fuer jedes Element in sortierter Reihenfolge auf.
+		/////////////////////////////////////////////////////////////////////////////
+		void foreach(std::shared_ptr<ChangeStrategie<Integer>> func) const
+		{
+			uint64_t buffer[s_leafCapacity];
+			Integer pos;
+			const LeafNode* leaf = lowerBound(Integer(0), pos, buffer);
+			scan(leaf, pos, buffer, [&](Integer e) { func->change(e); return true; });
+		}
+	}; //!BPlusTree
+}
+
+#endif // !__BPLUSTREE_H__
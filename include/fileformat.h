@@ -0,0 +1,107 @@
+#ifndef __FILEFORMAT_H__
+
+#define __FILEFORMAT_H__
+
+#include <stdint.h>
+#include <string>
+#include <memory>
+
+/*
+	Version of the on-disk format, files with another version are rejected.
+*/
+#define PACKED_FILE_VERSION 1
+#define PACKED_FILE_ALIGNMENT 64
+
+namespace ds
+{
+	/**
+	The data structures, which can be stored in a packed file.
+	*/
+	enum class PackedFileType : uint32_t
+	{
+		Array = 1,
+		Bitstring = 2,
+		ArrayType = 3
+	};
+
+	/**
+	Header of a packed file. The payload (the raw words of the data structure) starts directly behind the header at
+	byte PACKED_FILE_ALIGNMENT, so it keeps the cache line alignment of the mapped pages. The file is padded to a multiple
+	of PACKED_FILE_ALIGNMENT bytes.
+	*/
+	struct PackedFileHeader
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t type;
+		uint32_t wordBytes;
+		uint32_t reserved;
+		uint64_t tau;
+		uint64_t numberOfElements;
+		uint64_t payloadBytes;
+		uint64_t checksum;
+		uint64_t padding;
+	};
+
+	/**
+	A read only file, which is mapped copy-on-write into the address space: pages are shared with every other process
+	mapping the same file, until they are written. The mapping is released by the destructor.
+	*/
+	class MappedFile
+	{
+	private:
+		uint8_t* m_data;
+		uint64_t m_size;
+#if _WIN32 || _WIN64
+		void* m_file;
+		void* m_mapping;
+#endif
+		MappedFile(const MappedFile& other) = delete;
+		MappedFile& operator=(const MappedFile& other) = delete;
+	public:
+		MappedFile();
+		~MappedFile();
+		/**
+		Description: 	Maps the file at path.
+		Result:			true, if the file could be opened and mapped, false otherwise.
+		*/
+		bool open(const std::string& path);
+		uint8_t* data() const;
+		uint64_t size() const;
+	};
+
+	/**
+	Description: 	Checksum over the payload of a packed file (multiplicative hash over 64 bit words, FNV-1a over the remaining bytes).
+	Parameter:		data	- The payload.
+					bytes	- The length of the payload in bytes.
+	Result:			The 64 bit checksum.
+	Complexity: 	O(bytes).
+	*/
+	uint64_t packedFileChecksum(const void* data, uint64_t bytes);
+
+	/**
+	Description: 	Writes header and payload to path. An existing file is overwritten.
+	Parameter:		path				- The file.
+					type				- The type of the data structure.
+					wordBytes			- The size of one word of the payload (sizeof(Integer), sizeof(uint32_t), ...).
+					tau					- The bitlength of the elements.
+					numberOfElements	- The number of elements.
+					payload				- The raw words.
+					payloadBytes		- The length of the payload in bytes.
+	Result:			true, if the file was written completely, false otherwise.
+	*/
+	bool writePackedFile(const std::string& path, PackedFileType type, uint32_t wordBytes, uint64_t tau, uint64_t numberOfElements, const void* payload, uint64_t payloadBytes);
+
+	/**
+	Description: 	Maps a packed file and validates its header.
+	Parameter:		path		- The file.
+					type		- The expected type.
+					wordBytes	- The expected word size.
+					header		- Receives the header.
+					verify		- Recompute the checksum. This reads every page of the payload, so it is off for a zero-copy startup.
+	Result:			The mapping, the payload starts at data() + PACKED_FILE_ALIGNMENT. nullptr, if the file can not be mapped or does not match.
+	*/
+	std::shared_ptr<MappedFile> mapPackedFile(const std::string& path, PackedFileType type, uint32_t wordBytes, PackedFileHeader& header, bool verify);
+};
+
+#endif // !__FILEFORMAT_H__
@@ -2,7 +2,18 @@
 
 #define __GENERIC_BINARYTREE_H__
 
+#include <iterator>
 #include "includes.h"
+#include "bitmanipulation.h"
+#include "pointerintegertype.h"
+#include "nodearena.h"
+#include "threadpool.h"
+
+#if __GNUC__
+	#define TREE_PREFETCH(x) __builtin_prefetch(x)
+#else
+	#define TREE_PREFETCH(x) _mm_prefetch((const char*)(x), _MM_HINT_T0)
+#endif
 
 namespace ds
 {
@@ -85,11 +96,13 @@ namespace ds
 	///////////////////////////////////////////////////////////////////////////
 	/// Binaerer Suchbaum. Rekursove Datenstruktur. Der Baum kann im ersten
 	/// Parameter beliebig typisiert werden. Im zweiten Parameter muss ein
-	/// NodeVompoerator angegeben werden!
+	/// NodeVompoerator angegeben werden! Der dritte Parameter ist der Allokator
+	/// fuer die Knoten (HeapNodeAllocator oder NodeArena, siehe nodearena.h).
 	///////////////////////////////////////////////////////////////////////////
 	template<
 			typename F, 
 			typename H = DefaultNodeComperator<F>, 
+			typename A = HeapNodeAllocator,
 			typename std::enable_if<std::is_base_of<DefaultNodeComperator<F>,H>::value>::type* = nullptr
 	>
 	class BinaryTree
@@ -118,22 +131,9 @@ namespace ds
 			TreeNode(E content, G comparator) { m_content = content; m_comparator = comparator; m_left = nullptr; m_right = nullptr; m_parent = nullptr; }
 			
 			///////////////////////////////////////////////////////////////////
-			/// Der Inhalt MUSS geloescht werden, bevor ein Knoten geloescht wird
-			/// Der Knoten loescht seine Kinder nur mit, wenn diese nicht nullptr
-			/// sind.
+			/// Die Knoten werden vom Baum ueber seinen Allokator freigegeben 
+			/// (siehe BinaryTree::release), ein Knoten loescht seine Kinder nicht.
 			///////////////////////////////////////////////////////////////////
-			~TreeNode()
-			{
-				if (m_left)
-				{
-					delete m_left;
-				}
-				if (m_right)
-				{
-					delete m_right;
-				}
-
-			}
 
 			///////////////////////////////////////////////////////////////////
 			/// Gibt an, ob der Knoten ein Blattknoten ist.
@@ -144,119 +144,6 @@ namespace ds
 				return m_left == nullptr && m_right == nullptr;
 			}
 
-			///////////////////////////////////////////////////////////////////
-			/// Fuegt dem Baum einen neuen Inhalt hinzu. Der neue Knoten erhaelt den 
-			/// Standard-Comparator, der fuer diese Instanz festgelegt ist.
-			/// \param content - ein neues Element, das dem Baum hinzugefuert wird.
-			///////////////////////////////////////////////////////////////////
-			void insert(E content)
-			{
-				bool isLeaf1 = isLeaf();
-				if (
-					(isLeaf1 || !m_left) && 
-					!m_comparator.greaterThen(content, m_content) && 
-					!m_comparator.equals(content, m_content)
-					)
-				{
-					//linkes kind erzeugen
-					m_left = new TreeNode<E, G>(content);
-					m_left->m_parent = this;
-				}
-				else if (
-					(isLeaf1 || !m_right) && 
-						(m_comparator.greaterThen(content, m_content) ||
-						m_comparator.equals(content, m_content))
-					)
-				{
-					//rechtes kind erzeugen
-					m_right = new TreeNode<E, G>(content);
-					m_right->m_parent = this;
-				}
-				else if (
-					!m_comparator.greaterThen(content, m_content) &&
-					!m_comparator.equals(content, m_content)
-					)
-				{
-					//einfuegen im linken kind
-					m_left->insert(content);
-				}
-				else
-				{
-					//einfuegen im rechten kind
-					m_right->insert(content);
-				}
-			}
-			///////////////////////////////////////////////////////////////////
-			/// Fuegt dem Baum einen neuen Inhalt hinzu. Der neue Knoten erhaelt den 
-			/// uebergebenen Comparator, der fuer diese Instanz festgelegt ist.
-			/// \param content - ein neues Element, das dem Baum hinzugefuert wird.
-			/// param comparator - Der Comparator, der dem Knoten zugewiesen werden soll.
-			///////////////////////////////////////////////////////////////////
-			void insert(E content, G comparator)
-			{
-				bool isLeaf1 = isLeaf();
-				if (
-					(isLeaf1 || !m_left) &&
-					!m_comparator.greaterThen(content, m_content) &&
-					!m_comparator.equals(content, m_content)
-					)
-				{
-					//linkes kind erzeugen
-					m_left = new TreeNode<E, G>(content, comparator);
-					m_left->m_parent = this;
-				}
-				else if (
-					(isLeaf1 || !m_right) &&
-					(m_comparator.greaterThen(content, m_content) ||
-						m_comparator.equals(content, m_content))
-					)
-				{
-					//rechtes kind erzeugen
-					m_right = new TreeNode<E, G>(content, comparator);
-					m_right->m_parent = this;
-				}
-				else if (
-					!m_comparator.greaterThen(content, m_content) &&
-					!m_comparator.equals(content, m_content)
-					)
-				{
-					//einfuegen im linken kind
-					m_left->insert(content);
-				}
-				else
-				{
-					//einfuegen im rechten kind
-					m_right->insert(content);
-				}
-			}
-
-			///////////////////////////////////////////////////////////////////
-			/// Haengt dem Baum einen weiteren Baum an der passenden Stelle an.
-			/// \param t - ein Baum, der der aufgerufenen Instanz t anhaengt. (Union)
-			///////////////////////////////////////////////////////////////////
-			void insert(TreeNode<E, G>* t)
-			{
-				bool greaterThen = m_comparator.greaterThen(t->m_content, m_content);
-				bool equal = m_comparator.equals(t->m_content, m_content);
-
-				if (!m_left && !greaterThen && !equal)
-				{
-					m_left = t;
-				}
-				else if (m_left && !greaterThen && !equal)
-				{
-					m_left->insert(t);
-				}
-				else if (!m_right && (greaterThen || equal))
-				{
-					m_right = t;
-				}
-				else if (m_right && (greaterThen || equal))
-				{
-					m_right->insert(t);
-				}
-			}
-
 			///////////////////////////////////////////////////////////////////
 			/// Prueft, ob content in irgendeinem Knoten vorhanden ist.
 			/// \param content - Inhalt, nach dem gesucht wird.
@@ -297,16 +184,6 @@ namespace ds
 				}
 			}
 
-			///////////////////////////////////////////////////////////////////
-			/// Entfernt einen Knoten aus dem Baum. Der Destruktor des Inhalts 
-			/// wird NICHT aufgerufen.
-			/// \param content - der Inhalt anhand dessen ein Knoten geloescht wird.
-			///////////////////////////////////////////////////////////////////
-			void remove(E content)
-			{
-				removePriv(content);
-			}
-
 			///////////////////////////////////////////////////////////////////
 			/// Berechnet die Anzahl der im Baum vorhanden Elemente.
 			///////////////////////////////////////////////////////////////////
@@ -363,178 +240,361 @@ namespace ds
 				return m_content;
 			}
 
-			///////////////////////////////////////////////////////////////////
-			/// Gibt alle Elemente im Intervall [min,max] zurueck. (min und max inklusive)
-			/// \param min - die untere Grenze fuer diese Suche
-			/// \param max - die obere Grenze fuer diese Suche.
-			///////////////////////////////////////////////////////////////////
-			std::vector<E> rangeQuery(std::shared_ptr<RangeBorder<E>> min, std::shared_ptr<RangeBorder<E>> max)
-			{
-				bool contentGreaterThanMin = min->greaterThen(m_content);
-				bool contentEqualsMin = min->equals(m_content);
-				bool contentGreaterThanMax = max->greaterThen(m_content);
-				bool contentEqualsMax = max->equals(m_content);
+			/// Elternknoten
+			TreeNode<E, G>* m_parent;
+			/// Kindknoten
+			TreeNode<E, G>* m_left;
+			TreeNode<E, G>* m_right;
+			/// Inhalt
+			E m_content;
+			/// Comparator
+			G m_comparator;
+		private:
 
-				std::vector<E> result;
+		}; //!TreeNode
+		/// Wurzelknoten
+		TreeNode<F, H>* m_node;
+		//std::vector<TreeNode<F, H>> m_treeNodes;
+		/// Inhalte in Eytzinger-Reihenfolge (Breitensuche: Kinder von k liegen
+		/// bei 2k und 2k + 1), Index 0 ist unbenutzt. Leer, solange der Baum
+		/// nicht eingefroren ist.
+		std::vector<F> m_frozen;
+		/// Comparator fuer die Suche im eingefrorenen Layout
+		H m_comparator;
+		/// Allokator der Knoten
+		A m_allocator;
 
-				//wenn m_content groesser min, dann weiter von links sammeln
-				if (contentGreaterThanMin && m_left)
+		TreeNode<F, H>* createNode(F content) { return new (m_allocator.allocate()) TreeNode<F, H>(content); }
+		TreeNode<F, H>* createNode(F content, H comparator) { return new (m_allocator.allocate()) TreeNode<F, H>(content, comparator); }
+
+		void destroyNode(TreeNode<F, H>* node)
+		{
+			node->~TreeNode<F, H>();
+			m_allocator.deallocate(node);
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Haengt den neuen Knoten node ohne Rekursion an der passenden Stelle ein,
+		/// auf dem Weg entscheidet der Comparator des jeweiligen Knotens. Gleiche 
+		/// Inhalte gehen nach rechts.
+		/////////////////////////////////////////////////////////////////////////////
+		void attach(TreeNode<F, H>* node)
+		{
+			if (!m_node)
+			{
+				m_node = node;
+				return;
+			}
+			TreeNode<F, H>* parent = m_node;
+			while (true)
+			{
+				bool right = parent->m_comparator.greaterThen(node->m_content, parent->m_content) || parent->m_comparator.equals(node->m_content, parent->m_content);
+				TreeNode<F, H>*& child = right ? parent->m_right : parent->m_left;
+				if (!child)
 				{
-					std::vector<E> leftResult = m_left->rangeQuery(min, max);
-					for (auto it : leftResult) result.push_back(it);
+					child = node;
+					node->m_parent = parent;
+					return;
 				}
-				//wenn min/max im intervall liegt, m_content mit aufnehmen
-				if ((contentEqualsMin || contentEqualsMax) || (contentGreaterThanMin && !contentGreaterThanMax))
+				parent = child;
+			}
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Gibt alle Knoten frei (ohne Rekursion). Haelt der Allokator die Knoten
+		/// selbst zusammen (NodeArena) und haben sie keinen Destruktor, gibt der
+		/// Allokator sie am Stueck frei und der Baum muss sie nicht besuchen.
+		/// \param reuse - Der Baum wird weiter benutzt: die Knoten gehen immer an
+		/// den Allokator zurueck, damit er sie wieder vergeben kann.
+		/////////////////////////////////////////////////////////////////////////////
+		void release(bool reuse = false)
+		{
+			if (reuse || !(A::s_bulkRelease && std::is_trivially_destructible<TreeNode<F, H>>::value))
+			{
+				std::vector<TreeNode<F, H>*> stack;
+				if (m_node)stack.push_back(m_node);
+				while (!stack.empty())
 				{
-					result.push_back(m_content);
+					TreeNode<F, H>* node = stack.back();
+					stack.pop_back();
+					if (node->m_left)stack.push_back(node->m_left);
+					if (node->m_right)stack.push_back(node->m_right);
+					destroyNode(node);
 				}
-				//wenn m_content nicht groesser (kleiner) max ist, weiter rechts sammeln
-				if (!contentEqualsMax && !contentGreaterThanMax && m_right)
+			}
+			m_node = nullptr;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Schreibt die Inhalte sortiert (inorder, ohne Rekursion) nach sorted.
+		/////////////////////////////////////////////////////////////////////////////
+		void collect(std::vector<F>& sorted)
+		{
+			std::vector<TreeNode<F, H>*> stack;
+			TreeNode<F, H>* node = m_node;
+			while (node || !stack.empty())
+			{
+				while (node)
 				{
-					std::vector<E> rightResult = m_right->rangeQuery(min, max);
-					for (auto it : rightResult) result.push_back(it);
+					stack.push_back(node);
+					node = node->m_left;
 				}
-				return result;
+				node = stack.back();
+				stack.pop_back();
+				sorted.push_back(node->m_content);
+				node = node->m_right;
 			}
+		}
 
-			///////////////////////////////////////////////////////////////////
-			/// Siehe remove.
-			///////////////////////////////////////////////////////////////////
-			void removePriv(E content)
+		/////////////////////////////////////////////////////////////////////////////
+		/// Belegt den Teilbaum k des Eytzinger-Layouts mit sorted[i, ...].
+		/// \return Der Index des ersten nicht verwendeten Elements aus sorted.
+		/////////////////////////////////////////////////////////////////////////////
+		Integer fillFrozen(const std::vector<F>& sorted, Integer i, Integer k)
+		{
+			if (k < m_frozen.size())
 			{
-				bool greaterThen = m_comparator.greaterThen(content, m_content);
-				bool equal = m_comparator.equals(content, m_content);
-
-				if (equal)
-				{
-					if (isLeaf())
-					{
-						//der knoten ist ein blatt, hat also keine kinder
-						m_parent->setChildNull(this);
-						//delete this;
-					}
-					else if (m_right)
-					{
-						TreeNode<E, G>* oldRight = m_right;
-						TreeNode<E, G>* oldLeft = m_left;
+				i = fillFrozen(sorted, i, 2 * k);
+				m_frozen[k] = sorted[i++];
+				i = fillFrozen(sorted, i, 2 * k + 1);
+			}
+			return i;
+		}
 
-						m_content = oldRight->m_content;
-						m_right = oldRight->m_right;
-						m_left = oldRight->m_left;
+		/////////////////////////////////////////////////////////////////////////////
+		/// Der Comparator als strikte Ordnung (a < b) fuer die Sortierung.
+		/////////////////////////////////////////////////////////////////////////////
+		struct Less
+		{
+			H m_comparator;
+			bool operator()(const F& a, const F& b) { return m_comparator.greaterThen(b, a); }
+		};
 
-						//delete oldRight;
-					}
-					else if (m_left)
-					{
-						TreeNode<E, G>* oldLeft = m_left;
+		/////////////////////////////////////////////////////////////////////////////
+		/// Baut aus sorted[first, last) einen vollstaendig balancierten Teilbaum
+		/// mit dem mittleren Element als Wurzel. O(n), Rekursionstiefe log n.
+		/////////////////////////////////////////////////////////////////////////////
+		TreeNode<F, H>* build(const F* sorted, Integer first, Integer last, TreeNode<F, H>* parent)
+		{
+			if (first >= last)return nullptr;
+			Integer middle = first + (last - first) / 2;
+			TreeNode<F, H>* node = createNode(sorted[middle]);
+			node->m_parent = parent;
+			node->m_left = build(sorted, first, middle, node);
+			node->m_right = build(sorted, middle + 1, last, node);
+			return node;
+		}
 
-						m_content = oldLeft->m_content;
-						m_right = oldLeft->m_right;
-						m_left = oldLeft->m_left;
+		struct BuildTask
+		{
+			Integer m_first;
+			Integer m_last;
+			TreeNode<F, H>* m_parent;
+			TreeNode<F, H>** m_slot;
+		};
 
-						//delete oldLeft;
-					}
+		/////////////////////////////////////////////////////////////////////////////
+		/// Baut die oberen depth Ebenen selbst und sammelt die Teilbaeume darunter
+		/// als unabhaengige Aufgaben fuer die Threads.
+		/////////////////////////////////////////////////////////////////////////////
+		void buildTop(const F* sorted, Integer first, Integer last, TreeNode<F, H>* parent, TreeNode<F, H>** slot, Integer depth, std::vector<BuildTask>& tasks)
+		{
+			if (depth == 0 || last - first < 2)
+			{
+				BuildTask task = { first, last, parent, slot };
+				tasks.push_back(task);
+				return;
+			}
+			Integer middle = first + (last - first) / 2;
+			TreeNode<F, H>* node = createNode(sorted[middle]);
+			node->m_parent = parent;
+			*slot = node;
+			buildTop(sorted, first, middle, node, &node->m_left, depth - 1, tasks);
+			buildTop(sorted, middle + 1, last, node, &node->m_right, depth - 1, tasks);
+		}
 
-				}
-				else if (m_right && greaterThen)
-				{
-					m_right->removePriv(content);
-				}
-				else if (m_left && !equal && !greaterThen)
+		/////////////////////////////////////////////////////////////////////////////
+		/// Schreibt die Elemente aus [min,max] im Teilbaum root sortiert nach out.
+		/// Teilbaeume ausserhalb des Intervalls werden uebersprungen.
+		/////////////////////////////////////////////////////////////////////////////
+		static void collectRange(const TreeNode<F, H>* root, F min, F max, H comparator, std::vector<F>& out)
+		{
+			std::vector<const TreeNode<F, H>*> stack;
+			const TreeNode<F, H>* node = root;
+			while (node || !stack.empty())
+			{
+				while (node)
 				{
-					m_left->removePriv(content);
+					if (comparator.greaterThen(min, node->m_content))
+					{
+						//node < min: der linke Teilbaum und node liegen vor dem Intervall
+						node = node->m_right;
+					}
+					else
+					{
+						stack.push_back(node);
+						node = node->m_left;
+					}
 				}
+				if (stack.empty())break;
+				node = stack.back();
+				stack.pop_back();
+				if (comparator.greaterThen(node->m_content, max))break;
+				out.push_back(node->m_content);
+				node = node->m_right;
 			}
+		}
 
-			///////////////////////////////////////////////////////////////////
-			/// Hilfsfunktion, die das Kind eines Knotens, dass gleich ptr ist 
-			/// auf nullptr setzt. Wird beim Tauschen von Knoten genutzt.
-			///////////////////////////////////////////////////////////////////
-			void setChildNull(TreeNode<E, G>* ptr)
+		/////////////////////////////////////////////////////////////////////////////
+		/// Sucht im eingefrorenen Layout das erste Element, fuer das goRight false 
+		/// ist. goRight muss auf der sortierten Folge monoton fallen. Die Schleife
+		/// hat keine datenabhaengigen Spruenge, die Enkel 4 Ebenen tiefer werden
+		/// vorab geladen (16 aufeinanderfolgende Elemente).
+		/// \return Der Index im Layout, 0 falls es kein solches Element gibt.
+		/////////////////////////////////////////////////////////////////////////////
+		template<typename P>
+		Integer frozenLowerBound(P goRight)
+		{
+			Integer n = m_frozen.size();
+			Integer k = 1;
+			while (k < n)
 			{
-				if (m_left == ptr)
-				{
-					m_left = nullptr;
-				}
-				else if (m_right == ptr)
-				{
-					m_right = nullptr;
-				}
+				Integer ahead = 16 * k;
+				TREE_PREFETCH(m_frozen.data() + (ahead < n ? ahead : 0));
+				k = 2 * k + Integer(goRight(m_frozen[k]));
+			}
+			//die rechten Schritte am Ende des Pfads und den letzten linken Schritt zuruecknehmen
+			return k >> (trailingZeros64(~uint64_t(k)) + 1);
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Inorder-Nachfolger von k im eingefrorenen Layout, 0 falls k das groesste
+		/// Element ist.
+		/////////////////////////////////////////////////////////////////////////////
+		Integer frozenNext(Integer k) const
+		{
+			Integer n = m_frozen.size();
+			if (2 * k + 1 < n)
+			{
+				k = 2 * k + 1;
+				while (2 * k < n)k = 2 * k;
+				return k;
 			}
+			return k >> (trailingZeros64(~uint64_t(k)) + 1);
+		}
 
-			void foreachInRange(std::shared_ptr<ChangeStrategie<F>> func, std::shared_ptr<RangeBorder<F>> min, std::shared_ptr<RangeBorder<F>> max)
+		/////////////////////////////////////////////////////////////////////////////
+		/// Inorder-Nachfolger eines Knotens ueber die Elternzeiger, nullptr fuer 
+		/// den groessten Knoten. Amortisiert O(1) bei einem vollstaendigen Durchlauf.
+		/////////////////////////////////////////////////////////////////////////////
+		static const TreeNode<F, H>* successor(const TreeNode<F, H>* node)
+		{
+			if (node->m_right)
 			{
-				bool minGreaterThen = min->greaterThen(m_content);
-				bool minEqual = min->equals(m_content);
-				bool maxGreaterThen = max->greaterThen(m_content);
-				bool maxEqual = max->equals(m_content);
+				node = node->m_right;
+				while (node->m_left)node = node->m_left;
+				return node;
+			}
+			while (node->m_parent && node->m_parent->m_right == node)node = node->m_parent;
+			return node->m_parent;
+		}
 
-				//wenn m_content groesser min, dann weiter von links sammeln
-				if (minGreaterThen && m_left)
-				{
-					m_left->foreachInRange(func, min, max);
-				}
-				//wenn min im intervall liegt, m_content mit aufnehmen
-				if (minEqual || maxEqual || minGreaterThen || !maxGreaterThen)
+	public:
+		/////////////////////////////////////////////////////////////////////////////
+		/// Inorder-Iterator ueber die Inhalte. Im eingefrorenen Zustand laeuft er
+		/// ueber das Eytzinger-Layout, sonst ueber die Elternzeiger der Knoten, er
+		/// braucht also weder einen Stack noch Speicher auf dem Heap. insert, 
+		/// remove und freeze machen alle Iteratoren ungueltig.
+		/////////////////////////////////////////////////////////////////////////////
+		class Iterator
+		{
+			friend class BinaryTree;
+		private:
+			const BinaryTree* m_tree;
+			const TreeNode<F, H>* m_node;
+			/// Index im eingefrorenen Layout, 0 wenn der Iterator auf Knoten laeuft
+			Integer m_index;
+			Iterator(const BinaryTree* tree, const TreeNode<F, H>* node, Integer index) : m_tree(tree), m_node(node), m_index(index) {}
+		public:
+			typedef std::forward_iterator_tag iterator_category;
+			typedef F value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef const F* pointer;
+			typedef const F& reference;
+
+			const F& operator*() const { return m_node ? m_node->m_content : m_tree->m_frozen[m_index]; }
+			const F* operator->() const { return &operator*(); }
+			Iterator& operator++()
+			{
+				if (m_node)
 				{
-					func(m_content);
+					m_node = successor(m_node);
 				}
-				//wenn m_content nicht groesser (kleiner) max ist, weiter rechts sammeln
-				if (!maxEqual && !maxGreaterThen && m_right)
+				else
 				{
-					m_right->foreachInRange(func, min, max);
+					m_index = m_tree->frozenNext(m_index);
 				}
+				return *this;
 			}
+			Iterator operator++(int) { Iterator old = *this; ++*this; return old; }
+			bool operator==(const Iterator& other) const { return m_node == other.m_node && m_index == other.m_index; }
+			bool operator!=(const Iterator& other) const { return !(*this == other); }
+		};
 
-			void foreach(std::shared_ptr<ChangeStrategie<F>> func)
+	private:
+		/////////////////////////////////////////////////////////////////////////////
+		/// Iterator auf das erste Element e mit notBelow(e) == true. notBelow muss
+		/// auf der sortierten Folge monoton steigen (e >= min).
+		/////////////////////////////////////////////////////////////////////////////
+		template<typename P>
+		Iterator firstNotBelow(P notBelow)
+		{
+			if (isFrozen())
 			{
-				if (m_left)
+				return Iterator(this, nullptr, frozenLowerBound([&](const F& e) { return !notBelow(e); }));
+			}
+			const TreeNode<F, H>* candidate = nullptr;
+			const TreeNode<F, H>* node = m_node;
+			while (node)
+			{
+				if (notBelow(node->m_content))
 				{
-					m_left->foreach(func);
+					candidate = node;
+					node = node->m_left;
 				}
-				func->change(contentOf());
-				if (m_right)
+				else
 				{
-					m_right->foreach(func);
+					node = node->m_right;
 				}
 			}
+			return Iterator(this, candidate, 0);
+		}
 
-			/// Elternknoten
-			TreeNode<E, G>* m_parent;
-			/// Kindknoten
-			TreeNode<E, G>* m_left;
-			TreeNode<E, G>* m_right;
-			/// Inhalt
-			E m_content;
-			/// Comparator
-			G m_comparator;
-		private:
-
-		}; //!TreeNode
-		/// Wurzelknoten
-		TreeNode<F, H>* m_node;
-		//std::vector<TreeNode<F, H>> m_treeNodes;
+		static bool notBelowBorder(const std::shared_ptr<RangeBorder<F>>& min, const F& e)
+		{
+			return min->greaterThen(e) || min->equals(e);
+		}
 
 	public:
 		/////////////////////////////////////////////////////////////////////////////
 		/// Ein Binaerer Suchbaum kann Leer erstellt werden. Er enthaelt dann keinen 
 		/// Inneren Knoten.
 		/////////////////////////////////////////////////////////////////////////////
-		BinaryTree() { m_node = nullptr; }
+		BinaryTree() : m_allocator(sizeof(TreeNode<F, H>), alignof(TreeNode<F, H>)) { m_node = nullptr; }
 
 		/////////////////////////////////////////////////////////////////////////////
 		/// Ein Binaerer Suchbaum kann mit Inhalt erstellt werden und enhaelt dann 
 		/// einen Inneren Knoten.
 		/////////////////////////////////////////////////////////////////////////////
-		BinaryTree(F content) 
+		BinaryTree(F content) : m_allocator(sizeof(TreeNode<F, H>), alignof(TreeNode<F, H>))
 		{
-			m_node = new TreeNode<F, H>(content);
+			m_node = createNode(content);
 			//m_treeNodes.push_back(TreeNode<F, H>(content));
 			//m_node = &(m_treeNodes.data()[m_treeNodes.size() - 1]);
 		}
-		BinaryTree(F content, H comparator) 
+		BinaryTree(F content, H comparator) : m_allocator(sizeof(TreeNode<F, H>), alignof(TreeNode<F, H>))
 		{ 
-			m_node = new TreeNode<F, H>(content, H comparator);
+			m_node = createNode(content, comparator);
 			//m_treeNodes.push_back(TreeNode<F, H>(content, H comparator));
 			//m_node = &(m_treeNodes.data()[m_treeNodes.size() - 1]);
 		}
@@ -545,7 +605,7 @@ namespace ds
 		/////////////////////////////////////////////////////////////////////////////
 		~BinaryTree() 
 		{ 
-			if (m_node) { delete m_node; } 
+			release();
 		}
 
 		/////////////////////////////////////////////////////////////////////////////
@@ -559,14 +619,8 @@ namespace ds
 		/////////////////////////////////////////////////////////////////////////////
 		void insert(F content) 
 		{ 
-			if (m_node) 
-			{ 
-				m_node->insert(content); 
-			} 
-			else 
-			{
-				m_node = new TreeNode<F, H>(content); 
-			} 
+			m_frozen.clear();
+			attach(createNode(content));
 		}
 
 		/////////////////////////////////////////////////////////////////////////////
@@ -574,7 +628,7 @@ namespace ds
 		/// \param content - Das neue Element.
 		/// \param comparator - Der Komparator fuer den Knoten, in dem "content" gespeichert wird.
 		/////////////////////////////////////////////////////////////////////////////
-		void insert(F content, H comparator) { if (m_node) { m_node->insert(content, comparator); } else { m_node = new TreeNode<F, H>(content, comparator); }	}
+		void insert(F content, H comparator) { m_frozen.clear(); attach(createNode(content, comparator)); }
 
 		/////////////////////////////////////////////////////////////////////////////
 		/// Entfernt den Knoten aus dem Baum, der den Inhalt content hat. 
@@ -585,81 +639,675 @@ namespace ds
 		/////////////////////////////////////////////////////////////////////////////
 		void remove(F content)
 		{
-			if (m_node && !m_node->isLeaf())
+			m_frozen.clear();
+			TreeNode<F, H>* node = m_node;
+			while (node && !node->m_comparator.equals(content, node->m_content))
 			{
-				//wenn der knoten kein blatt ist, teste, ob er zu loeschen ist
-				if (m_node->contentOf() == content)
-				{
-					//die wurzel loschen
-					TreeNode<F, H>* oldRight = m_node->m_right;
-					TreeNode<F, H>* oldLeft = m_node->m_left;
+				node = node->m_comparator.greaterThen(content, node->m_content) ? node->m_right : node->m_left;
+			}
+			if (!node)return;
+			if (node->m_left && node->m_right)
+			{
+				//zwei kinder: der inorder-nachfolger (kleinstes element rechts) ersetzt den inhalt
+				//und wird stattdessen ausgehaengt, er hat hoechstens ein rechtes kind
+				TreeNode<F, H>* successor = node->m_right;
+				while (successor->m_left)successor = successor->m_left;
+				node->m_content = successor->m_content;
+				node = successor;
+			}
+			TreeNode<F, H>* child = node->m_left ? node->m_left : node->m_right;
+			TreeNode<F, H>* parent = node->m_parent;
+			if (child)child->m_parent = parent;
+			if (!parent)
+			{
+				m_node = child;
+			}
+			else if (parent->m_left == node)
+			{
+				parent->m_left = child;
+			}
+			else
+			{
+				parent->m_right = child;
+			}
+			destroyNode(node);
+		}
 
-					//wenn es ein rechtes kind gibt
-					if (oldRight)
-					{
-						//wenn es moeglich ist, weise dieser instanz das rechte kind zu,
-						//loesche das alte rechte kind und haenge das alte linke kind 
-						//im aktuellen knoten an
-						m_node->m_parent = nullptr;
-						m_node->m_content = oldRight->m_content;
-						m_node->m_left = oldRight->m_left;
-						m_node->m_right = oldRight->m_right;
-						if(oldLeft)
-							m_node->insert(oldLeft);
-
-						oldRight->m_right = nullptr;
-						oldRight->m_left = nullptr;
-						delete oldRight;
-					}// !if (oldRight)
-					else
+		/////////////////////////////////////////////////////////////////////////////
+		/// Friert den Baum ein: die Inhalte werden zusaetzlich in Eytzinger-
+		/// Reihenfolge in ein zusammenhaengendes Array kopiert. contains und 
+		/// rangeQuery arbeiten danach auf diesem Array statt auf den Knoten, eine 
+		/// Suche liest dann ungefaehr einen Cache-Block pro 4 Ebenen. insert und 
+		/// remove verwerfen das Layout wieder, freeze muss danach erneut aufgerufen
+		/// werden. Laufzeit O(n), Platz n Elemente.
+		/////////////////////////////////////////////////////////////////////////////
+		void freeze()
+		{
+			std::vector<F> sorted;
+			collect(sorted);
+			m_frozen.assign(sorted.size() + 1, F());
+			fillFrozen(sorted, 0, 1);
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Ersetzt den Inhalt des Baums durch [first, last): die Elemente werden
+		/// mit den Threads von pool sortiert (parallelSort), danach wird in O(n) 
+		/// ein vollstaendig balancierter Baum gebaut, dessen untere Teilbaeume
+		/// ebenfalls parallel entstehen (der Allokator muss dafuer thread-sicher
+		/// sein, wie HeapNodeAllocator und NodeArena). Mit freeze wird zusaetzlich
+		/// das Eytzinger-Layout direkt aus der sortierten Folge gefuellt.
+		/// \param first, last - Eingabeiteratoren auf die neuen Elemente.
+		/////////////////////////////////////////////////////////////////////////////
+		template<typename I>
+		void bulkLoad(I first, I last, ThreadPool& pool, bool freeze = false)
+		{
+			std::vector<F> sorted(first, last);
+			Less less = { m_comparator };
+			parallelSort(pool, sorted.begin(), sorted.end(), less);
+			release(true);
+			m_frozen.clear();
+
+			//etwa 4 Teilbaeume pro Thread, damit sich ungleiche Laufzeiten ausgleichen
+			Integer depth = 0;
+			while (pool.size() > 1 && (Integer(1) << depth) < 4 * pool.size())depth++;
+			std::vector<BuildTask> tasks;
+			buildTop(sorted.data(), 0, sorted.size(), nullptr, &m_node, depth, tasks);
+			pool.parallelFor(tasks.size(), [&](Integer t)
+			{
+				const BuildTask& task = tasks[t];
+				*task.m_slot = build(sorted.data(), task.m_first, task.m_last, task.m_parent);
+			});
+
+			if (freeze)
+			{
+				m_frozen.assign(sorted.size() + 1, F());
+				fillFrozen(sorted, 0, 1);
+			}
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Wie oben mit einem eigenen ThreadPool ueber alle Kerne.
+		/////////////////////////////////////////////////////////////////////////////
+		template<typename I>
+		void bulkLoad(I first, I last, bool freeze = false)
+		{
+			ThreadPool pool;
+			bulkLoad(first, last, pool, freeze);
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// \return true, wenn der Baum eingefroren ist (siehe freeze).
+		/////////////////////////////////////////////////////////////////////////////
+		bool isFrozen() const { return !m_frozen.empty(); }
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Prueft, ob content im Baum enthalten ist. Im eingefrorenen Zustand ohne
+		/// Spruenge im Eytzinger-Layout, sonst iterativ entlang der Knoten.
+		/////////////////////////////////////////////////////////////////////////////
+		bool contains(F content)
+		{
+			if (isFrozen())
+			{
+				Integer k = frozenLowerBound([&](const F& e) { return m_comparator.greaterThen(content, e); });
+				return k != 0 && m_comparator.equals(m_frozen[k], content);
+			}
+			TreeNode<F, H>* node = m_node;
+			while (node)
+			{
+				if (m_comparator.equals(content, node->m_content))return true;
+				node = m_comparator.greaterThen(content, node->m_content) ? node->m_right : node->m_left;
+			}
+			return false;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Iteratoren fuer einen Durchlauf in sortierter Reihenfolge.
+		/////////////////////////////////////////////////////////////////////////////
+		Iterator begin()
+		{
+			if (isFrozen())
+			{
+				if (m_frozen.size() < 2)return end();
+				Integer k = 1;
+				while (2 * k < m_frozen.size())k = 2 * k;
+				return Iterator(this, nullptr, k);
+			}
+			const TreeNode<F, H>* node = m_node;
+			while (node && node->m_left)node = node->m_left;
+			return Iterator(this, node, 0);
+		}
+
+		Iterator end() { return Iterator(this, nullptr, 0); }
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// \return Iterator auf das erste Element >= min (bezueglich des 
+		/// Comparators des Baums), end() falls es keins gibt.
+		/////////////////////////////////////////////////////////////////////////////
+		Iterator lowerBound(F min)
+		{
+			return firstNotBelow([&](const F& e) { return !m_comparator.greaterThen(min, e); });
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Ruft visitor(e) fuer jedes Element e im Intervall [min,max] in 
+		/// sortierter Reihenfolge auf. Der Besucher ist ein Template-Parameter 
+		/// (Lambda, Funktor), die Grenzen werden mit dem Comparator H verglichen,
+		/// dessen Typ feststeht: in der Schleife gibt es weder virtuelle Aufrufe 
+		/// noch Allokationen.
+		/////////////////////////////////////////////////////////////////////////////
+		template<typename V>
+		void visitRange(F min, F max, V visitor)
+		{
+			for (Iterator it = lowerBound(min); it != end() && !m_comparator.greaterThen(*it, max); ++it)visitor(*it);
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Schreibt die Elemente im Intervall [min,max] sortiert nach out (ein
+		/// Ausgabeiterator, z.B. ein Zeiger in einen Puffer des Aufrufers).
+		/// \return out hinter dem letzten geschriebenen Element.
+		/////////////////////////////////////////////////////////////////////////////
+		template<typename O>
+		O copyRange(F min, F max, O out)
+		{
+			visitRange(min, max, [&](const F& e) { *out++ = e; });
+			return out;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Schreibt hoechstens capacity Elemente aus [min,max] sortiert in buffer.
+		/// Sind es mehr, kann die Abfrage mit lowerBound hinter dem letzten 
+		/// Element fortgesetzt werden.
+		/// \return Die Anzahl der geschriebenen Elemente.
+		/////////////////////////////////////////////////////////////////////////////
+		Integer rangeQuery(F min, F max, F* buffer, Integer capacity)
+		{
+			Integer n = 0;
+			for (Iterator it = lowerBound(min); n < capacity && it != end() && !m_comparator.greaterThen(*it, max); ++it)buffer[n++] = *it;
+			return n;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Gibt alle Elemente im Intervall [min,max] sortiert zurueck (min und max
+		/// inklusive). Iterativ, nur der Ergebnisvektor wird angelegt.
+		/////////////////////////////////////////////////////////////////////////////
+		std::vector<F> rangeQuery(std::shared_ptr<RangeBorder<F>> min, std::shared_ptr<RangeBorder<F>> max)
+		{
+			std::vector<F> result;
+			for (Iterator it = firstNotBelow([&](const F& e) { return notBelowBorder(min, e); }); it != end() && !max->greaterThen(*it); ++it)result.push_back(*it);
+			return result;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Ruft func fuer jedes Element im Intervall [min,max] in sortierter
+		/// Reihenfolge auf.
+		/////////////////////////////////////////////////////////////////////////////
+		void foreachInRange(std::shared_ptr<ChangeStrategie<F>> func, std::shared_ptr<RangeBorder<F>> min, std::shared_ptr<RangeBorder<F>> max)
+		{
+			for (Iterator it = firstNotBelow([&](const F& e) { return notBelowBorder(min, e); }); it != end() && !max->greaterThen(*it); ++it)func->change(*it);
+		}
+
+		void foreach(std::shared_ptr<ChangeStrategie<F>> func)
+		{
+			for (Iterator it = begin(); it != end(); ++it)func->change(*it);
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Gibt alle Elemente im Intervall [min,max] sortiert zurueck. Der Baum 
+		/// wird von der Wurzel aus in disjunkte Teilbaeume zerlegt (Teilbaeume 
+		/// ausserhalb des Intervalls fallen dabei weg), bis es etwa 4 pro Thread 
+		/// sind. Jeder Thread sammelt seine Teilbaeume in einen eigenen Vektor, die
+		/// Vektoren werden in Inorder-Reihenfolge zusammengesetzt.
+		/////////////////////////////////////////////////////////////////////////////
+		std::vector<F> parallelRangeQuery(F min, F max, ThreadPool& pool)
+		{
+			//ein Teil ist entweder ein ganzer Teilbaum oder nur ein einzelner Knoten im Intervall
+			struct Part
+			{
+				const TreeNode<F, H>* m_node;
+				bool m_subtree;
+			};
+			std::vector<Part> parts;
+			if (m_node)
+			{
+				Part root = { m_node, true };
+				parts.push_back(root);
+			}
+			for (Integer round = 0; round < 64 && parts.size() < 4 * pool.size(); round++)
+			{
+				std::vector<Part> next;
+				bool split = false;
+				for (const Part& part : parts)
+				{
+					const TreeNode<F, H>* node = part.m_node;
+					if (!part.m_subtree)
 					{
-						//verschiebe das linke kind in diese instanz und loeche 
-						//das alte linke kind
-						m_node->m_parent = nullptr;
-						m_node->m_content = oldLeft->m_content;
-						m_node->m_left = oldLeft->m_left;
-						m_node->m_right = oldLeft->m_right;
-
-						oldLeft->m_right = nullptr;
-						oldLeft->m_left = nullptr;
-						delete oldLeft;
-					}// !if (oldRight) -> else (!oldRight)
-				}//!if (m_node->contentOf() == content)
+						next.push_back(part);
+						continue;
+					}
+					split = true;
+					bool belowMin = m_comparator.greaterThen(min, node->m_content);
+					bool aboveMax = m_comparator.greaterThen(node->m_content, max);
+					Part left = { node->m_left, true };
+					Part self = { node, false };
+					Part right = { node->m_right, true };
+					if (!belowMin && node->m_left)next.push_back(left);
+					if (!belowMin && !aboveMax)next.push_back(self);
+					if (!aboveMax && node->m_right)next.push_back(right);
+				}
+				parts.swap(next);
+				if (!split)break;
+			}
+
+			std::vector<std::vector<F>> results(parts.size());
+			pool.parallelFor(parts.size(), [&](Integer p)
+			{
+				if (parts[p].m_subtree)
+				{
+					collectRange(parts[p].m_node, min, max, m_comparator, results[p]);
+				}
 				else
 				{
-					//einen inneren/blattknoten loeschen
-					m_node->remove(content);
-				}//!if (m_node->contentOf() == content) -> else (m_node->contentOf() != content)
-			}//!if (m_node && !m_node->isLeaf())
+					results[p].push_back(parts[p].m_node->m_content);
+				}
+			});
+
+			std::vector<Integer> offsets(parts.size() + 1, 0);
+			for (Integer p = 0; p < parts.size(); p++)offsets[p + 1] = offsets[p] + results[p].size();
+			std::vector<F> result(offsets[parts.size()]);
+			pool.parallelFor(parts.size(), [&](Integer p) { std::copy(results[p].begin(), results[p].end(), result.begin() + offsets[p]); });
+			return result;
+		}
+
+		std::vector<F> parallelRangeQuery(F min, F max)
+		{
+			ThreadPool pool;
+			return parallelRangeQuery(min, max, pool);
+		}
+
+	}; //!BinaryTree
+
+	///////////////////////////////////////////////////////////////////////////
+	/// Selbstbalancierender binaerer Suchbaum (AVL-Baum) mit derselben 
+	/// Schnittstelle wie BinaryTree. Die Hoehe ist hoechstens 1.44 log2(n), 
+	/// insert, remove und contains laufen in O(log n), auch bei sortierter 
+	/// Eingabe. Der Balancefaktor eines Knotens (-1, 0, +1) wird in den freien 
+	/// unteren Bits des linken Kindzeigers gespeichert (PointerIntegerType), ein 
+	/// Knoten besteht also nur aus zwei Zeigern und dem Inhalt. Der Comparator 
+	/// gehoert dem Baum, nicht den Knoten. A ist wie bei BinaryTree der 
+	/// Allokator der Knoten.
+	///////////////////////////////////////////////////////////////////////////
+	template<
+			typename F,
+			typename H = DefaultNodeComperator<F>,
+			typename A = HeapNodeAllocator,
+			typename std::enable_if<std::is_base_of<DefaultNodeComperator<F>, H>::value>::type* = nullptr
+	>
+	class AVLTree
+	{
+	private:
+		struct AVLNode
+		{
+			AVLNode(F content) : m_left(nullptr, 1), m_right(nullptr), m_content(content) {}
+			/// linkes Kind, im Integerteil der Balancefaktor + 1
+			PointerIntegerType<AVLNode> m_left;
+			AVLNode* m_right;
+			F m_content;
+		};
+		static_assert(alignof(AVLNode) >= 4, "der Balancefaktor braucht 2 freie Bits im Zeiger");
+
+		AVLNode* m_root;
+		Integer m_size;
+		H m_comparator;
+		A m_allocator;
+
+		void destroyNode(AVLNode* node)
+		{
+			node->~AVLNode();
+			m_allocator.deallocate(node);
+		}
+
+		static AVLNode* left(const AVLNode* node) { return node->m_left.pointerContent(); }
+		static void setLeft(AVLNode* node, AVLNode* child) { node->m_left.setPointerContent(child); }
+		/// Balancefaktor = Hoehe(rechts) - Hoehe(links)
+		static int balance(const AVLNode* node) { return int(node->m_left.integerContent()) - 1; }
+		static void setBalance(AVLNode* node, int b) { node->m_left.setIntegerContent(Integer(b + 1)); }
+
+		static AVLNode* rotateLeft(AVLNode* x)
+		{
+			AVLNode* y = x->m_right;
+			x->m_right = left(y);
+			setLeft(y, x);
+			return y;
+		}
+
+		static AVLNode* rotateRight(AVLNode* x)
+		{
+			AVLNode* y = left(x);
+			setLeft(x, y->m_right);
+			y->m_right = x;
+			return y;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Balanciert einen Knoten mit Balancefaktor +2 aus.
+		/// \param shrunk - true, wenn der Teilbaum danach niedriger ist als vor 
+		/// der Rotation (bei insert immer, bei remove nicht, wenn das rechte Kind 
+		/// ausgeglichen war).
+		/// \return Die neue Wurzel des Teilbaums.
+		/////////////////////////////////////////////////////////////////////////////
+		static AVLNode* fixRightHeavy(AVLNode* x, bool& shrunk)
+		{
+			AVLNode* y = x->m_right;
+			int b = balance(y);
+			if (b >= 0)
+			{
+				AVLNode* root = rotateLeft(x);
+				setBalance(x, b == 0 ? 1 : 0);
+				setBalance(y, b == 0 ? -1 : 0);
+				shrunk = b != 0;
+				return root;
+			}
+			AVLNode* z = left(y);
+			int c = balance(z);
+			x->m_right = rotateRight(y);
+			AVLNode* root = rotateLeft(x);
+			setBalance(x, c == 1 ? -1 : 0);
+			setBalance(y, c == -1 ? 1 : 0);
+			setBalance(z, 0);
+			shrunk = true;
+			return root;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Spiegelbild von fixRightHeavy fuer den Balancefaktor -2.
+		/////////////////////////////////////////////////////////////////////////////
+		static AVLNode* fixLeftHeavy(AVLNode* x, bool& shrunk)
+		{
+			AVLNode* y = left(x);
+			int b = balance(y);
+			if (b <= 0)
+			{
+				AVLNode* root = rotateRight(x);
+				setBalance(x, b == 0 ? -1 : 0);
+				setBalance(y, b == 0 ? 1 : 0);
+				shrunk = b != 0;
+				return root;
+			}
+			AVLNode* z = y->m_right;
+			int c = balance(z);
+			setLeft(x, rotateLeft(y));
+			AVLNode* root = rotateRight(x);
+			setBalance(x, c == -1 ? 1 : 0);
+			setBalance(y, c == 1 ? -1 : 0);
+			setBalance(z, 0);
+			shrunk = true;
+			return root;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Der linke Teilbaum von node ist um 1 gewachsen (grown = true) bzw. 
+		/// geschrumpft (grown = false). Passt den Balancefaktor an und rotiert bei 
+		/// Bedarf.
+		/// \param changed - Ein: der Teilbaum hat seine Hoehe geaendert. Aus: node 
+		/// hat seine Hoehe in dieselbe Richtung geaendert.
+		/////////////////////////////////////////////////////////////////////////////
+		static AVLNode* leftChanged(AVLNode* node, bool grown, bool& changed)
+		{
+			int b = balance(node) + (grown ? -1 : 1);
+			bool shrunk;
+			if (b == -2)
+			{
+				node = fixLeftHeavy(node, shrunk);
+				changed = false;
+			}
+			else if (b == 2)
+			{
+				node = fixRightHeavy(node, shrunk);
+				changed = shrunk;
+			}
+			else
+			{
+				setBalance(node, b);
+				changed = grown ? b != 0 : b == 0;
+			}
+			return node;
+		}
+
+		static AVLNode* rightChanged(AVLNode* node, bool grown, bool& changed)
+		{
+			int b = balance(node) + (grown ? 1 : -1);
+			bool shrunk;
+			if (b == 2)
+			{
+				node = fixRightHeavy(node, shrunk);
+				changed = false;
+			}
+			else if (b == -2)
+			{
+				node = fixLeftHeavy(node, shrunk);
+				changed = shrunk;
+			}
+			else
+			{
+				setBalance(node, b);
+				changed = grown ? b != 0 : b == 0;
+			}
+			return node;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Fuegt content in den Teilbaum node ein. Gleiche Inhalte gehen wie bei 
+		/// BinaryTree nach rechts. Die Rekursionstiefe ist durch die Hoehe 
+		/// (O(log n)) beschraenkt.
+		/////////////////////////////////////////////////////////////////////////////
+		AVLNode* insert(AVLNode* node, F content, bool& grown)
+		{
+			if (!node)
+			{
+				grown = true;
+				return new (m_allocator.allocate()) AVLNode(content);
+			}
+			if (m_comparator.greaterThen(content, node->m_content) || m_comparator.equals(content, node->m_content))
+			{
+				node->m_right = insert(node->m_right, content, grown);
+				if (grown)node = rightChanged(node, true, grown);
+			}
+			else
+			{
+				setLeft(node, insert(left(node), content, grown));
+				if (grown)node = leftChanged(node, true, grown);
+			}
+			return node;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Haengt das kleinste Element des Teilbaums node aus und gibt es in 
+		/// minimum zurueck.
+		/////////////////////////////////////////////////////////////////////////////
+		AVLNode* removeMinimum(AVLNode* node, AVLNode*& minimum, bool& shrunk)
+		{
+			if (!left(node))
+			{
+				minimum = node;
+				shrunk = true;
+				return node->m_right;
+			}
+			setLeft(node, removeMinimum(left(node), minimum, shrunk));
+			if (shrunk)node = leftChanged(node, false, shrunk);
+			return node;
+		}
+
+		AVLNode* remove(AVLNode* node, F content, bool& shrunk, bool& found)
+		{
+			if (!node)
+			{
+				shrunk = false;
+				return nullptr;
+			}
+			if (m_comparator.equals(content, node->m_content))
+			{
+				found = true;
+				AVLNode* l = left(node);
+				AVLNode* r = node->m_right;
+				int b = balance(node);
+				destroyNode(node);
+				if (!r)
+				{
+					shrunk = true;
+					return l;
+				}
+				//der Nachfolger ersetzt den Knoten
+				AVLNode* successor;
+				r = removeMinimum(r, successor, shrunk);
+				setLeft(successor, l);
+				successor->m_right = r;
+				setBalance(successor, b);
+				if (shrunk)successor = rightChanged(successor, false, shrunk);
+				return successor;
+			}
+			if (m_comparator.greaterThen(content, node->m_content))
+			{
+				node->m_right = remove(node->m_right, content, shrunk, found);
+				if (shrunk)node = rightChanged(node, false, shrunk);
+			}
 			else
 			{
-				//wenn dies der einzige knoten ist, einfach loeschen
-				delete m_node;
-				m_node = nullptr;
-			}//!if (m_node && !m_node->isLeaf()) -> else (!m_node || m_node->isLeaf())
+				setLeft(node, remove(left(node), content, shrunk, found));
+				if (shrunk)node = leftChanged(node, false, shrunk);
+			}
+			return node;
 		}
 
-		std::vector<F> rangeQuery(std::shared_ptr<RangeBorder<F>> min, std::shared_ptr<RangeBorder<F>> max)
+		void release()
 		{
-			if (m_node)
+			std::vector<AVLNode*> stack;
+			//siehe BinaryTree::release
+			if (m_root && !(A::s_bulkRelease && std::is_trivially_destructible<AVLNode>::value))stack.push_back(m_root);
+			while (!stack.empty())
 			{
-				return m_node->rangeQuery(min, max);
+				AVLNode* node = stack.back();
+				stack.pop_back();
+				if (left(node))stack.push_back(left(node));
+				if (node->m_right)stack.push_back(node->m_right);
+				destroyNode(node);
 			}
-			return std::vector<F>();
+			m_root = nullptr;
+			m_size = 0;
 		}
 
-		void foreachInRange(std::shared_ptr<ChangeStrategie<F>> func, std::shared_ptr<RangeBorder<F>> min, std::shared_ptr<RangeBorder<F>> max)
+		AVLTree(const AVLTree& other) = delete;
+		AVLTree& operator=(const AVLTree& other) = delete;
+	public:
+		AVLTree() : m_root(nullptr), m_size(0), m_allocator(sizeof(AVLNode), alignof(AVLNode)) {}
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Der Baum ruft NICHT die Destruktoren der Inhalte auf! Der Baum loescht 
+		/// lediglich seine Knoten.
+		/////////////////////////////////////////////////////////////////////////////
+		~AVLTree() { release(); }
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Anzahl der Elemente, O(1).
+		/////////////////////////////////////////////////////////////////////////////
+		uint32_t size() const { return uint32_t(m_size); }
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Hoehe des Baums (0 fuer den leeren Baum), O(log n) entlang der 
+		/// Balancefaktoren.
+		/////////////////////////////////////////////////////////////////////////////
+		uint32_t height() const
+		{
+			uint32_t h = 0;
+			for (AVLNode* node = m_root; node; h++)node = balance(node) > 0 ? node->m_right : left(node);
+			return h;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Fuegt dem Baum ein Element hinzu.
+		/// \param content - Das neue Element.
+		/////////////////////////////////////////////////////////////////////////////
+		void insert(F content)
 		{
+			bool grown = false;
+			m_root = insert(m_root, content, grown);
+			m_size++;
+		}
 
+		/////////////////////////////////////////////////////////////////////////////
+		/// Entfernt ein Element mit dem Inhalt content. Ist der Inhalt nicht 
+		/// vorhanden, geschieht nichts. Der Inhalt wird nicht geloescht!
+		/// \return true, wenn ein Element entfernt wurde.
+		/////////////////////////////////////////////////////////////////////////////
+		bool remove(F content)
+		{
+			bool shrunk = false;
+			bool found = false;
+			m_root = remove(m_root, content, shrunk, found);
+			if (found)m_size--;
+			return found;
 		}
 
-		void foreach(std::shared_ptr<ChangeStrategie<F>> func)
+		bool contains(F content)
 		{
-			if(m_node)
-				m_node->foreach(func);
+			AVLNode* node = m_root;
+			while (node)
+			{
+				if (m_comparator.equals(content, node->m_content))return true;
+				node = m_comparator.greaterThen(content, node->m_content) ? node->m_right : left(node);
+			}
+			return false;
 		}
 
-	}; //!BinaryTree
+		/////////////////////////////////////////////////////////////////////////////
+		/// Gibt alle Elemente im Intervall [min,max] sortiert zurueck (min und max 
+		/// inklusive). Iterativ, Teilbaeume ausserhalb des Intervalls werden 
+		/// uebersprungen.
+		/////////////////////////////////////////////////////////////////////////////
+		std::vector<F> rangeQuery(std::shared_ptr<RangeBorder<F>> min, std::shared_ptr<RangeBorder<F>> max)
+		{
+			std::vector<F> result;
+			std::vector<AVLNode*> stack;
+			AVLNode* node = m_root;
+			while (node || !stack.empty())
+			{
+				while (node)
+				{
+					//links nur weiter, wenn der Inhalt nicht kleiner als min ist (nach
+					//Rotationen koennen gleiche Inhalte auch links liegen)
+					bool notBelowMin = min->greaterThen(node->m_content) || min->equals(node->m_content);
+					stack.push_back(node);
+					node = notBelowMin ? left(node) : nullptr;
+				}
+				node = stack.back();
+				stack.pop_back();
+				if (max->greaterThen(node->m_content))break;
+				if (min->greaterThen(node->m_content) || min->equals(node->m_content))result.push_back(node->m_content);
+				node = node->m_right;
+			}
+			return result;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		/// Ruft func fuer jedes Element in sortierter Reihenfolge auf.
+		/////////////////////////////////////////////////////////////////////////////
+		void foreach(std::shared_ptr<ChangeStrategie<F>> func)
+		{
+			std::vector<AVLNode*> stack;
+			AVLNode* node = m_root;
+			while (node || !stack.empty())
+			{
+				while (node)
+				{
+					stack.push_back(node);
+					node = left(node);
+				}
+				node = stack.back();
+				stack.pop_back();
+				func->change(node->m_content);
+				node = node->m_right;
+			}
+		}
+	}; //!AVLTree
 }
 
 #endif
\ No newline at end of file
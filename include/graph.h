@@ -8,13 +8,18 @@
 
 namespace ds
 {
+	/*!
+		\class Graphe stellt die Kanten eines gerichteten Graphen ohne Gewichte als quadratische Bitmatrix dar: die Kante (i,j)
+		ist das Bit i + j * size. Der Speicher wächst quadratisch mit der Anzahl der Knoten, size² Bits (65536 Knoten belegen
+		512 MiB, 2^20 Knoten 128 GiB), für große dünn besetzte Graphen ist CompressedGraph gedacht.
+	*/
 	class Graphe
 	{
 	private:
 		/*!
-		\brief Kantentabelle.
+		\brief Kantentabelle, size² Einträge zu 1 Bit, mit 64 Bit Indizes.
 		*/
-		Bitstring m_edges;
+		Array m_edges;
 		/*!
 		\brief Größe der beiden Tabellen.
 		*/
@@ -109,6 +114,88 @@ namespace ds
 		bool setWeight(uint32_t i, uint32_t j, int32_t value);
 		int32_t weight(uint32_t i, uint32_t j) const;
 	};
+
+	/*!
+		\class CompressedGraph stellt einen dünn besetzten, gerichteten Graphen im CSR-Format (compressed sparse row) dar.
+		Die Kanten eines Knotens i liegen in [offset(i), offset(i + 1)) und sind nach dem Zielknoten sortiert. Die Offsets
+		werden mit log2(m) Bits, die Zielknoten mit log2(n) Bits und die Kantengewichte mit tau Bits in Arrays gepackt,
+		der Speicher ist also O(n log m + m (log n + tau)) Bits statt O(n²) wie bei Graphe und Graphui.
+		tau = 0 speichert keine Gewichte (wie Graphe), mit isSigned werden die Gewichte als Zweierkomplement in tau Bits
+		abgelegt (wie Graphi), sonst vorzeichenlos (wie Graphui). Die Kantenmenge ist nach dem Konstruktor fest,
+		setWeight ändert nur die Gewichte vorhandener Kanten.
+	*/
+	class CompressedGraph
+	{
+	public:
+		/*!
+			\brief Eine Kante von m_from nach m_to.
+		*/
+		struct Edge
+		{
+			uint32_t m_from;
+			uint32_t m_to;
+			int32_t m_weight;
+		};
+	private:
+		Array m_offsets;
+		Array m_targets;
+		Array m_weights;
+		uint32_t m_size;
+		uint8_t m_tau;
+		bool m_isSigned;
+		Integer findEdge(uint32_t i, uint32_t j) const;
+	public:
+		/*!
+		* \brief Baut den Graphen aus einer Kantenliste in O(n + m log(Grad)).
+		*
+		* \param size		- Die Anzahl der Knoten.
+		* \param edges		- Die Kanten, Kanten mit Knoten >= size werden ignoriert. Kommt eine Kante mehrfach vor, gilt das
+		*					  letzte Gewicht.
+		* \param tau		- Die Bits pro Kantengewicht aus [0,32], 0 speichert keine Gewichte.
+		* \param isSigned	- Die Gewichte sind vorzeichenbehaftet.
+		*/
+		CompressedGraph(uint32_t size, std::vector<Edge> edges, uint8_t tau = 0, bool isSigned = false);
+		~CompressedGraph();
+		/*!
+		* \return	true, wenn die Kante (i,j) existiert. Binärsuche über die Kanten von i, O(log(Grad)).
+		*/
+		bool hasEdge(uint32_t i, uint32_t j) const;
+		/*!
+		* \return	Das Gewicht der Kante (i,j), 0 wenn die Kante nicht existiert oder keine Gewichte gespeichert werden.
+		*/
+		int32_t weight(uint32_t i, uint32_t j) const;
+		/*!
+		* \brief Setzt das Gewicht der vorhandenen Kante (i,j) auf value (abgeschnitten auf tau Bits).
+		*
+		* \return	false, wenn die Kante nicht existiert oder keine Gewichte gespeichert werden.
+		*/
+		bool setWeight(uint32_t i, uint32_t j, int32_t value);
+		uint32_t numberOfNodes() const;
+		Integer numberOfEdges() const;
+		uint32_t degree(uint32_t i) const;
+		/*!
+		* \brief Die Kanten von i haben die Nummern [firstEdge(i), firstEdge(i + 1)), firstEdge(numberOfNodes()) ist numberOfEdges().
+		*/
+		Integer firstEdge(uint32_t i) const;
+		/*!
+		* \return	Der Zielknoten der Kante e.
+		*/
+		uint32_t target(Integer e) const;
+		/*!
+		* \return	Das Gewicht der Kante e.
+		*/
+		int32_t edgeWeight(Integer e) const;
+		/*!
+		* \brief Entpackt die Zielknoten der Kanten [first, first + n) am Stück nach out (siehe Array::getRange).
+		*/
+		void targets(Integer first, Integer n, uint64_t* out) const;
+		/*!
+		* \brief Entpackt die Gewichte der Kanten [first, first + n) am Stück nach out, vorzeichenlose Gewichte aus [0, 2^tau), vorzeichenbehaftete mit Vorzeichen.
+		*/
+		void weights(Integer first, Integer n, int64_t* out) const;
+		uint8_t tau() const;
+		Integer byteSize() const;
+	};
 };
 
 #endif // !__GRAPH_H__
\ No newline at end of file
@@ -0,0 +1,85 @@
+#ifndef __GRAPHTRAVERSAL_H__
+
+#define __GRAPHTRAVERSAL_H__
+
+#include "includes.h"
+#include "graph.h"
+#include "threadpool.h"
+#include "bitstring.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/*
+	GRAPH_UNREACHED ist die BFS-Ebene, GRAPH_INFINITY die Distanz eines nicht erreichbaren Knotens. Eine Aufgabe des
+	ThreadPools bearbeitet GRAPH_TRAVERSAL_CHUNK Knoten (ein Vielfaches von 32, damit jede Aufgabe eigene Worte der
+	Bitstrings schreibt). Die BFS wechselt nach Beamer auf bottom-up, wenn die Kanten der Front mehr als 1/GRAPH_BFS_ALPHA
+	der unbesuchten Kanten sind, und zurück auf top-down, wenn die Front weniger als 1/GRAPH_BFS_BETA der Knoten hat.
+*/
+#define GRAPH_UNREACHED 0xFFFFFFFF
+#define GRAPH_INFINITY (~uint64_t(0))
+#define GRAPH_TRAVERSAL_CHUNK 1024
+#define GRAPH_BFS_ALPHA 14
+#define GRAPH_BFS_BETA 24
+
+namespace ds
+{
+	/*!
+		\class GraphTraversal führt Graphalgorithmen parallel auf einem CompressedGraph aus: richtungsoptimierte Breitensuche,
+		Delta-Stepping für kürzeste Wege und Zusammenhangskomponenten mit Union-Find. Die Arbeit wird in Blöcken von
+		GRAPH_TRAVERSAL_CHUNK Knoten über ThreadPool::parallelFor verteilt, freie Threads holen sich den nächsten Block
+		(dynamische Lastverteilung). Gemeinsam geschriebene Bitstrings werden mit Bitstring::testAndSetBit atomar gesetzt.
+	*/
+	class GraphTraversal
+	{
+	private:
+		const CompressedGraph& m_graph;
+		/*!
+			\brief Die umgedrehten Kanten für den bottom-up Schritt, nur bei einem gerichteten Graphen.
+		*/
+		std::unique_ptr<CompressedGraph> m_reverse;
+		const CompressedGraph* m_incoming;
+		ThreadPool& m_pool;
+
+		Integer topDownStep(const std::vector<uint32_t>& frontier, std::vector<uint32_t>& next, Bitstring& visited, std::vector<uint32_t>& levels, uint32_t level, Integer& frontierEdges) const;
+		Integer bottomUpStep(const Bitstring& frontier, Bitstring& next, Bitstring& visited, std::vector<uint32_t>& levels, uint32_t level, Integer& frontierEdges) const;
+		void relaxEdges(const std::vector<uint32_t>& nodes, bool light, uint64_t delta, std::vector<std::atomic<uint64_t>>& distances, std::vector<uint32_t>& improved) const;
+	public:
+		/*!
+		* \brief Bereitet die Algorithmen auf graph vor.
+		*
+		* \param graph		- Der Graph, er muss so lange leben wie die GraphTraversal.
+		* \param pool		- Die Threads.
+		* \param symmetric	- Zu jeder Kante (i,j) gibt es die Kante (j,i) (ungerichteter Graph). Sonst werden für die
+		*					  bottom-up Schritte der BFS die umgedrehten Kanten als zweiter CompressedGraph gebaut.
+		*/
+		GraphTraversal(const CompressedGraph& graph, ThreadPool& pool, bool symmetric = false);
+		~GraphTraversal();
+		/*!
+		* \brief Richtungsoptimierte Breitensuche: kleine Fronten werden als Liste top-down expandiert, große als Bitstring
+		* bottom-up (jeder unbesuchte Knoten sucht einen Vorgänger in der Front und bricht beim ersten ab).
+		*
+		* \return	Die Ebene (Anzahl Kanten von source) jedes Knotens, GRAPH_UNREACHED für nicht erreichbare Knoten.
+		*/
+		std::vector<uint32_t> bfs(uint32_t source) const;
+		/*!
+		* \brief Kürzeste Wege mit Delta-Stepping: die Knoten werden nach Distanz in Eimer der Breite delta einsortiert, ein
+		* Eimer wird parallel über die leichten Kanten (<= delta) relaxiert, bis er leer bleibt, danach einmal über die
+		* schweren. Ein Graph ohne Gewichte (tau = 0) hat das Gewicht 1 an jeder Kante.
+		*
+		* \param delta	- Die Eimerbreite, 0 wählt das größte Gewicht geteilt durch den mittleren Grad.
+		* \return		Die Distanz jedes Knotens, GRAPH_INFINITY für nicht erreichbare Knoten.
+		* \pre			Alle Gewichte sind >= 0.
+		*/
+		std::vector<uint64_t> shortestPaths(uint32_t source, uint64_t delta = 0) const;
+		/*!
+		* \brief Zusammenhangskomponenten (bei gerichteten Graphen schwache) mit einem lock-freien Union-Find: die Wurzel
+		* mit der größeren Nummer wird per compare-and-swap unter die kleinere gehängt, find halbiert die Pfade.
+		*
+		* \return	Für jeden Knoten den kleinsten Knoten seiner Komponente.
+		*/
+		std::vector<uint32_t> connectedComponents() const;
+	};
+};
+
+#endif // !__GRAPHTRAVERSAL_H__
@@ -2,251 +2,481 @@
 #define __HASHTABLE_H__
 
 #include <type_traits>
+#include <atomic>
+#include <utility>
 #include "bitmanipulation.h"
 
-#define PRIMETESTS 300
+#if __SSE2__ || _M_X64 || _M_AMD64 || (_M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define HASHTABLE_SSE2 1
+#endif
+
+/*
+	Layout of Hashtable: one control byte per slot, probed HASHTABLE_GROUP_SIZE slots at a time. A full slot stores the
+	low 7 bits of the hash of its key, so 16 candidates are filtered with one byte compare before a key is touched.
+*/
+#define HASHTABLE_GROUP_SIZE 16
+#define HASHTABLE_EMPTY 0x80
+#define HASHTABLE_DELETED 0xFE
+#define HASHTABLE_MIN_CAPACITY 16
+/*
+	Number of slots of the old table, which are moved into the new table by every insert during an incremental rehash.
+*/
+#define HASHTABLE_MIGRATION_STEP 32
 
 namespace ds
 {
-	static int power(int x, unsigned int y, int p)
+	/*
+		Hashtabelle mit offener Adressierung, deren Groesse zur Laufzeit waechst (Swiss-Table): zu jedem Eintrag gehoert ein
+		Kontrollbyte (leer, geloescht oder die unteren 7 Bit des Hashwerts). Eine Gruppe von 16 Kontrollbytes wird mit SSE2 in
+		einem Schritt verglichen, die Gruppen werden quadratisch sondiert. Die Tabelle waechst bei einem Fuellgrad von 7/8 auf die
+		doppelte Kapazitaet. Das Umkopieren geschieht inkrementell: jedes insert verschiebt HASHTABLE_MIGRATION_STEP Eintraege der
+		alten Tabelle, bis dahin sucht find in beiden Tabellen. Jeder Schluessel (auch 0) kann gespeichert werden.
+	*/
+	template<typename T>
+	class Hashtable
 	{
-		int res = 1;      // Initialize result
-		x = x % p;  // Update x if it is more than or
-					// equal to p
-		while (y > 0)
+	private:
+		struct Element
+		{
+			Integer m_key;
+			T* m_value;
+		};
+		struct Table
 		{
-			// If y is odd, multiply x with result
-			if (y & 1)
-				res = (res*x) % p;
+			//m_capacity + HASHTABLE_GROUP_SIZE bytes, the last group mirrors the first one, so a group can be loaded at every slot
+			uint8_t* m_control;
+			Element* m_content;
+			Integer m_capacity;
+			Integer m_numberOfElements;
+			Integer m_numberOfDeleted;
+		};
+		//receives every insert
+		Table m_table;
+		//the table, which is moved into m_table, m_old.m_capacity == 0 if no rehash is running
+		Table m_old;
+		//slots [0, ... , m_migrated - 1] of m_old are moved
+		Integer m_migrated;
 
-			// y must be even now
-			y = y >> 1; // y = y/2
-			x = (x*x) % p;
+		static Integer hash(Integer key)
+		{
+			uint64_t h = uint64_t(key) * 0x9E3779B97F4A7C15ULL;
+			return Integer(h ^ (h >> 32));
+		};
+		static uint8_t h2(Integer hash) { return uint8_t(hash & 0x7F); };
+		static Integer h1(Integer hash) { return hash >> 7; };
+		static Integer growthLimit(Integer capacity) { return capacity - capacity / 8; };
+		static uint32_t matchByte(const uint8_t* group, uint8_t value);
+		static uint32_t matchFree(const uint8_t* group);
+		static void allocate(Table& table, Integer capacity);
+		static void release(Table& table);
+		static void copy(Table& destination, const Table& source);
+		static void setControl(Table& table, Integer i, uint8_t value);
+		static Integer findSlot(const Table& table, Integer key, Integer h);
+		static void insertUnique(Table& table, Integer key, T* value, Integer h);
+		static T* eraseSlot(Table& table, Integer i);
+		void migrate(Integer slots);
+		void rehash(Integer capacity);
+	public:
+		Hashtable();
+		/*
+			Reserviert Platz fuer numberOfElements Eintraege.
+		*/
+		Hashtable(Integer numberOfElements);
+		Hashtable(const Hashtable& other);
+		Hashtable(Hashtable&& other);
+		Hashtable& operator=(const Hashtable& other);
+		Hashtable& operator=(Hashtable&& other);
+		~Hashtable();
+		T* find(Integer key) const;
+		bool containsKey(Integer key) const;
+		/*
+			Fuegt den Schluessel ein. Liefert false, falls der Schluessel bereits enthalten ist.
+		*/
+		bool insert(Integer key, T* value);
+		T* remove(Integer key);
+		/*
+			Vergroessert die Tabelle so, dass numberOfElements Eintraege ohne weiteres Wachstum Platz finden (kein inkrementelles Umkopieren).
+		*/
+		void reserve(Integer numberOfElements);
+		Integer size() const { return m_table.m_numberOfElements + m_old.m_numberOfElements; };
+		Integer capacity() const { return m_table.m_capacity; };
+	};
+	template<typename T>
+	inline uint32_t Hashtable<T>::matchByte(const uint8_t* group, uint8_t value)
+	{
+#ifdef HASHTABLE_SSE2
+		__m128i control = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+		return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(control, _mm_set1_epi8(char(value)))));
+#else
+		uint32_t result = 0;
+		for (uint32_t i = 0; i < HASHTABLE_GROUP_SIZE; i++)if (group[i] == value)result |= s_one32 << i;
+		return result;
+#endif
+	}
+	template<typename T>
+	inline uint32_t Hashtable<T>::matchFree(const uint8_t* group)
+	{
+		//empty and deleted are the only control bytes with the high bit set
+#ifdef HASHTABLE_SSE2
+		return uint32_t(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(group))));
+#else
+		uint32_t result = 0;
+		for (uint32_t i = 0; i < HASHTABLE_GROUP_SIZE; i++)if (group[i] & 0x80)result |= s_one32 << i;
+		return result;
+#endif
+	}
+	template<typename T>
+	inline void Hashtable<T>::allocate(Table& table, Integer capacity)
+	{
+		table.m_capacity = capacity;
+		table.m_numberOfElements = 0;
+		table.m_numberOfDeleted = 0;
+		if (capacity == 0)
+		{
+			table.m_control = nullptr;
+			table.m_content = nullptr;
+			return;
 		}
-		return res;
+		table.m_control = (uint8_t*)aligned_alloc(16, capacity + HASHTABLE_GROUP_SIZE);
+		table.m_content = (Element*)aligned_alloc(16, capacity * sizeof(Element));
+		for (Integer i = 0; i < capacity + HASHTABLE_GROUP_SIZE; i++)table.m_control[i] = HASHTABLE_EMPTY;
 	}
-
-	static bool miillerTest(int d, int n)
+	template<typename T>
+	inline void Hashtable<T>::release(Table& table)
 	{
-		// Pick a random number in [2..n-2]
-		// Corner cases make sure that n > 4
-		int a = 2 + rand() % (n - 4);
-
-		// Compute a^d % n
-		int x = power(a, d, n);
-
-		if (x == 1 || x == n - 1)
-			return true;
-
-		// Keep squaring x while one of the following doesn't
-		// happen
-		// (i)   d does not reach n-1
-		// (ii)  (x^2) % n is not 1
-		// (iii) (x^2) % n is not n-1
-		while (d != n - 1)
-		{
-			x = (x * x) % n;
-			d *= 2;
-
-			if (x == 1)      return false;
-			if (x == n - 1)    return true;
+		if (table.m_control)free(table.m_control);
+		if (table.m_content)free(table.m_content);
+		allocate(table, 0);
+	}
+	template<typename T>
+	inline void Hashtable<T>::copy(Table& destination, const Table& source)
+	{
+		allocate(destination, source.m_capacity);
+		if (source.m_capacity == 0)return;
+		for (Integer i = 0; i < source.m_capacity + HASHTABLE_GROUP_SIZE; i++)destination.m_control[i] = source.m_control[i];
+		for (Integer i = 0; i < source.m_capacity; i++)destination.m_content[i] = source.m_content[i];
+		destination.m_numberOfElements = source.m_numberOfElements;
+		destination.m_numberOfDeleted = source.m_numberOfDeleted;
+	}
+	template<typename T>
+	inline void Hashtable<T>::setControl(Table& table, Integer i, uint8_t value)
+	{
+		table.m_control[i] = value;
+		if (i < HASHTABLE_GROUP_SIZE)table.m_control[table.m_capacity + i] = value;
+	}
+	template<typename T>
+	inline Integer Hashtable<T>::findSlot(const Table& table, Integer key, Integer h)
+	{
+		if (table.m_capacity == 0)return ~Integer(0);
+		Integer mask = table.m_capacity - 1;
+		Integer position = h1(h) & mask;
+		//the distance grows by one group per step, this visits every group of a power of two table
+		for (Integer step = HASHTABLE_GROUP_SIZE; ; step += HASHTABLE_GROUP_SIZE)
+		{
+			const uint8_t* group = table.m_control + position;
+			uint32_t candidates = matchByte(group, h2(h));
+			while (candidates)
+			{
+				Integer i = (position + trailingZeros64(candidates)) & mask;
+				if (table.m_content[i].m_key == key)return i;
+				candidates &= candidates - 1;
+			}
+			if (matchByte(group, HASHTABLE_EMPTY))return ~Integer(0);
+			position = (position + step) & mask;
 		}
-
-		// Return composite
-		return false;
 	}
-
-	// It returns false if n is composite and returns true if n
-	// is probably prime.  k is an input parameter that determines
-	// accuracy level. Higher value of k indicates more accuracy.
-	static bool isPrime(int n, int k)
-	{
-		// Corner cases
-		if (n <= 1 || n == 4)  return false;
-		if (n <= 3) return true;
-
-		// Find r such that n = 2^d * r + 1 for some r >= 1
-		int d = n - 1;
-		while (d % 2 == 0)
-			d /= 2;
-
-		// Iterate given nber of 'k' times
-		for (int i = 0; i < k; i++)
-			if (miillerTest(d, n) == false)
-				return false;
-
+	template<typename T>
+	inline void Hashtable<T>::insertUnique(Table& table, Integer key, T* value, Integer h)
+	{
+		Integer mask = table.m_capacity - 1;
+		Integer position = h1(h) & mask;
+		uint32_t freeSlots = matchFree(table.m_control + position);
+		for (Integer step = HASHTABLE_GROUP_SIZE; !freeSlots; step += HASHTABLE_GROUP_SIZE)
+		{
+			position = (position + step) & mask;
+			freeSlots = matchFree(table.m_control + position);
+		}
+		Integer i = (position + trailingZeros64(freeSlots)) & mask;
+		if (table.m_control[i] == HASHTABLE_DELETED)table.m_numberOfDeleted--;
+		setControl(table, i, h2(h));
+		table.m_content[i].m_key = key;
+		table.m_content[i].m_value = value;
+		table.m_numberOfElements++;
+	}
+	template<typename T>
+	inline T * Hashtable<T>::eraseSlot(Table& table, Integer i)
+	{
+		T* ptr = table.m_content[i].m_value;
+		//the slot may become empty again, if every window of HASHTABLE_GROUP_SIZE slots around it contains an empty slot:
+		//then no probe sequence can have passed it
+		Integer before = (i - HASHTABLE_GROUP_SIZE) & (table.m_capacity - 1);
+		uint32_t emptyAfter = matchByte(table.m_control + i, HASHTABLE_EMPTY);
+		uint32_t emptyBefore = matchByte(table.m_control + before, HASHTABLE_EMPTY);
+		bool wasNeverFull = false;
+		if (emptyAfter && emptyBefore)
+		{
+			uint32_t fullBefore = 0;
+			while (!(emptyBefore & (s_one32 << (HASHTABLE_GROUP_SIZE - 1 - fullBefore))))fullBefore++;
+			wasNeverFull = trailingZeros64(emptyAfter) + fullBefore < HASHTABLE_GROUP_SIZE;
+		}
+		if (wasNeverFull)
+		{
+			setControl(table, i, HASHTABLE_EMPTY);
+		}
+		else
+		{
+			setControl(table, i, HASHTABLE_DELETED);
+			table.m_numberOfDeleted++;
+		}
+		table.m_content[i].m_value = nullptr;
+		table.m_numberOfElements--;
+		return ptr;
+	}
+	template<typename T>
+	inline void Hashtable<T>::migrate(Integer slots)
+	{
+		if (m_old.m_capacity == 0)return;
+		Integer last = m_migrated + slots < m_old.m_capacity ? m_migrated + slots : m_old.m_capacity;
+		for (; m_migrated < last; m_migrated++)
+		{
+			if (m_old.m_control[m_migrated] & 0x80)continue;
+			Element& element = m_old.m_content[m_migrated];
+			insertUnique(m_table, element.m_key, element.m_value, hash(element.m_key));
+			//moved elements leave the old table, so remove never has to look into both tables
+			setControl(m_old, m_migrated, HASHTABLE_DELETED);
+			m_old.m_numberOfElements--;
+		}
+		if (m_migrated == m_old.m_capacity)release(m_old);
+	}
+	template<typename T>
+	inline void Hashtable<T>::rehash(Integer capacity)
+	{
+		migrate(m_old.m_capacity);
+		m_old = m_table;
+		allocate(m_table, capacity);
+		m_migrated = 0;
+		if (m_old.m_capacity == 0)release(m_old);
+	}
+	template<typename T>
+	inline Hashtable<T>::Hashtable() : m_migrated(0)
+	{
+		allocate(m_table, 0);
+		allocate(m_old, 0);
+	}
+	template<typename T>
+	inline Hashtable<T>::Hashtable(Integer numberOfElements) : m_migrated(0)
+	{
+		allocate(m_table, 0);
+		allocate(m_old, 0);
+		reserve(numberOfElements);
+	}
+	template<typename T>
+	inline Hashtable<T>::Hashtable(const Hashtable& other) : m_migrated(0)
+	{
+		allocate(m_table, 0);
+		allocate(m_old, 0);
+		*this = other;
+	}
+	template<typename T>
+	inline Hashtable<T>::Hashtable(Hashtable&& other) : m_migrated(0)
+	{
+		allocate(m_table, 0);
+		allocate(m_old, 0);
+		*this = std::move(other);
+	}
+	template<typename T>
+	inline Hashtable<T>& Hashtable<T>::operator=(const Hashtable& other)
+	{
+		if (this == &other)return *this;
+		release(m_table);
+		release(m_old);
+		copy(m_table, other.m_table);
+		copy(m_old, other.m_old);
+		m_migrated = other.m_migrated;
+		return *this;
+	}
+	template<typename T>
+	inline Hashtable<T>& Hashtable<T>::operator=(Hashtable&& other)
+	{
+		if (this == &other)return *this;
+		release(m_table);
+		release(m_old);
+		m_table = other.m_table;
+		m_old = other.m_old;
+		m_migrated = other.m_migrated;
+		allocate(other.m_table, 0);
+		allocate(other.m_old, 0);
+		other.m_migrated = 0;
+		return *this;
+	}
+	template<typename T>
+	inline Hashtable<T>::~Hashtable()
+	{
+		release(m_table);
+		release(m_old);
+	}
+	template<typename T>
+	inline T * Hashtable<T>::find(Integer key) const
+	{
+		Integer h = hash(key);
+		Integer i = findSlot(m_table, key, h);
+		if (i != ~Integer(0))return m_table.m_content[i].m_value;
+		if (m_old.m_capacity == 0)return nullptr;
+		i = findSlot(m_old, key, h);
+		return i != ~Integer(0) ? m_old.m_content[i].m_value : nullptr;
+	}
+	template<typename T>
+	inline bool Hashtable<T>::containsKey(Integer key) const
+	{
+		Integer h = hash(key);
+		return findSlot(m_table, key, h) != ~Integer(0) || findSlot(m_old, key, h) != ~Integer(0);
+	}
+	template<typename T>
+	inline bool Hashtable<T>::insert(Integer key, T * value)
+	{
+		Integer h = hash(key);
+		if (findSlot(m_table, key, h) != ~Integer(0) || findSlot(m_old, key, h) != ~Integer(0))return false;
+		if (m_table.m_numberOfElements + m_table.m_numberOfDeleted + 1 > growthLimit(m_table.m_capacity))
+		{
+			Integer capacity = m_table.m_capacity < HASHTABLE_MIN_CAPACITY ? HASHTABLE_MIN_CAPACITY : m_table.m_capacity;
+			//mostly tombstones: rebuild with the same capacity instead of growing
+			if ((m_table.m_numberOfElements + m_old.m_numberOfElements + 1) * 2 > growthLimit(capacity))capacity *= 2;
+			rehash(capacity);
+		}
+		migrate(HASHTABLE_MIGRATION_STEP);
+		insertUnique(m_table, key, value, h);
 		return true;
 	}
+	template<typename T>
+	inline T * Hashtable<T>::remove(Integer key)
+	{
+		Integer h = hash(key);
+		Integer i = findSlot(m_table, key, h);
+		if (i != ~Integer(0))return eraseSlot(m_table, i);
+		i = findSlot(m_old, key, h);
+		if (i != ~Integer(0))return eraseSlot(m_old, i);
+		return nullptr;
+	}
+	template<typename T>
+	inline void Hashtable<T>::reserve(Integer numberOfElements)
+	{
+		if (numberOfElements < size())numberOfElements = size();
+		if (numberOfElements + m_table.m_numberOfDeleted <= growthLimit(m_table.m_capacity))return;
+		Integer capacity = HASHTABLE_MIN_CAPACITY;
+		while (growthLimit(capacity) < numberOfElements)capacity *= 2;
+		rehash(capacity);
+		migrate(m_old.m_capacity);
+	}
 
 	/*
-		Einfache Implementierung einer Hashtabelle mit offener Adressierung. Die Tabelle ist Cache-freundlich und besitzt eine feste Groesse.
+		Hashtabelle mit offener Adressierung (lineares Sondieren) und fester Groesse fuer den gleichzeitigen Zugriff mehrerer Threads.
+		Jeder Eintrag besteht aus einem atomaren Schluessel und einem atomaren Zeiger auf den Wert, es werden keine Sperren verwendet.
+		- find ist wait-free: hoechstens t_size Eintraege werden gelesen, die Suche endet am ersten leeren Eintrag.
+		- insert ist lock-free: ein leerer Eintrag wird per CAS auf dem Schluessel belegt, danach wird der Wert per CAS veroeffentlicht.
+		- remove setzt nur den Wert auf nullptr. Der Schluessel bleibt als Grabstein (Tombstone) stehen, damit die Sondierungsketten
+		  anderer Schluessel erhalten bleiben. Ein erneutes insert desselben Schluessels verwendet den Grabstein wieder.
+		- Ein Grabstein wird nie fuer einen anderen Schluessel frei: das Umschreiben des Schluessels wuerde mit einem gleichzeitigen
+		  insert des alten Schluessels kollidieren. Jeder Schluessel, der je eingefuegt wurde, belegt seinen Eintrag bis zur Zerstoerung
+		  der Tabelle. Bei wechselnden Schluesseln (insert/remove) schlaegt insert daher fehl, sobald t_size verschiedene Schluessel
+		  eingefuegt wurden, auch wenn size() klein ist. Die Tabelle eignet sich fuer eine beschraenkte Schluesselmenge, sonst ist Hashtable zu nehmen.
+		Der Schluessel 0 kennzeichnet einen leeren Eintrag und kann nicht gespeichert werden.
 	*/
 	template<typename T, Integer t_size>
-	class Hashtable
+	class ConcurrentHashtable
 	{
 	private:
-		template<typename A>
-		class Element
-		{
-		public:
-			Element() : m_key(0), m_value(nullptr) {};
-			Element(const Element& other) { *this = other; }
-			Element& operator=(const Element& other) { if (this == &other)return *this; m_key = other.m_kay; m_value = other.m_value; return *this; };
-			Integer m_key;
-			A* m_value;
-		};
-		Integer m_numberOfElements;
-		Element<T> m_content[t_size];
-#if isPrime(t_size, PRIMETESTS) || (t_size & Integer(1) == 0)
-		Integer h1(Integer key) const 
+		struct Element
 		{
-			return key > t_size ? key % t_size : key;
-		};
-
-		Integer h2(Integer key) const
-		{
-
-#if isPrime(t_size, PRIMETESTS)
-			return Integer(1) + (key > t_size - 1 ? key % (t_size - 1) : key);
-#else 
-			Integer result = key > t_size ? key % t_size : key;
-			return result & Integer(1) == 0 ? result + 1 : result;
-#endif		
+			std::atomic<Integer> m_key;
+			std::atomic<T*> m_value;
 		};
-#endif	
-
-#if isPrime(t_size, PRIMETESTS) || (t_size & Integer(1) == 0)
-		Integer hash(Integer key, Integer i) const { return (h1(key) + i * h2(key)) % t_size; };
-#else 
-		Integer hash(Integer key) const { return key % t_size; };
-#endif
+		std::atomic<Integer> m_numberOfElements;
+		Element m_content[t_size];
+		static_assert(uint64_t(t_size) <= (uint64_t(1) << 32), "t_size has to be at most 2^32");
+		//fibonacci hashing: the high bits of the product depend on every bit of the key, they are scaled to [0, t_size).
+		//for t_size = 2^k this is (key * C) >> (64 - k), so consecutive keys do not share their probe sequences
+		static Integer hash(Integer key) { return Integer((((uint64_t(key) * 0x9E3779B97F4A7C15ULL) >> 32) * uint64_t(t_size)) >> 32); };
+		ConcurrentHashtable(const ConcurrentHashtable& other) = delete;
+		ConcurrentHashtable& operator=(const ConcurrentHashtable& other) = delete;
 	public:
-		Hashtable() : m_numberOfElements(0) 
-		{ 
+		ConcurrentHashtable() : m_numberOfElements(0)
+		{
+			for (Integer i = 0; i < t_size; i++)
+			{
+				m_content[i].m_key.store(0, std::memory_order_relaxed);
+				m_content[i].m_value.store(nullptr, std::memory_order_relaxed);
+			}
 		};
-		Hashtable(const Hashtable& other) { *this = other; };
-		Hashtable& operator=(const Hashtable& other) { if (this == &other)return *this; for (Integer i = 0; i < t_size; i++)m_content[i] = other.m_content[i]; m_numberOfElements = other.m_numberOfElements; return *this; };
 		T* find(Integer key) const;
 		bool containsKey(Integer key) const;
+		/*
+			Fuegt den Schluessel ein. Liefert false, falls der Schluessel bereits einen Wert besitzt oder kein Eintrag mehr frei ist
+			(Grabsteine anderer Schluessel zaehlen als belegt, siehe oben).
+		*/
 		bool insert(Integer key, T* value);
 		T* remove(Integer key);
+		Integer size() const { return m_numberOfElements.load(std::memory_order_relaxed); };
+		Integer capacity() const { return t_size; };
 	};
 	template<typename T, Integer t_size>
-	inline T * Hashtable<T, t_size>::find(Integer key) const
+	inline T * ConcurrentHashtable<T, t_size>::find(Integer key) const
 	{
-		Integer h;
-		Integer i = 0;
-		while (i < t_size)
+		Integer h = hash(key);
+		for (Integer i = 0; i < t_size; i++)
 		{
-#if isPrime(t_size, PRIMETESTS) || (t_size & Integer(1) == 0)
-			h = hash(key, i); if (m_content[h].m_key == key)
-			{
-				return m_content[h].m_value;
-			}
-#else 
-			h = hash(key);
-			if (m_content[h].m_key == key)
-			{
-				return m_content[h].m_value;
-			}
-			else
-			{
-				h++;
-				h = h > t_size ? h % t_size : h;
-			}
-#endif
-			i++; 
+			Integer current = m_content[h].m_key.load(std::memory_order_relaxed);
+			if (current == key)return m_content[h].m_value.load(std::memory_order_acquire);
+			if (current == 0)return nullptr;
+			h = h + 1 == t_size ? 0 : h + 1;
 		}
 		return nullptr;
 	}
 	template<typename T, Integer t_size>
-	inline bool Hashtable<T, t_size>::containsKey(Integer key) const
+	inline bool ConcurrentHashtable<T, t_size>::containsKey(Integer key) const
 	{
 		return find(key) != nullptr;
 	}
 	template<typename T, Integer t_size>
-	inline bool Hashtable<T, t_size>::insert(Integer key, T * value)
+	inline bool ConcurrentHashtable<T, t_size>::insert(Integer key, T * value)
 	{
-		if (m_numberOfElements > t_size - 1) throw 1;
-		if (!containsKey(key))
+		Integer h = hash(key);
+		for (Integer i = 0; i < t_size; i++)
 		{
-			Integer h;
-			Integer i = 0;
-#if isPrime(t_size, PRIMETESTS) || (t_size & Integer(1) == 0)
-			while (i < t_size)
+			Integer current = m_content[h].m_key.load(std::memory_order_relaxed);
+			if (current == 0)
 			{
-				h = hash(key, i);
-				if (m_content[h].m_key == 0)
-				{
-					m_content[h].m_key = key;
-					m_content[h].m_value = value;
-					break;
-				}
-				i++;
+				//on failure current holds the key of the thread, which won the slot
+				if (m_content[h].m_key.compare_exchange_strong(current, key, std::memory_order_relaxed))current = key;
 			}
-			m_numberOfElements++;
-			return true;
-#else 
-			h = hash(key);
-			while (i < t_size)
+			if (current == key)
 			{
-				if (m_content[h].m_key == 0)
-				{
-					m_content[h].m_key = key;
-					m_content[h].m_value = value;
-					break;
-				}
-				else
-				{
-					h++;
-					h = h > t_size ? h % t_size : h;
-				}
-				i++;
+				T* expected = nullptr;
+				if (!m_content[h].m_value.compare_exchange_strong(expected, value, std::memory_order_release, std::memory_order_relaxed))return false;
+				m_numberOfElements.fetch_add(1, std::memory_order_relaxed);
+				return true;
 			}
-			m_numberOfElements++;
-			return true;
-#endif
+			h = h + 1 == t_size ? 0 : h + 1;
 		}
 		return false;
 	}
 	template<typename T, Integer t_size>
-	inline T * Hashtable<T, t_size>::remove(Integer key)
-	{
-		if (m_numberOfElements == 0) return nullptr;
-		Integer h;
-		Integer i = 0;
-		T* ptr = nullptr;
-		while (i < t_size) 
-		{ 
-#if isPrime(t_size, PRIMETESTS) || (t_size & Integer(1) == 0)
-			h = hash(key, i);
-			if (m_content[h].m_key == key)
-			{
-				m_content[h].m_key = 0;
-				ptr = m_content[h].m_value;
-				m_content[h].m_value = nullptr;
-				m_numberOfElements--;
-				return ptr;
-			}
-#else 
-			h = hash(key);
-			if (m_content[h].m_key == key)
+	inline T * ConcurrentHashtable<T, t_size>::remove(Integer key)
+	{
+		Integer h = hash(key);
+		for (Integer i = 0; i < t_size; i++)
+		{
+			Integer current = m_content[h].m_key.load(std::memory_order_relaxed);
+			if (current == key)
 			{
-				m_content[h].m_key = 0;
-				ptr = m_content[h].m_value;
-				m_content[h].m_value = nullptr;
-				m_numberOfElements--;
+				T* ptr = m_content[h].m_value.exchange(nullptr, std::memory_order_acq_rel);
+				if (ptr)m_numberOfElements.fetch_sub(1, std::memory_order_relaxed);
 				return ptr;
 			}
-			else
-			{
-				h++;
-				h = h > t_size ? h % t_size : h;
-			}
-#endif	
-			i++; 
+			if (current == 0)return nullptr;
+			h = h + 1 == t_size ? 0 : h + 1;
 		}
-		return ptr;
+		return nullptr;
 	}
 };
 
@@ -21,7 +21,7 @@
 #include <vector>
 
 #define DEBUG 1
-//#define SIMD 1
+#define SIMD 1
 
 #ifdef LINUX
 	
@@ -0,0 +1,185 @@
+#ifndef __NODEARENA_H__
+
+#define __NODEARENA_H__
+
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <vector>
+#include "bitmanipulation.h"
+
+/*
+	Every thread, which allocates from a NodeArena, works on one of NODE_ARENA_THREAD_SLOTS slots (bump range and free list).
+	The blocks grow geometrically from NODE_ARENA_FIRST_BLOCK to NODE_ARENA_MAX_BLOCK bytes.
+*/
+#define NODE_ARENA_THREAD_SLOTS 16
+#define NODE_ARENA_FIRST_BLOCK 4096
+#define NODE_ARENA_MAX_BLOCK (1 << 20)
+#define NODE_ARENA_ALIGNMENT 64
+
+namespace ds
+{
+	/**
+	Node allocator of the node based containers (BinaryTree, AVLTree), which forwards every node to operator new and delete.
+	A node allocator is constructed with the size and alignment of the node type and provides allocate() and deallocate(node).
+	s_bulkRelease tells the container, that the allocator frees all its nodes on destruction, so a tree with trivially
+	destructible nodes does not have to visit them.
+	*/
+	class HeapNodeAllocator
+	{
+	private:
+		Integer m_nodeBytes;
+	public:
+		static const bool s_bulkRelease = false;
+
+		//operator new aligns for every fundamental type, so the alignment of the node is not needed
+		HeapNodeAllocator(Integer nodeBytes, Integer /*nodeAlignment*/) : m_nodeBytes(nodeBytes) {}
+		void* allocate() { return ::operator new(size_t(m_nodeBytes)); }
+		void deallocate(void* node) { ::operator delete(node); }
+		Integer byteSize() const { return 0; }
+	};
+
+	/**
+	Arena for nodes of one fixed size. Nodes are cut from contiguous blocks with a bump pointer, so nodes allocated one after
+	another are neighbours in memory. Freed nodes are kept in a free list and reused by the next allocations. Bump range and
+	free list exist once per thread slot: threads only share a slot, if more than NODE_ARENA_THREAD_SLOTS threads use the
+	arena, and a slot is protected by a spin lock, which is uncontended otherwise. Only the allocation of a new block takes a
+	mutex. The memory is returned to the system when the arena is destroyed, there is no per node free.
+	*/
+	class NodeArena
+	{
+	private:
+		//one slot per cache line, the slots of different threads must not share a line
+		struct alignas(NODE_ARENA_ALIGNMENT) Slot
+		{
+			std::atomic_flag m_lock;
+			char* m_cursor;
+			char* m_end;
+			void* m_free;
+		};
+
+		//a block of its own, so the slots stay aligned, even if the arena is part of an object created with new
+		Slot* m_slots;
+		std::mutex m_mutex;
+		std::vector<void*> m_blocks;
+		Integer m_blockBytes;
+		Integer m_allocatedBytes;
+		Integer m_nodeBytes;
+
+		NodeArena(const NodeArena& other) = delete;
+		NodeArena& operator=(const NodeArena& other) = delete;
+
+		static Integer threadSlot()
+		{
+			static std::atomic<Integer> s_nextSlot(0);
+			static thread_local Integer s_slot = s_nextSlot++ % NODE_ARENA_THREAD_SLOTS;
+			return s_slot;
+		}
+
+		/**
+		Description: 	Gives the slot a fresh block, the rest of the previous block is not used any more.
+		*/
+		void refill(Slot& slot)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			Integer bytes = m_blockBytes < m_nodeBytes ? m_nodeBytes : m_blockBytes;
+			if (m_blockBytes < NODE_ARENA_MAX_BLOCK)m_blockBytes *= 2;
+			char* block = static_cast<char*>(aligned_alloc(NODE_ARENA_ALIGNMENT, bytes));
+			if (!block)throw std::bad_alloc();
+			m_blocks.push_back(block);
+			m_allocatedBytes += bytes;
+			slot.m_cursor = block;
+			slot.m_end = block + bytes;
+		}
+	public:
+		static const bool s_bulkRelease = true;
+
+		/**
+		Description: 	Creates an empty arena, the first block is allocated by the first allocate.
+		Parameter:		nodeBytes		- The size of one node.
+						nodeAlignment	- The alignment of the node type, has to divide NODE_ARENA_ALIGNMENT.
+		*/
+		NodeArena(Integer nodeBytes, Integer nodeAlignment) : m_blockBytes(NODE_ARENA_FIRST_BLOCK), m_allocatedBytes(0)
+		{
+			//a free node stores the link of the free list
+			Integer alignment = nodeAlignment < sizeof(void*) ? sizeof(void*) : nodeAlignment;
+			if (nodeBytes < sizeof(void*))nodeBytes = sizeof(void*);
+			m_nodeBytes = (nodeBytes + alignment - 1) / alignment * alignment;
+			m_slots = static_cast<Slot*>(aligned_alloc(NODE_ARENA_ALIGNMENT, NODE_ARENA_THREAD_SLOTS * sizeof(Slot)));
+			if (!m_slots)throw std::bad_alloc();
+			for (Integer i = 0; i < NODE_ARENA_THREAD_SLOTS; i++)
+			{
+				new (&m_slots[i]) Slot();
+				m_slots[i].m_lock.clear();
+				m_slots[i].m_cursor = nullptr;
+				m_slots[i].m_end = nullptr;
+				m_slots[i].m_free = nullptr;
+			}
+		}
+
+		/**
+		Description: 	Frees all blocks at once. The destructors of the nodes are not called.
+		*/
+		~NodeArena()
+		{
+			for (void* block : m_blocks)free(block);
+			free(m_slots);
+		}
+
+		/**
+		Description: 	Returns uninitialized memory for one node, preferably a node freed before by this thread.
+		Complexity: 	O(1), a mutex is only taken once per block.
+		*/
+		void* allocate()
+		{
+			Slot& slot = m_slots[threadSlot()];
+			while (slot.m_lock.test_and_set(std::memory_order_acquire));
+			void* node = slot.m_free;
+			if (node)
+			{
+				slot.m_free = *static_cast<void**>(node);
+			}
+			else
+			{
+				if (Integer(slot.m_end - slot.m_cursor) < m_nodeBytes)
+				{
+					//refill throws std::bad_alloc, the slot must not stay locked then
+					try
+					{
+						refill(slot);
+					}
+					catch (...)
+					{
+						slot.m_lock.clear(std::memory_order_release);
+						throw;
+					}
+				}
+				node = slot.m_cursor;
+				slot.m_cursor += m_nodeBytes;
+			}
+			slot.m_lock.clear(std::memory_order_release);
+			return node;
+		}
+
+		/**
+		Description: 	Puts node into the free list of the calling thread.
+		Preconditions:	node was returned by allocate of this arena and its destructor has already been called.
+		Complexity: 	O(1).
+		*/
+		void deallocate(void* node)
+		{
+			Slot& slot = m_slots[threadSlot()];
+			while (slot.m_lock.test_and_set(std::memory_order_acquire));
+			*static_cast<void**>(node) = slot.m_free;
+			slot.m_free = node;
+			slot.m_lock.clear(std::memory_order_release);
+		}
+
+		/**
+		Description: 	The memory held by the blocks of the arena.
+		*/
+		Integer byteSize() const { return m_allocatedBytes; }
+	};
+}
+
+#endif // !__NODEARENA_H__
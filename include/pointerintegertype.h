@@ -13,15 +13,22 @@ namespace ds
 	// ungenutzt bleiben. Die ungenutzten Bits befinden sich immer am "Ende" 
 	// (least significant bits) des Pointers.
 	//////////////////////////////////////////////////////////////////////////////////
+	constexpr static Integer integerLog2(Integer x) noexcept { return x <= 1 ? 0 : 1 + integerLog2(x >> 1); };
 	template<typename A>
-	constexpr static Integer freeBitsForType() noexcept { return log2(alignof(A)); };
+	constexpr static Integer freeBitsForType() noexcept { return integerLog2(alignof(A)); };
+	//////////////////////////////////////////////////////////////////////////////////
+	// \brief Maske der freien Bits eines Pointers auf A, unabhaengig von den
+	// Maskentabellen aus bitmanipulation.h.
+	//////////////////////////////////////////////////////////////////////////////////
+	template<typename A>
+	constexpr static uintptr_t pointerTagMask() noexcept { return (uintptr_t(1) << freeBitsForType<A>()) - 1; };
 
 #ifdef POINTERSIZE == 64
 	template<typename T>
 	constexpr static T* createPointerIntegerType(T* ptr, Integer i)
 	{
-		if(ptr == nullptr) return reinterpret_cast<T*>(i & ds::createIntegerMask(freeBitsForType<T>()));
-		uint64_t result = reinterpret_cast<uint64_t>(ptr) | i & ds::createIntegerMask(freeBitsForType<T>());
+		if(ptr == nullptr) return reinterpret_cast<T*>(i & pointerTagMask<T>());
+		uint64_t result = reinterpret_cast<uint64_t>(ptr) | i & pointerTagMask<T>();
 		return reinterpret_cast<T*>(result);
 	};
 	//////////////////////////////////////////////////////////////////////////////////
@@ -31,7 +38,7 @@ namespace ds
 	template<typename T>
 	constexpr static T* pointerIntegerType_getPointerContent(T* ptr) noexcept
 	{
-		uint64_t mask = (~uint64_t(ds::createIntegerMask(freeBitsForType<T>())));
+		uint64_t mask = (~uint64_t(pointerTagMask<T>()));
 		uint64_t convptr = reinterpret_cast<uint64_t>(ptr);
 		return reinterpret_cast<T*>(convptr & mask);
 	};
@@ -42,15 +49,15 @@ namespace ds
 	template<typename T>
 	constexpr static Integer pointerIntegerType_getIntegerContent(T* ptr) noexcept
 	{
-		uint64_t mask = uint64_t(ds::createIntegerMask(freeBitsForType<T>()));
+		uint64_t mask = uint64_t(pointerTagMask<T>());
 		return reinterpret_cast<uint64_t>(ptr) & mask;
 	};
 #elif POINTERSIZE == 32
 	template<typename T>
 	constexpr static T* createPointerIntegerType(T* ptr, Integer i)
 	{
-		if (ptr == nullptr) return reinterpret_cast<T*>(i & ds::createIntegerMask(freeBitsForType<T>()));
-		uint32_t result = reinterpret_cast<uint32_t>(ptr) | i & ds::createIntegerMask(freeBitsForType<T>());
+		if (ptr == nullptr) return reinterpret_cast<T*>(i & pointerTagMask<T>());
+		uint32_t result = reinterpret_cast<uint32_t>(ptr) | i & pointerTagMask<T>();
 		return reinterpret_cast<T*>(result);
 	};
 	//////////////////////////////////////////////////////////////////////////////////
@@ -60,7 +67,7 @@ namespace ds
 	template<typename T>
 	constexpr static T* pointerIntegerType_getPointerContent(T* ptr) noexcept
 	{
-		uint32_t mask = (~uint32_t(ds::createIntegerMask(freeBitsForType<T>())));
+		uint32_t mask = (~uint32_t(pointerTagMask<T>()));
 		uint32_t convptr = reinterpret_cast<uint32_t>(ptr);
 		return reinterpret_cast<T*>(convptr & mask);
 	};
@@ -71,7 +78,7 @@ namespace ds
 	template<typename T>
 	constexpr static Integer pointerIntegerType_getIntegerContent(T* ptr) noexcept
 	{
-		uint32_t mask = uint32_t(ds::createIntegerMask(freeBitsForType<T>()));
+		uint32_t mask = uint32_t(pointerTagMask<T>());
 		return reinterpret_cast<uint32_t>(ptr) & mask;
 	};
 #else 
@@ -127,7 +134,7 @@ namespace ds
 		};
 		PointerIntegerType(const PointerIntegerType<T>& other)
 		{
-			m_ptr = other.m_ptr
+			m_ptr = other.m_ptr;
 		};
 		PointerIntegerType<T>& operator=(const PointerIntegerType<T>& other) noexcept
 		{
@@ -138,7 +145,7 @@ namespace ds
 		//////////////////////////////////////////////////////////////////////////////////
 		// \brief Der D'tor loescht die am Pointer haengende Instanz NICHT!
 		//////////////////////////////////////////////////////////////////////////////////
-		~PointerIntegerType() {};
+		~PointerIntegerType() = default;
 		//////////////////////////////////////////////////////////////////////////////////
 		// \brief Berechnet den codierten Integer-Wert.
 		// \return Integer - Integerwert der Datenstruktur.
@@ -150,6 +157,14 @@ namespace ds
 		//////////////////////////////////////////////////////////////////////////////////
 		T* pointerContent()  const noexcept { return pointerIntegerType_getPointerContent(m_ptr); };
 		//////////////////////////////////////////////////////////////////////////////////
+		// \brief Ersetzt den Integer-Wert, der Pointer bleibt erhalten.
+		//////////////////////////////////////////////////////////////////////////////////
+		void setIntegerContent(Integer integercontent) noexcept { m_ptr = createPointerIntegerType<T>(pointerContent(), integercontent); };
+		//////////////////////////////////////////////////////////////////////////////////
+		// \brief Ersetzt den Pointer, der Integer-Wert bleibt erhalten.
+		//////////////////////////////////////////////////////////////////////////////////
+		void setPointerContent(T* ptrcontent) noexcept { m_ptr = createPointerIntegerType<T>(ptrcontent, integerContent()); };
+		//////////////////////////////////////////////////////////////////////////////////
 		// \brief Gibt die Anzahl der fuer einen Integer nutzbaren Bits zurueck.
 		// \return Integer - Anzahl der nutzbaren Bits fuer einen Integer.
 		//////////////////////////////////////////////////////////////////////////////////
@@ -160,7 +175,7 @@ namespace ds
 		// \return Integer - [0,...,max] Der Maximalwert, den ein Integer in dieser Datenstruktur
 		// annehmen kann.
 		//////////////////////////////////////////////////////////////////////////////////
-		constexpr Integer maxIntegerValue() const noexcept { return pow(Integer(2), freeBitsForType<T>()) - Integer(1); };
+		constexpr Integer maxIntegerValue() const noexcept { return (Integer(1) << freeBitsForType<T>()) - Integer(1); };
 	};
 };
 
@@ -0,0 +1,85 @@
+#ifndef __SIMD_H__
+
+#define __SIMD_H__
+
+#include "bitmanipulation.h"
+
+/*
+	Functions compiled for a higher instruction set than the rest of the library. They may only be called
+	after the instruction set was detected at runtime (see detectInstructionSet).
+*/
+#if __GNUC__
+	#define SIMD_TARGET(x) __attribute__((target(x)))
+#else
+	#define SIMD_TARGET(x)
+#endif
+
+/*
+	Largest tau the vector kernels decode. Every element plus its bit offset inside a byte has to fit into one 32 bit lane.
+*/
+#define SIMD_MAX_TAU 25
+
+/*
+	Smallest number of elements the vector kernels decode. Setting up the shuffle and shift masks costs more than decoding
+	a few elements with the scalar kernels, single element reads (Array, EliasFano) stay on the scalar path.
+*/
+#define SIMD_MIN_ELEMENTS 64
+
+namespace ds
+{
+	/**
+	The instruction sets for which vectorized kernels exist, ordered by their width.
+	*/
+	enum class InstructionSet : uint8_t
+	{
+		Scalar = 0,
+		SSE42 = 1,
+		AVX2 = 2,
+		AVX512 = 3
+	};
+
+	/**
+	Description: 	Queries CPUID (and the operating system support for the vector registers) for the widest usable instruction set.
+	Result:			The widest instruction set, which can be executed on this machine.
+	Complexity: 	O(1), the result is computed once and cached.
+	*/
+	InstructionSet detectInstructionSet();
+
+	/**
+	Description: 	Returns the instruction set, which is used by "unpackSimd".
+	Result:			The detected instruction set or the one chosen by "setInstructionSet".
+	*/
+	InstructionSet instructionSet();
+
+	/**
+	Description: 	Overrides the instruction set, which is used by "unpackSimd". Mainly used to compare the kernels against the scalar fallback.
+	Parameter:		set - The desired instruction set. Sets wider than the detected one are reduced to the detected one.
+	Postconditions: instructionSet() <= detectInstructionSet().
+	*/
+	void setInstructionSet(InstructionSet set);
+
+	/**
+	Description: 	Decodes the elements [first, ... , first + n - 1] of a tightly packed array with tau bits per element.
+					Runs of 4 (SSE4.2), 8 (AVX2) or 16 (AVX-512) elements are gathered into 32 bit lanes with a byte shuffle
+					and aligned with a per lane shift. Elements outside of full runs, tau > SIMD_MAX_TAU, n < SIMD_MIN_ELEMENTS
+					and the scalar instruction set are served by "unpack" from bitmanipulation.h.
+	Parameter:		set 	- The instruction set, which should be used.
+					src		- The array in which the blocks are stored.
+					tau		- The bitlength of each element, 1 <= tau <= IntegerBitSize.
+					first	- The index of the first element.
+					n		- The number of elements to decode.
+					out		- The destination, receives n values.
+	Preconditions:	src has to store at least (first + n) * tau bits. set <= detectInstructionSet().
+	Postconditions: out[k] is equal to the element first + k for all k in [0, ... , n - 1].
+	Result:			--
+	Complexity: 	This function decodes in O(n) time and with O(1) bits of workspace n elements.
+	*/
+	void unpackSimd(InstructionSet set, const Integer* src, Integer tau, Integer first, Integer n, uint64_t* out);
+
+	/**
+	Description: 	See above, uses instructionSet().
+	*/
+	void unpackSimd(const Integer* src, Integer tau, Integer first, Integer n, uint64_t* out);
+};
+
+#endif // !__SIMD_H__
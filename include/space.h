@@ -2,6 +2,15 @@
 #define __SPACE_H__
 
 #include "includes.h"
+#include "simd.h"
+#include "array.h"
+#include "bitstring.h"
+#include "fileformat.h"
+
+/*
+	Number of integers per block of a BlockCodec.
+*/
+#define BLOCK_CODEC_SIZE 128
 
 namespace ds
 {
@@ -37,7 +46,50 @@ namespace ds
 		{
 			setBlock64(i * tau, tau, value, array);
 		}
+		/**
+			Decodes the elements [first, ... , first + n - 1] into out with the vector kernels of simd.h.
+		*/
+		void getRange(uint64_t first, uint64_t n, uint64_t* out) const
+		{
+			if(!array || tau == 0 || tau > IntegerBitSize)return;
+			unpackSimd(reinterpret_cast<const Integer*>(array), tau, first, n, out);
+		}
+		/**
+			Description: 	Writes the elements as packed file (see fileformat.h) to path.
+			Result:			true, if the file was written completely. false, if it could not be written or the ArrayType is compressed.
+		*/
+		bool save(const std::string& path) const
+		{
+			if(compressed)return false;
+			return writePackedFile(path, PackedFileType::ArrayType, sizeof(uint64_t), tau, numberOfElements, array, length * sizeof(uint64_t));
+		}
+		/**
+			Description: 	Replaces the elements with a packed file, which is mapped copy-on-write: the words are used in place,
+							pages are loaded on first access and shared between processes mapping the same file. set only changes
+							the private copy of a page.
+			Parameter:		path	- The file.
+							verify	- Recompute the checksum, this touches every page.
+			Result:			true on success. false, if the file can not be mapped or is no packed ArrayType, the ArrayType is unchanged then.
+		*/
+		bool mapFile(const std::string& path, bool verify = false)
+		{
+			PackedFileHeader header;
+			std::shared_ptr<MappedFile> file = mapPackedFile(path, PackedFileType::ArrayType, sizeof(uint64_t), header, verify);
+			if(!file)return false;
+			uint64_t words = header.payloadBytes / sizeof(uint64_t);
+			if(header.tau == 0 || header.tau > 64 || words == 0 || words * 64 < header.numberOfElements * header.tau)return false;
+			if(array && !mapping)free(array);
+			array = reinterpret_cast<uint64_t*>(file->data() + PACKED_FILE_ALIGNMENT);
+			mapping = file;
+			tau = header.tau;
+			numberOfElements = header.numberOfElements;
+			length = words;
+			compressed = false;
+			return true;
+		}
 		uint64_t* array;
+		//set, if array points into a mapped file
+		std::shared_ptr<MappedFile> mapping;
 		uint64_t tau;
 		uint64_t numberOfElements;
 		uint64_t length;
@@ -47,7 +99,7 @@ namespace ds
 		{
 			return compressed;
 		}
-		operator[](uint64_t i)
+		uint64_t operator[](uint64_t i) const
 		{
 			return getBlock64(i * tau, tau, array);
 		}
@@ -56,7 +108,7 @@ namespace ds
 	static bool isSorted(const ArrayType& a)
 	{
 		uint64_t n = a.numberOfElements;
-		for(uint64_t i = 0;i < n - 1;i++)
+		for(uint64_t i = 0;i + 1 < n;i++)
 		{
 			if(a[i] > a[i+1])
 			{
@@ -88,7 +140,8 @@ namespace ds
 		end = end >= numberOfElements ? end - 1 : end;			
 		
 		uint64_t mid = 0;
-		uint64_t mask = ((cast64(1) << length) - 1) << (a.tau - 1);
+		//the highest of the tau bits
+		uint64_t mask = cast64(1) << (a.tau - 1);
 		
 		uint64_t i = start;
 		while(i < end && (a[i] & mask) == 0)
@@ -136,7 +189,8 @@ namespace ds
 		end = end >= numberOfElements ? end - 1 : end;	
 		
 		uint64_t var;
-		uint64_t mask = ((cast64(1) << length) - 1) << (a.tau - 1);
+		//the highest of the tau bits
+		uint64_t mask = cast64(1) << (a.tau - 1);
 		uint64_t step = (end - 1) * (tau - 1);
 		uint64_t i = end - 1;
 		while(i >= mid)
@@ -159,6 +213,425 @@ namespace ds
 		
 		a.compressed = false;
 	}
+
+	/**
+		Elias-Fano representation of a sorted sequence of n integers from [0, universe). The lowest "tau" = floor(log2(universe / n))
+		bits of every integer are stored in an Array, the remaining high bits are stored unary in a Bitstring: the i-th integer sets
+		the bit (x_i >> tau) + i. This needs n * (tau + 2) + o(n) bits instead of n * log2(universe) bits of a plain ArrayType.
+	*/
+	class EliasFano
+	{
+	private:
+		Array m_lowBits;
+		Bitstring m_highBits;
+		uint64_t m_numberOfElements;
+		uint64_t m_universe;
+		uint64_t m_tau;
+
+		static uint64_t lowBitsFor(uint64_t numberOfElements, uint64_t universe)
+		{
+			if (numberOfElements == 0)return 0;
+			uint64_t ratio = universe / numberOfElements;
+			uint64_t tau = 0;
+			while (ratio >> (tau + 1))tau++;
+			return tau;
+		}
+
+		template<typename It>
+		static uint64_t universeOf(It first, It last)
+		{
+			uint64_t universe = 0;
+			for (; first != last; ++first)universe = uint64_t(*first) + 1;
+			return universe;
+		}
+
+		static uint64_t universeOf(const ArrayType& a)
+		{
+			if (a.numberOfElements == 0)return 0;
+			uint64_t last = 0;
+			a.getRange(a.numberOfElements - 1, 1, &last);
+			return last + 1;
+		}
+
+		uint64_t lowBitsOf(uint64_t i) const
+		{
+			if (m_tau == 0)return 0;
+			uint64_t low = 0;
+			m_lowBits.getRange(i, 1, &low);
+			return low;
+		}
+
+		EliasFano(uint64_t numberOfElements, uint64_t universe, uint64_t tau) : 
+			m_lowBits(numberOfElements, tau), 
+			m_highBits(uint32_t(numberOfElements + (universe >> tau) + 1)), 
+			m_numberOfElements(numberOfElements), 
+			m_universe(universe), 
+			m_tau(tau)
+		{
+		}
+
+		/**
+			Stores values[0, ... , count - 1] as the integers [first, ... , first + count - 1].
+		*/
+		void insertRange(const uint64_t* values, uint64_t first, uint64_t count)
+		{
+			uint64_t lowBits[256];
+			uint64_t mask = m_tau == 0 ? 0 : (~uint64_t(0)) >> (64 - m_tau);
+			for (uint64_t k = 0; k < count; k++)
+			{
+				m_highBits.setBit(uint32_t((values[k] >> m_tau) + first + k));
+				lowBits[k] = values[k] & mask;
+			}
+			m_lowBits.setRange(first, count, lowBits);
+		}
+
+	public:
+		/**
+			Description: 	Encodes a sorted ArrayType.
+			Parameter:		a - The sorted integers.
+			Preconditions:	a is sorted and not compressed. numberOfElements + universe / 2^tau < 2^32 (size of the Bitstring).
+			Complexity: 	O(n) time.
+		*/
+		EliasFano(const ArrayType& a) : 
+			EliasFano(a.numberOfElements, universeOf(a), lowBitsFor(a.numberOfElements, universeOf(a)))
+		{
+			uint64_t buffer[256];
+			for (uint64_t i = 0; i < m_numberOfElements; i += 256)
+			{
+				uint64_t count = m_numberOfElements - i < 256 ? m_numberOfElements - i : 256;
+				a.getRange(i, count, buffer);
+				insertRange(buffer, i, count);
+			}
+			m_highBits.freeze();
+		}
+
+		/**
+			Description: 	Encodes the sorted sequence [first, last). The range is traversed twice.
+			Parameter:		first, last - Forward iterators over unsigned integers.
+			Preconditions:	The sequence is sorted. See above.
+			Complexity: 	O(n) time.
+		*/
+		template<typename It>
+		EliasFano(It first, It last) : 
+			EliasFano(uint64_t(std::distance(first, last)), universeOf(first, last), lowBitsFor(uint64_t(std::distance(first, last)), universeOf(first, last)))
+		{
+			uint64_t buffer[256];
+			uint64_t i = 0;
+			while (first != last)
+			{
+				uint64_t count = 0;
+				for (; first != last && count < 256; ++first)buffer[count++] = uint64_t(*first);
+				insertRange(buffer, i, count);
+				i += count;
+			}
+			m_highBits.freeze();
+		}
+
+		/**
+			Description: 	Decodes the i-th integer.
+			Preconditions:	i < size().
+			Complexity: 	O(1), one select1 on the high bits and one Array access.
+		*/
+		uint64_t access(uint64_t i) const
+		{
+			uint64_t high = uint64_t(m_highBits.select1(uint32_t(i))) - i;
+			return (high << m_tau) | lowBitsOf(i);
+		}
+
+		uint64_t operator[](uint64_t i) const
+		{
+			return access(i);
+		}
+
+		/**
+			Description: 	Skip query, searches the first integer, which is greater then or equal to x.
+			Parameter:		x - The lower bound.
+			Result:			The index of the first integer >= x, size() if there is no such integer. Use "access" for its value.
+			Complexity: 	O(1) for the bucket of x (one select0), plus the number of integers in this bucket, which are smaller then x.
+		*/
+		uint64_t nextGEQ(uint64_t x) const
+		{
+			if (x >= m_universe)return m_numberOfElements;
+			uint64_t high = x >> m_tau;
+			//the bucket "high" starts behind its (high - 1)-th zero, every bit in front of it, which is set, is an integer < x
+			uint64_t position = high == 0 ? 0 : uint64_t(m_highBits.select0(uint32_t(high - 1))) + 1;
+			uint64_t i = position - high;
+			while (i < m_numberOfElements && m_highBits.isBitSet(uint32_t(position)))
+			{
+				if ((high << m_tau | lowBitsOf(i)) >= x)return i;
+				i++;
+				position++;
+			}
+			return i;
+		}
+
+		uint64_t size() const { return m_numberOfElements; }
+
+		uint64_t universe() const { return m_universe; }
+
+		uint64_t tau() const { return m_tau; }
+
+		/**
+			Result:			The number of payload bits (low bits and high bits), without the rank/select directory.
+		*/
+		uint64_t bitSize() const { return m_numberOfElements * m_tau + m_highBits.numberOfElements(); }
+	};
+
+	/**
+		Block codec for an ArrayType. The integers are split into blocks of BLOCK_CODEC_SIZE integers, every block is encoded on its own:
+		either frame of reference (the block minimum plus the residuals x - minimum) or, for sorted blocks if it is smaller, delta
+		(the first integer plus the residuals x_k - x_(k - 1)). The residuals are bit-packed with the smallest tau, which fits the
+		largest residual of the block, so integers with small local ranges do not pay the global tau of the ArrayType.
+		Stream layout of a block (64 bit words):
+		[reference][tau | delta << 7 | count << 8][count * tau bits of residuals, padded to a whole word]
+	*/
+	class BlockCodec
+	{
+	private:
+		uint64_t* m_stream;
+		uint64_t* m_blockOffsets;
+		uint64_t m_numberOfElements;
+		uint64_t m_numberOfBlocks;
+
+		static uint64_t bitsFor(uint64_t x)
+		{
+			uint64_t tau = 0;
+			while (tau < 64 && (x >> tau) != 0)tau++;
+			return tau;
+		}
+
+		/**
+			Chooses the mode and the tau of a block and writes its residuals to "residuals".
+			Returns the header word.
+		*/
+		static uint64_t encodeHeader(const uint64_t* values, uint64_t count, uint64_t* residuals, uint64_t& reference)
+		{
+			uint64_t minimum = values[0];
+			uint64_t maximum = values[0];
+			uint64_t maxDelta = 0;
+			bool sorted = true;
+			for (uint64_t k = 1; k < count; k++)
+			{
+				if (values[k] < minimum)minimum = values[k];
+				if (values[k] > maximum)maximum = values[k];
+				if (values[k] < values[k - 1])sorted = false;
+				else if (values[k] - values[k - 1] > maxDelta)maxDelta = values[k] - values[k - 1];
+			}
+			uint64_t tau = bitsFor(maximum - minimum);
+			uint64_t deltaTau = bitsFor(maxDelta);
+			bool delta = sorted && deltaTau < tau;
+			if (delta)
+			{
+				tau = deltaTau;
+				reference = values[0];
+				residuals[0] = 0;
+				for (uint64_t k = 1; k < count; k++)residuals[k] = values[k] - values[k - 1];
+			}
+			else
+			{
+				reference = minimum;
+				for (uint64_t k = 0; k < count; k++)residuals[k] = values[k] - minimum;
+			}
+			return tau | (uint64_t(delta) << 7) | (count << 8);
+		}
+
+		static uint64_t payloadWords(uint64_t header)
+		{
+			return ((header & 127) * (header >> 8) + 63) / 64;
+		}
+
+		/*
+			Decodes the residuals [first, ... , first + count - 1] of a block with tau bits per residual, used by decodeBlock and get.
+		*/
+		static void unpackResiduals(const uint64_t* block, uint64_t tau, uint64_t first, uint64_t count, uint64_t* out)
+		{
+#ifdef ENV64BIT
+			s_unpackTable[tau](block + 2, first, count, out);
+#else
+			for (uint64_t k = 0; k < count; k++)out[k] = getBlock64((first + k) * tau, uint8_t(tau), block + 2);
+#endif
+		}
+
+		void release()
+		{
+			if (m_stream)free(m_stream);
+			if (m_blockOffsets)free(m_blockOffsets);
+			m_stream = nullptr;
+			m_blockOffsets = nullptr;
+		}
+
+	public:
+		/**
+			Description: 	Encodes an ArrayType block by block.
+			Parameter:		a - The integers, which should be encoded. "a" is not changed.
+			Preconditions:	"a" is not compressed (see compress).
+			Complexity: 	O(n) time, O(BLOCK_CODEC_SIZE) words of workspace.
+		*/
+		BlockCodec(const ArrayType& a) : m_stream(nullptr), m_blockOffsets(nullptr)
+		{
+			m_numberOfElements = a.numberOfElements;
+			m_numberOfBlocks = (m_numberOfElements + BLOCK_CODEC_SIZE - 1) / BLOCK_CODEC_SIZE;
+			m_blockOffsets = (uint64_t*)aligned_alloc(16, (m_numberOfBlocks + 1) * sizeof(uint64_t));
+
+			uint64_t values[BLOCK_CODEC_SIZE];
+			uint64_t residuals[BLOCK_CODEC_SIZE];
+			uint64_t reference;
+
+			//first pass: sizes of the blocks
+			uint64_t offset = 0;
+			for (uint64_t b = 0; b < m_numberOfBlocks; b++)
+			{
+				uint64_t first = b * BLOCK_CODEC_SIZE;
+				uint64_t count = m_numberOfElements - first < BLOCK_CODEC_SIZE ? m_numberOfElements - first : BLOCK_CODEC_SIZE;
+				a.getRange(first, count, values);
+				m_blockOffsets[b] = offset;
+				offset += 2 + payloadWords(encodeHeader(values, count, residuals, reference));
+			}
+			m_blockOffsets[m_numberOfBlocks] = offset;
+
+			//second pass: headers and residuals
+			m_stream = (uint64_t*)aligned_alloc(16, (offset + 1) * sizeof(uint64_t));
+			for (uint64_t i = 0; i <= offset; i++)m_stream[i] = 0;
+			for (uint64_t b = 0; b < m_numberOfBlocks; b++)
+			{
+				uint64_t first = b * BLOCK_CODEC_SIZE;
+				uint64_t count = m_numberOfElements - first < BLOCK_CODEC_SIZE ? m_numberOfElements - first : BLOCK_CODEC_SIZE;
+				a.getRange(first, count, values);
+				uint64_t header = encodeHeader(values, count, residuals, reference);
+				uint64_t* block = m_stream + m_blockOffsets[b];
+				uint64_t tau = header & 127;
+				block[0] = reference;
+				block[1] = header;
+				if (tau == 0)continue;
+#ifdef ENV64BIT
+				s_packTable[tau](residuals, 0, count, block + 2);
+#else
+				for (uint64_t k = 0; k < count; k++)setBlock64(k * tau, tau, residuals[k], block + 2);
+#endif
+			}
+		}
+
+		BlockCodec(const BlockCodec& other) : m_stream(nullptr), m_blockOffsets(nullptr)
+		{
+			*this = other;
+		}
+
+		BlockCodec(BlockCodec&& other) : m_stream(nullptr), m_blockOffsets(nullptr)
+		{
+			*this = std::move(other);
+		}
+
+		BlockCodec& operator=(const BlockCodec& other)
+		{
+			if (this == &other)return *this;
+			release();
+			m_numberOfElements = other.m_numberOfElements;
+			m_numberOfBlocks = other.m_numberOfBlocks;
+			uint64_t words = other.m_blockOffsets[m_numberOfBlocks] + 1;
+			m_blockOffsets = (uint64_t*)aligned_alloc(16, (m_numberOfBlocks + 1) * sizeof(uint64_t));
+			m_stream = (uint64_t*)aligned_alloc(16, words * sizeof(uint64_t));
+			for (uint64_t i = 0; i <= m_numberOfBlocks; i++)m_blockOffsets[i] = other.m_blockOffsets[i];
+			for (uint64_t i = 0; i < words; i++)m_stream[i] = other.m_stream[i];
+			return *this;
+		}
+
+		BlockCodec& operator=(BlockCodec&& other)
+		{
+			if (this == &other)return *this;
+			release();
+			m_numberOfElements = other.m_numberOfElements;
+			m_numberOfBlocks = other.m_numberOfBlocks;
+			m_stream = other.m_stream;
+			m_blockOffsets = other.m_blockOffsets;
+			other.m_stream = nullptr;
+			other.m_blockOffsets = nullptr;
+			return *this;
+		}
+
+		~BlockCodec()
+		{
+			release();
+		}
+
+		/**
+			Description: 	Decodes the block b without touching any other block.
+			Parameter:		b 	- The index of the block.
+							out	- Receives up to BLOCK_CODEC_SIZE integers.
+			Preconditions:	b < numberOfBlocks().
+			Result:			The number of integers in the block.
+			Complexity: 	O(BLOCK_CODEC_SIZE) time.
+		*/
+		uint64_t decodeBlock(uint64_t b, uint64_t* out) const
+		{
+			const uint64_t* block = m_stream + m_blockOffsets[b];
+			uint64_t reference = block[0];
+			uint64_t header = block[1];
+			uint64_t tau = header & 127;
+			uint64_t count = header >> 8;
+			if (tau == 0)
+			{
+				for (uint64_t k = 0; k < count; k++)out[k] = reference;
+				return count;
+			}
+			unpackResiduals(block, tau, 0, count, out);
+			if (header & 128)
+			{
+				for (uint64_t k = 0; k < count; k++)
+				{
+					reference += out[k];
+					out[k] = reference;
+				}
+			}
+			else
+			{
+				for (uint64_t k = 0; k < count; k++)out[k] += reference;
+			}
+			return count;
+		}
+
+		/**
+			Description: 	Decodes the i-th integer. Frame of reference blocks read a single residual, delta blocks are decoded up to i.
+			Preconditions:	i < size().
+			Complexity: 	O(1) for frame of reference blocks, O(BLOCK_CODEC_SIZE) for delta blocks.
+		*/
+		uint64_t get(uint64_t i) const
+		{
+			const uint64_t* block = m_stream + m_blockOffsets[i / BLOCK_CODEC_SIZE];
+			uint64_t header = block[1];
+			uint64_t tau = header & 127;
+			uint64_t k = i % BLOCK_CODEC_SIZE;
+			if (tau == 0)return block[0];
+			if ((header & 128) == 0)
+			{
+				uint64_t residual = 0;
+				unpackResiduals(block, tau, k, 1, &residual);
+				return block[0] + residual;
+			}
+			uint64_t values[BLOCK_CODEC_SIZE];
+			decodeBlock(i / BLOCK_CODEC_SIZE, values);
+			return values[k];
+		}
+
+		/**
+			Description: 	Decodes all integers.
+			Parameter:		out - Receives size() integers.
+		*/
+		void decode(uint64_t* out) const
+		{
+			for (uint64_t b = 0; b < m_numberOfBlocks; b++)out += decodeBlock(b, out);
+		}
+
+		uint64_t size() const { return m_numberOfElements; }
+
+		uint64_t numberOfBlocks() const { return m_numberOfBlocks; }
+
+		/**
+			Result:			The tau of the block b.
+		*/
+		uint64_t tauOfBlock(uint64_t b) const { return m_stream[m_blockOffsets[b] + 1] & 127; }
+
+		uint64_t byteSize() const { return sizeof(*this) + (m_blockOffsets[m_numberOfBlocks] + m_numberOfBlocks + 2) * sizeof(uint64_t); }
+	};
 }
 
 #endif
\ No newline at end of file
@@ -4,10 +4,146 @@
 
 #include "includes.h"
 #include "graph.h"
+#include "simd.h"
 #include <set>
+#include <map>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+
+/*
+	Ein kompilierter Automat speichert seine Übergangstabelle als 32 Bit Worte. Wäre diese Tabelle größer als
+	STATEMASCHINE_UNPACKED_BYTES (L2-Cache) und hat ein Eintrag (Folgezustand und Handlerindex) höchstens
+	STATEMASCHINE_PACKED_BITS Bits, wird sie mit Array bitgepackt: das Entpacken kostet etwa doppelt so viel wie ein
+	Wortzugriff aus dem L1- oder L2-Cache, lohnt sich aber, sobald die ungepackte Tabelle aus dem L2-Cache fällt.
+*/
+#define STATEMASCHINE_PACKED_BITS 16
+#define STATEMASCHINE_UNPACKED_BYTES 262144
+
+/*
+	runStreams führt bis zu STATEMASCHINE_STREAMS Eingaben verschränkt aus. Mit STATEMASCHINE_GATHER werden je 8 Ströme
+	eines Alphabets aus einem Byte mit einem Gather-Befehl auf der ungepackten Tabelle weitergeschaltet, sofern die CPU AVX2
+	unterstützt (zur Laufzeit erkannt, siehe simd.h). Das lohnt sich ab 16 Strömen (zwei Register), mit 0 bleibt es bei
+	verschränkten skalaren Zugriffen.
+*/
+#define STATEMASCHINE_STREAMS 16
+#ifndef STATEMASCHINE_GATHER
+#define STATEMASCHINE_GATHER 1
+#endif
 
 namespace ds
 {
+	template<class T, class E>
+	class Statemaschine;
+
+	/*!
+	*	\class Die kompilierte, unveränderliche Form einer Statemaschine: das Alphabet, die dichte Übergangstabelle, die
+	*	Handler und die akzeptierenden Zustände, aber kein aktueller Zustand und kein Callback-Objekt. Alle Methoden sind
+	*	const und ohne Seiteneffekte auf dem Automaten, beliebig viele Threads können ein Exemplar über
+	*	std::shared_ptr gemeinsam benutzen, jeder mit eigenem Zustand (StatemaschineCursor) oder eigenen Zustandsfeldern
+	*	(runStreams). Erzeugt wird sie von Statemaschine::compile.
+	*/
+	template<class T, class E>
+	class CompiledStatemaschine
+	{
+		typedef void (T::*t_memberFunc)();
+		friend class Statemaschine<T, E>;
+	private:
+		/*!
+			\brief m_symbols ist das sortierte Alphabet, das Symbol m_symbols[k] hat die Nummer k + 1, die Nummer 0 steht für
+			alle Symbole ohne Kante. Zeile z der Tabelle hat m_columns Einträge (Folgezustand | Handlerindex << m_stateBits),
+			m_handlers[0] ist kein Handler. Für Alphabete aus einem Byte liefert m_byteSymbols die Nummer direkt.
+		*/
+		std::vector<E> m_symbols;
+		std::vector<uint32_t> m_byteSymbols;
+		std::vector<t_memberFunc> m_handlers;
+		Array m_packedTable;
+		std::vector<uint32_t> m_table;
+		Bitstring m_accepting;
+		uint32_t m_numberOfStates;
+		uint32_t m_startState;
+		uint32_t m_columns;
+		uint32_t m_stateBits;
+		Integer m_stateMask;
+		bool m_packed;
+
+		CompiledStatemaschine(uint32_t states, uint32_t startState);
+		uint32_t symbolOf(E symbol, std::true_type) const;
+		uint32_t symbolOf(E symbol, std::false_type) const;
+		uint32_t symbolOf(E symbol) const;
+		Integer entryOf(uint32_t state, uint32_t symbol) const;
+		Integer packedEntry(Integer cell) const;
+		void setAlphabet(std::vector<E>& symbols);
+		void storeTable(std::vector<uint32_t>& table, uint32_t stateBits, uint32_t handlerBits);
+		uint32_t runTable(Integer state, const E* begin, const E* end) const;
+		void advanceStreams(const E** positions, uint32_t* states, uint32_t active, Integer length, T* object) const;
+		SIMD_TARGET("avx2") uint32_t gatherStreams(const E** positions, uint32_t* states, uint32_t active, Integer length) const;
+	public:
+		~CompiledStatemaschine();
+		/*!
+		* \brief Der Folgezustand von state mit symbol ohne Handleraufruf.
+		* \pre		state < numberOfStates().
+		*/
+		uint32_t transition(uint32_t state, E symbol) const;
+		/*!
+		* \brief Der Folgezustand von state mit symbol, der Handler der Kante wird auf object aufgerufen, wenn object nicht
+		* nullptr ist.
+		*/
+		uint32_t step(uint32_t state, E symbol, T* object) const;
+		/*!
+		* \brief Verarbeitet die Eingabe [begin, end) ab state wie step für jedes Symbol, ohne Handler (oder ohne object) in
+		* einer Schleife über die Tabelle, der Zustand liegt dabei in einem Register.
+		*
+		* \return	Der Zustand nach end.
+		*/
+		uint32_t run(uint32_t state, const E* begin, const E* end, T* object) const;
+		/*!
+		* \brief Verarbeitet count unabhängige Eingaben [begins[k], ends[k]) verschränkt: in jeder Runde wird jeder Strom um
+		* ein Symbol weitergeschaltet, so überlappen sich die voneinander unabhängigen Tabellenzugriffe der Ströme, statt
+		* dass jeder Übergang auf den vorherigen wartet. Handler werden auf object innerhalb eines Stroms in
+		* Eingabereihenfolge aufgerufen, zwischen den Strömen verschränkt.
+		*
+		* \param states	- states[k] ist der Anfangszustand von Strom k (etwa startState()) und danach sein Endzustand.
+		*/
+		void runStreams(const E* const* begins, const E* const* ends, uint32_t* states, uint32_t count, T* object) const;
+		bool isAccepting(uint32_t state) const;
+		bool hasHandlers() const;
+		uint32_t startState() const;
+		uint32_t numberOfStates() const;
+		/*!
+		* \brief Der Speicher der Tabellen in Bytes, den sich alle Benutzer des Automaten teilen.
+		*/
+		Integer byteSize() const;
+	};
+
+	/*!
+	*	\class Ein Lesezeiger auf einen gemeinsam benutzten kompilierten Automaten: er hält nur den aktuellen Zustand und das
+	*	Callback-Objekt, so hat jeder Thread seinen eigenen Cursor, ohne den Automaten zu kopieren. Ein Cursor ist nicht
+	*	threadsicher, der Automat dahinter schon.
+	*/
+	template<class T, class E>
+	class StatemaschineCursor
+	{
+	private:
+		std::shared_ptr<const CompiledStatemaschine<T, E>> m_automaton;
+		T* m_object;
+		uint32_t m_state;
+	public:
+		StatemaschineCursor(std::shared_ptr<const CompiledStatemaschine<T, E>> automaton, T* object);
+		StatemaschineCursor(std::shared_ptr<const CompiledStatemaschine<T, E>> automaton);
+		~StatemaschineCursor();
+		bool isAbleToCallback() const;
+		void setCallbackInstance(T* instance);
+		void step(E symbol);
+		/*!
+		* \brief Verarbeitet die Eingabe [begin, end) wie step für jedes Symbol.
+		*/
+		void run(const E* begin, const E* end);
+		void reset();
+		uint32_t stateOf() const;
+		bool isInAcceptingState() const;
+		const CompiledStatemaschine<T, E>& automaton() const;
+	};
 	
 	/*!
 	*	\class Diese Klasse repräsentiert einen Zustandsautomaten. T ist der Typparameter, dessen
@@ -17,6 +153,8 @@ namespace ds
 	*	Folgezustand geben.
 	*	Es gibt immer mindestens 2 Zustände. Einen Startzustand = 1 und einen Fehlerzustand = 0.
 	*	Grundsätzlich werden nicht eingetragene Paare (z,e) als Kanten auf den aktuellen Zustand interpretiert.
+	*	Die kompilierte Form (compile) ist ein eigenes, unveränderliches Objekt, das sich Kopien des Automaten und Cursor
+	*	(cursor) teilen, statt die Tabelle zu kopieren.
 	*/
 	template<class T, class E>
 	class Statemaschine
@@ -29,6 +167,11 @@ namespace ds
 		T* m_object;
 		uint32_t m_state;
 		uint32_t m_startState;
+		/*!
+			\brief Die kompilierte Form oder nullptr, jede Änderung an den Kanten, Start- oder akzeptierenden Zuständen löst
+			den Automaten von ihr, Cursor und Kopien behalten sie.
+		*/
+		std::shared_ptr<const CompiledStatemaschine<T, E>> m_compiled;
 	public:
 		Statemaschine(uint32_t size, T* object);
 		Statemaschine(uint32_t size);
@@ -48,9 +191,70 @@ namespace ds
 		bool removeAcceptingState(uint32_t i);
 		bool addAcceptingState(uint32_t i);
 		bool isInAcceptingState() const;
+		/*!
+		* \brief Übersetzt die Kanten und akzeptierenden Zustände in einen CompiledStatemaschine mit einer dichten Tabelle
+		* [Zustand][Symbolnummer], danach bedient step die Tabelle statt der std::map. Jede Änderung am Automaten verwirft
+		* die Tabelle, bis compile erneut aufgerufen wird.
+		*
+		* \return	false, wenn ein Eintrag mehr als 32 Bits bräuchte, der Automat arbeitet dann weiter auf der std::map.
+		*/
+		bool compile();
+		/*!
+		* \brief Übernimmt eine fertige dichte Tabelle, etwa von einem Generator wie AhoCorasick, ohne den Umweg über
+		* setEdge und die std::map: table[z * (symbols.size() + 1) + k + 1] ist der Folgezustand von z mit dem Symbol
+		* symbols[k], table[z * (symbols.size() + 1)] der Folgezustand für alle Symbole, die nicht in symbols sind. Die Kanten
+		* werden gelöscht, der Automat hat danach keine Handler und nur die Tabelle, eine Änderung an den Kanten (setEdge, ...)
+		* oder minimize verwirft sie. Die akzeptierenden Zustände müssen vorher gesetzt sein.
+		*
+		* \param symbols	- Das Alphabet, aufsteigend sortiert und ohne Duplikate.
+		* \return			false, wenn die Größe von table kein Vielfaches von symbols.size() + 1 ist.
+		*/
+		bool compile(std::vector<E> symbols, std::vector<uint32_t> table);
+		bool isCompiled() const;
+		/*!
+		* \brief Die kompilierte Form, nullptr, wenn der Automat nicht kompiliert ist. Sie bleibt gültig und unverändert,
+		* auch wenn der Automat danach geändert oder zerstört wird.
+		*/
+		std::shared_ptr<const CompiledStatemaschine<T, E>> compiled() const;
+		/*!
+		* \brief Ein Cursor im Startzustand auf der kompilierten Form, etwa einer je Thread.
+		* \pre		Der Automat ist kompiliert.
+		*/
+		StatemaschineCursor<T, E> cursor(T* object) const;
+		/*!
+		* \brief Der Folgezustand von state mit symbol ohne Handleraufruf, unabhängig vom Zustand des Automaten.
+		* \pre		Der Automat ist kompiliert und state ist ein Zustand der Tabelle.
+		*/
+		uint32_t transition(uint32_t state, E symbol) const;
+		/*!
+		* \brief Minimiert den Automaten mit Hopcrofts Partitionsverfeinerung: Zustände, die vom Startzustand aus nicht
+		* erreichbar sind, fallen weg (außer dem Fehlerzustand 0), äquivalente Zustände werden zusammengelegt. Zwei
+		* Zustände sind äquivalent, wenn beide akzeptieren oder beide nicht und sie zu jedem Symbol denselben Handler
+		* aufrufen und in äquivalente Zustände wechseln. Die Zustände werden nach ihrem kleinsten alten Zustand neu
+		* nummeriert, so bleiben 0 und 1 erhalten, wenn sie nicht mit anderen zusammenfallen. Ein kompilierter Automat wird
+		* neu kompiliert.
+		*
+		* \return	Die Anzahl der Zustände vorher und nachher.
+		* \post		Zustandsnummern von vorher (auch in runStreams) sind ungültig, der Automat steht im Startzustand, wenn der
+		*			aktuelle Zustand nicht erreichbar war.
+		*/
+		std::pair<uint32_t, uint32_t> minimize();
 		void step(E symbol);
+		/*!
+		* \brief Verarbeitet die Eingabe [begin, end) wie step für jedes Symbol, auf einem kompilierten Automaten in einer
+		* Schleife über die Tabelle, der Zustand liegt dabei in einem Register.
+		*/
+		void run(const E* begin, const E* end);
+		/*!
+		* \brief CompiledStatemaschine::runStreams mit dem Callback-Objekt des Automaten. Der Zustand des Automaten (stateOf)
+		* bleibt unverändert.
+		*
+		* \pre				Der Automat ist kompiliert (compile).
+		*/
+		void runStreams(const E* const* begins, const E* const* ends, uint32_t* states, uint32_t count) const;
 		void reset();
 		uint32_t stateOf() const;
+		uint32_t startState() const;
 	};
 
 	template<class T, class E>
@@ -80,7 +284,10 @@ namespace ds
 	{
 		m_object = other.m_object;
 		m_state = other.m_state;
+		m_startState = other.m_startState;
 		m_transitions = other.m_transitions;
+		m_acceptingStates = other.m_acceptingStates;
+		m_compiled = other.m_compiled;
 	}
 
 	template<class T, class E>
@@ -88,7 +295,10 @@ namespace ds
 	{
 		m_object = other.m_object;
 		m_state = other.m_state;
+		m_startState = other.m_startState;
 		m_transitions = other.m_transitions;
+		m_acceptingStates = other.m_acceptingStates;
+		m_compiled = other.m_compiled;
 	}
 
 	template<class T, class E>
@@ -99,7 +309,10 @@ namespace ds
 		m_graph = other.m_graph;
 		m_object = other.m_object;
 		m_state = other.m_state;
+		m_startState = other.m_startState;
 		m_transitions = other.m_transitions;
+		m_acceptingStates = other.m_acceptingStates;
+		m_compiled = other.m_compiled;
 
 		return *this;
 	}
@@ -112,7 +325,10 @@ namespace ds
 		m_graph = other.m_graph;
 		m_object = other.m_object;
 		m_state = other.m_state;
+		m_startState = other.m_startState;
 		m_transitions = other.m_transitions;
+		m_acceptingStates = other.m_acceptingStates;
+		m_compiled = other.m_compiled;
 
 		return *this;
 	}
@@ -136,7 +352,7 @@ namespace ds
 		if (m_graph.hasEdge(i, j))
 		{
 			//std::map<std::pair<uint32_t, E>, std::pair<uint32_t, t_memberFunc>> m_transitions;
-			std::map<std::pair<uint32_t, E>, std::pair<uint32_t, t_memberFunc>>::iterator it = m_transitions.find(std::make_pair(i, e));
+			typename std::map<std::pair<uint32_t, E>, std::pair<uint32_t, t_memberFunc>>::iterator it = m_transitions.find(std::make_pair(i, e));
 			it = m_transitions.begin();
 			while (it != m_transitions.end())
 			{
@@ -145,6 +361,7 @@ namespace ds
 					m_transitions.erase(it);
 					m_transitions.insert(std::make_pair(std::make_pair(i, e), std::make_pair(j, nullptr)));
 
+					m_compiled.reset();
 					reset();
 					return true;
 				}
@@ -154,6 +371,7 @@ namespace ds
 		else
 		{
 			m_transitions.insert(std::make_pair(std::make_pair(i, e), std::make_pair(j, nullptr)));
+			m_compiled.reset();
 			reset();
 			return true;
 		}
@@ -166,7 +384,7 @@ namespace ds
 		if (m_graph.hasEdge(i, j))
 		{
 			//std::map<std::pair<uint32_t, E>, std::pair<uint32_t, t_memberFunc>> m_transitions;
-			std::map<std::pair<uint32_t, E>, std::pair<uint32_t, t_memberFunc>>::iterator it = m_transitions.find(std::make_pair(i, e));
+			typename std::map<std::pair<uint32_t, E>, std::pair<uint32_t, t_memberFunc>>::iterator it = m_transitions.find(std::make_pair(i, e));
 			it = m_transitions.begin();
 			while (it != m_transitions.end())
 			{
@@ -175,6 +393,7 @@ namespace ds
 					m_transitions.erase(it);
 					m_transitions.insert(std::make_pair(std::make_pair(i, e), std::make_pair(j, handle)));
 
+					m_compiled.reset();
 					reset();
 					return true;
 				}
@@ -184,6 +403,7 @@ namespace ds
 		else
 		{
 			m_transitions.insert(std::make_pair(std::make_pair(i, e), std::make_pair(j, handle)));
+			m_compiled.reset();
 			reset();
 			return true;
 		}
@@ -195,7 +415,7 @@ namespace ds
 	{
 		if (m_graph.hasEdge(i, j))
 		{
-			std::map<std::pair<uint32_t, E>, std::pair<uint32_t, t_memberFunc>>::iterator it = m_transitions.find(std::make_pair(m_state, e));
+			typename std::map<std::pair<uint32_t, E>, std::pair<uint32_t, t_memberFunc>>::iterator it = m_transitions.find(std::make_pair(m_state, e));
 			if (it != m_transitions.end() && it->second.first == j)
 			{
 				m_transitions.erase(it);
@@ -204,6 +424,7 @@ namespace ds
 			{
 				return false;
 			}
+			m_compiled.reset();
 			reset();
 			return true;
 		}
@@ -216,10 +437,11 @@ namespace ds
 		if (m_graph.hasEdge(i, j))
 		{
 			//std::map<std::pair<uint32_t, E>, std::pair<uint32_t, t_memberFunc>> m_transitions;
-			std::map<std::pair<uint32_t, E>, std::pair<uint32_t, t_memberFunc>>::iterator it = m_transitions.find(std::make_pair(m_state, e));
+			typename std::map<std::pair<uint32_t, E>, std::pair<uint32_t, t_memberFunc>>::iterator it = m_transitions.find(std::make_pair(m_state, e));
 			std::pair<std::pair<uint32_t, E>, std::pair<uint32_t, t_memberFunc>> p = std::make_pair(std::make_pair(i, e), std::make_pair(j, handle));
 			m_transitions.erase(it);
 			m_transitions.insert(p);
+			m_compiled.reset();
 			reset();
 			return true;
 		}
@@ -232,10 +454,11 @@ namespace ds
 		if (m_graph.hasEdge(i, j))
 		{
 			//std::map<std::pair<uint32_t, E>, std::pair<uint32_t, t_memberFunc>> m_transitions;
-			std::map<std::pair<uint32_t, E>, std::pair<uint32_t, t_memberFunc>>::iterator it = m_transitions.find(std::make_pair(m_state, symbol));
+			typename std::map<std::pair<uint32_t, E>, std::pair<uint32_t, t_memberFunc>>::iterator it = m_transitions.find(std::make_pair(m_state, symbol));
 			std::pair<std::pair<uint32_t, E>, std::pair<uint32_t, t_memberFunc>> p = std::make_pair(std::make_pair(i, it->first.second), std::make_pair(j, nullptr));
 			m_transitions.remove(it);
 			m_transitions.insert(p);
+			m_compiled.reset();
 			reset();
 			return true;
 		}
@@ -246,6 +469,7 @@ namespace ds
 	inline void Statemaschine<T, E>::setStartState(uint32_t i)
 	{
 		m_startState = i;
+		m_compiled.reset();
 	}
 	
 	template<class T, class E>
@@ -255,6 +479,7 @@ namespace ds
 		if(it != m_acceptingStates.end())
 		{
 			m_acceptingStates.erase(it);
+			m_compiled.reset();
 			reset();
 			return true;
 		}
@@ -268,6 +493,7 @@ namespace ds
 		if (it == m_acceptingStates.end())
 		{
 			m_acceptingStates.insert(i);
+			m_compiled.reset();
 			reset();
 			return true;
 		}
@@ -280,19 +506,390 @@ namespace ds
 		return m_acceptingStates.find(m_state) != m_acceptingStates.end();
 	}
 
+	template<class T, class E>
+	inline bool Statemaschine<T, E>::compile()
+	{
+		typedef typename std::map<std::pair<uint32_t, E>, std::pair<uint32_t, t_memberFunc>>::const_iterator t_iterator;
+		m_compiled.reset();
+
+		//Alphabet sortiert und ohne Duplikate, die Zustände sind alle Knoten, alle Endpunkte von Kanten und alle
+		//akzeptierenden Zustände
+		std::vector<E> symbols;
+		std::vector<t_memberFunc> handlers(1, nullptr);
+		uint32_t states = m_graph.numberOfNodes();
+		if (m_startState >= states)states = m_startState + 1;
+		if (!m_acceptingStates.empty() && *m_acceptingStates.rbegin() >= states)states = *m_acceptingStates.rbegin() + 1;
+		for (t_iterator it = m_transitions.begin(); it != m_transitions.end(); it++)
+		{
+			symbols.push_back(it->first.second);
+			if (it->first.first >= states)states = it->first.first + 1;
+			if (it->second.first >= states)states = it->second.first + 1;
+			if (it->second.second != nullptr && std::find(handlers.begin(), handlers.end(), it->second.second) == handlers.end())handlers.push_back(it->second.second);
+		}
+		std::sort(symbols.begin(), symbols.end());
+		symbols.erase(std::unique(symbols.begin(), symbols.end(), [](const E& a, const E& b) { return !(a < b) && !(b < a); }), symbols.end());
+
+		uint32_t stateBits = 1;
+		while (stateBits < 32 && ((states - 1) >> stateBits) != 0)stateBits++;
+		uint32_t handlerBits = 0;
+		while (((handlers.size() - 1) >> handlerBits) != 0)handlerBits++;
+		if (stateBits + handlerBits > 32)return false;
+
+		std::shared_ptr<CompiledStatemaschine<T, E>> compiled(new CompiledStatemaschine<T, E>(states, m_startState));
+		compiled->setAlphabet(symbols);
+		compiled->m_handlers.swap(handlers);
+
+		//Symbole ohne Kante bleiben im Zustand
+		uint32_t columns = compiled->m_columns;
+		Integer cells = Integer(states) * columns;
+		std::vector<uint32_t> table(cells);
+		for (uint32_t state = 0; state < states; state++)
+		{
+			for (uint32_t column = 0; column < columns; column++)table[Integer(state) * columns + column] = state;
+		}
+		for (t_iterator it = m_transitions.begin(); it != m_transitions.end(); it++)
+		{
+			uint32_t handler = 0;
+			if (it->second.second != nullptr)handler = uint32_t(std::find(compiled->m_handlers.begin(), compiled->m_handlers.end(), it->second.second) - compiled->m_handlers.begin());
+			table[Integer(it->first.first) * columns + compiled->symbolOf(it->first.second, std::false_type())] = uint32_t(it->second.first | (Integer(handler) << stateBits));
+		}
+		compiled->storeTable(table, stateBits, handlerBits);
+		for (uint32_t state : m_acceptingStates)compiled->m_accepting.setBit(state);
+		m_compiled = compiled;
+		return true;
+	}
+
+	template<class T, class E>
+	inline bool Statemaschine<T, E>::compile(std::vector<E> symbols, std::vector<uint32_t> table)
+	{
+		m_compiled.reset();
+		if (table.size() % (symbols.size() + 1) != 0)return false;
+		uint32_t states = uint32_t(table.size() / (symbols.size() + 1));
+		if (m_startState >= states)states = m_startState + 1;
+		if (!m_acceptingStates.empty() && *m_acceptingStates.rbegin() >= states)states = *m_acceptingStates.rbegin() + 1;
+		for (uint32_t target : table)
+		{
+			if (target >= states)states = target + 1;
+		}
+		//fehlende Zeilen (Startzustand) bleiben in ihrem Zustand
+		for (uint32_t state = uint32_t(table.size() / (symbols.size() + 1)); state < states; state++)
+		{
+			for (Integer column = 0; column <= symbols.size(); column++)table.push_back(state);
+		}
+		uint32_t stateBits = 1;
+		while (stateBits < 32 && ((states - 1) >> stateBits) != 0)stateBits++;
+
+		m_transitions.clear();
+		std::shared_ptr<CompiledStatemaschine<T, E>> compiled(new CompiledStatemaschine<T, E>(states, m_startState));
+		compiled->setAlphabet(symbols);
+		compiled->m_handlers.assign(1, nullptr);
+		compiled->storeTable(table, stateBits, 0);
+		for (uint32_t state : m_acceptingStates)compiled->m_accepting.setBit(state);
+		m_compiled = compiled;
+		if (m_state >= states)m_state = m_startState;
+		return true;
+	}
+
+	template<class T, class E>
+	inline void CompiledStatemaschine<T, E>::setAlphabet(std::vector<E>& symbols)
+	{
+		m_symbols.swap(symbols);
+		if (std::is_integral<E>::value && sizeof(E) == 1)
+		{
+			m_byteSymbols.assign(256, 0);
+			for (uint32_t k = 0; k < m_symbols.size(); k++)m_byteSymbols[uint8_t(m_symbols[k])] = k + 1;
+		}
+		m_columns = uint32_t(m_symbols.size()) + 1;
+	}
+
+	/*
+		Übernimmt table als kompilierte Tabelle, gepackt, wenn sie ungepackt nicht in den L2-Cache passt.
+	*/
+	template<class T, class E>
+	inline void CompiledStatemaschine<T, E>::storeTable(std::vector<uint32_t>& table, uint32_t stateBits, uint32_t handlerBits)
+	{
+		Integer cells = table.size();
+		m_stateBits = stateBits;
+		m_stateMask = (Integer(1) << stateBits) - 1;
+		if (stateBits + handlerBits <= STATEMASCHINE_PACKED_BITS && cells * sizeof(uint32_t) > STATEMASCHINE_UNPACKED_BYTES)
+		{
+			m_packedTable = Array(cells, stateBits + handlerBits);
+			uint64_t buffer[256];
+			for (Integer i = 0; i < cells; i += 256)
+			{
+				Integer chunk = cells - i < 256 ? cells - i : 256;
+				for (Integer k = 0; k < chunk; k++)buffer[k] = table[i + k];
+				m_packedTable.setRange(i, chunk, buffer);
+			}
+			std::vector<uint32_t>().swap(m_table);
+			m_packed = true;
+		}
+		else
+		{
+			m_table.swap(table);
+			m_packedTable = Array();
+			m_packed = false;
+		}
+	}
+
+
+	template<class T, class E>
+	inline uint32_t Statemaschine<T, E>::transition(uint32_t state, E symbol) const
+	{
+		return m_compiled->transition(state, symbol);
+	}
+
+	template<class T, class E>
+	inline bool Statemaschine<T, E>::isCompiled() const
+	{
+		return m_compiled != nullptr;
+	}
+
+	template<class T, class E>
+	inline std::shared_ptr<const CompiledStatemaschine<T, E>> Statemaschine<T, E>::compiled() const
+	{
+		return m_compiled;
+	}
+
+	template<class T, class E>
+	inline StatemaschineCursor<T, E> Statemaschine<T, E>::cursor(T* object) const
+	{
+		return StatemaschineCursor<T, E>(m_compiled, object);
+	}
+
+	template<class T, class E>
+	inline std::pair<uint32_t, uint32_t> Statemaschine<T, E>::minimize()
+	{
+		typedef typename std::map<std::pair<uint32_t, E>, std::pair<uint32_t, t_memberFunc>>::const_iterator t_iterator;
+
+		//vollständige Übergangstabelle wie in compile: fehlende Kanten bleiben im Zustand, ohne Handler
+		std::vector<E> symbols;
+		std::vector<t_memberFunc> handlers(1, nullptr);
+		uint32_t states = m_graph.numberOfNodes();
+		if (m_startState >= states)states = m_startState + 1;
+		for (t_iterator it = m_transitions.begin(); it != m_transitions.end(); it++)
+		{
+			symbols.push_back(it->first.second);
+			if (it->first.first >= states)states = it->first.first + 1;
+			if (it->second.first >= states)states = it->second.first + 1;
+			if (it->second.second != nullptr && std::find(handlers.begin(), handlers.end(), it->second.second) == handlers.end())handlers.push_back(it->second.second);
+		}
+		std::sort(symbols.begin(), symbols.end());
+		symbols.erase(std::unique(symbols.begin(), symbols.end(), [](const E& a, const E& b) { return !(a < b) && !(b < a); }), symbols.end());
+		Integer width = symbols.size();
+		std::vector<uint32_t> next(Integer(states) * width);
+		std::vector<uint32_t> handlerOf(Integer(states) * width, 0);
+		for (uint32_t state = 0; state < states; state++)
+		{
+			for (Integer a = 0; a < width; a++)next[state * width + a] = state;
+		}
+		for (t_iterator it = m_transitions.begin(); it != m_transitions.end(); it++)
+		{
+			Integer cell = it->first.first * width + (std::lower_bound(symbols.begin(), symbols.end(), it->first.second) - symbols.begin());
+			next[cell] = it->second.first;
+			if (it->second.second != nullptr)handlerOf[cell] = uint32_t(std::find(handlers.begin(), handlers.end(), it->second.second) - handlers.begin());
+		}
+
+		//erreichbare Zustände, kept[z] ist die dichte Nummer von z oder states
+		std::vector<uint32_t> kept(states, states);
+		std::vector<uint32_t> original;
+		kept[0] = 0;
+		original.push_back(0);
+		if (kept[m_startState] == states)
+		{
+			kept[m_startState] = uint32_t(original.size());
+			original.push_back(m_startState);
+		}
+		for (Integer k = 0; k < original.size(); k++)
+		{
+			for (Integer a = 0; a < width; a++)
+			{
+				uint32_t target = next[original[k] * width + a];
+				if (kept[target] != states)continue;
+				kept[target] = uint32_t(original.size());
+				original.push_back(target);
+			}
+		}
+		uint32_t n = uint32_t(original.size());
+
+		//Anfangspartition nach (akzeptierend, Handler je Symbol)
+		std::vector<uint32_t> elements(n);
+		for (uint32_t k = 0; k < n; k++)elements[k] = k;
+		std::sort(elements.begin(), elements.end(), [&](uint32_t x, uint32_t y)
+		{
+			bool acceptingX = m_acceptingStates.count(original[x]) != 0;
+			bool acceptingY = m_acceptingStates.count(original[y]) != 0;
+			if (acceptingX != acceptingY)return acceptingX < acceptingY;
+			return std::lexicographical_compare(handlerOf.begin() + original[x] * width, handlerOf.begin() + (original[x] + 1) * width,
+				handlerOf.begin() + original[y] * width, handlerOf.begin() + (original[y] + 1) * width);
+		});
+		std::vector<uint32_t> location(n);
+		std::vector<uint32_t> blockOf(n);
+		std::vector<uint32_t> first;
+		std::vector<uint32_t> last;
+		std::vector<uint32_t> marked;
+		for (uint32_t k = 0; k < n; k++)
+		{
+			uint32_t x = elements[k];
+			if (k == 0 || m_acceptingStates.count(original[x]) != m_acceptingStates.count(original[elements[k - 1]]) ||
+				!std::equal(handlerOf.begin() + original[x] * width, handlerOf.begin() + (original[x] + 1) * width, handlerOf.begin() + original[elements[k - 1]] * width))
+			{
+				first.push_back(k);
+				last.push_back(k);
+				marked.push_back(k);
+			}
+			location[x] = k;
+			blockOf[x] = uint32_t(first.size()) - 1;
+			last.back() = k + 1;
+		}
+
+		//Vorgänger je Symbol: predecessors[offsets[a * n + t], offsets[a * n + t + 1]) gehen mit Symbol a nach t
+		std::vector<Integer> offsets(width * n + 1, 0);
+		for (uint32_t k = 0; k < n; k++)
+		{
+			for (Integer a = 0; a < width; a++)offsets[a * n + kept[next[original[k] * width + a]] + 1]++;
+		}
+		for (Integer i = 0; i < width * n; i++)offsets[i + 1] += offsets[i];
+		std::vector<uint32_t> predecessors(width * n);
+		{
+			std::vector<Integer> fill(offsets.begin(), offsets.end() - 1);
+			for (uint32_t k = 0; k < n; k++)
+			{
+				for (Integer a = 0; a < width; a++)predecessors[fill[a * n + kept[next[original[k] * width + a]]]++] = k;
+			}
+		}
+
+		//Hopcroft: jeder Block kommt als Splitter in die Arbeitsliste, nach einer Teilung nur der kleinere Teil, außer der
+		//geteilte Block wartet noch selbst
+		std::vector<uint32_t> worklist;
+		std::vector<bool> waiting(first.size(), true);
+		for (uint32_t b = 0; b < first.size(); b++)worklist.push_back(b);
+		std::vector<uint32_t> splitter;
+		std::vector<uint32_t> touched;
+		while (!worklist.empty())
+		{
+			uint32_t block = worklist.back();
+			worklist.pop_back();
+			waiting[block] = false;
+			splitter.assign(elements.begin() + first[block], elements.begin() + last[block]);
+			for (Integer a = 0; a < width; a++)
+			{
+				//Vorgänger an den Anfang ihres Blocks tauschen
+				for (uint32_t target : splitter)
+				{
+					for (Integer i = offsets[a * n + target]; i < offsets[a * n + target + 1]; i++)
+					{
+						uint32_t x = predecessors[i];
+						uint32_t b = blockOf[x];
+						if (location[x] < marked[b])continue;
+						if (marked[b] == first[b])touched.push_back(b);
+						uint32_t y = elements[marked[b]];
+						std::swap(elements[location[x]], elements[marked[b]]);
+						location[y] = location[x];
+						location[x] = marked[b];
+						marked[b]++;
+					}
+				}
+				for (uint32_t b : touched)
+				{
+					if (marked[b] == last[b])
+					{
+						marked[b] = first[b];
+						continue;
+					}
+					//die markierten Zustände werden ein neuer Block
+					uint32_t created = uint32_t(first.size());
+					first.push_back(first[b]);
+					last.push_back(marked[b]);
+					marked.push_back(first[b]);
+					waiting.push_back(false);
+					first[b] = marked[b];
+					for (uint32_t k = first[created]; k < last[created]; k++)blockOf[elements[k]] = created;
+					if (waiting[b] || last[created] - first[created] <= last[b] - first[b])
+					{
+						worklist.push_back(created);
+						waiting[created] = true;
+					}
+					else
+					{
+						worklist.push_back(b);
+						waiting[b] = true;
+					}
+				}
+				touched.clear();
+			}
+		}
+
+		//neue Nummern nach dem kleinsten alten Zustand des Blocks
+		uint32_t blocks = uint32_t(first.size());
+		std::vector<uint32_t> smallest(blocks, states);
+		for (uint32_t k = 0; k < n; k++)smallest[blockOf[k]] = std::min(smallest[blockOf[k]], original[k]);
+		std::vector<uint32_t> order(blocks);
+		for (uint32_t b = 0; b < blocks; b++)order[b] = b;
+		std::sort(order.begin(), order.end(), [&](uint32_t x, uint32_t y) { return smallest[x] < smallest[y]; });
+		std::vector<uint32_t> number(blocks);
+		for (uint32_t b = 0; b < blocks; b++)number[order[b]] = b;
+
+		std::map<std::pair<uint32_t, E>, std::pair<uint32_t, t_memberFunc>> transitions;
+		std::set<uint32_t> acceptingStates;
+		for (uint32_t b = 0; b < blocks; b++)
+		{
+			uint32_t representative = smallest[b];
+			if (m_acceptingStates.count(representative) != 0)acceptingStates.insert(number[b]);
+			for (Integer a = 0; a < width; a++)
+			{
+				uint32_t target = number[blockOf[kept[next[representative * width + a]]]];
+				uint32_t handler = handlerOf[representative * width + a];
+				if (target == number[b] && handler == 0)continue;
+				transitions.insert(std::make_pair(std::make_pair(number[b], symbols[a]), std::make_pair(target, handlers[handler])));
+			}
+		}
+		m_transitions.swap(transitions);
+		m_acceptingStates.swap(acceptingStates);
+		m_graph = Graphe(blocks);
+		m_state = m_state < states && kept[m_state] != states ? number[blockOf[kept[m_state]]] : number[blockOf[kept[m_startState]]];
+		m_startState = number[blockOf[kept[m_startState]]];
+		if (m_compiled)compile();
+		return std::make_pair(states, blocks);
+	}
+
+
 	template<class T, class E>
 	inline void Statemaschine<T, E>::step(E symbol)
 	{
+		if (m_compiled)
+		{
+			m_state = m_compiled->step(m_state, symbol, m_object);
+			return;
+		}
 		//std::invoke(...)
 		//std::map<std::pair<uint32_t, E>, std::pair<uint32_t, t_memberFunc>> m_transitions;
-		std::map<std::pair<uint32_t, E>, std::pair<uint32_t, t_memberFunc>>::iterator it = m_transitions.find(std::make_pair(m_state, symbol));
+		typename std::map<std::pair<uint32_t, E>, std::pair<uint32_t, t_memberFunc>>::iterator it = m_transitions.find(std::make_pair(m_state, symbol));
 		if (it != m_transitions.end())
 		{
-			if(it->second.second != nullptr && m_object != nullptr)std::invoke(it->second.second, *m_object);
+			if(it->second.second != nullptr && m_object != nullptr)(m_object->*(it->second.second))();
 			m_state = it->second.first;
 		}
 	}
 
+	template<class T, class E>
+	inline void Statemaschine<T, E>::run(const E* begin, const E* end)
+	{
+		if (!m_compiled || (m_compiled->hasHandlers() && m_object != nullptr))
+		{
+			//mit Handlern muss m_state bei jedem Aufruf aktuell sein
+			for (const E* symbol = begin; symbol < end; symbol++)step(*symbol);
+			return;
+		}
+		m_state = m_compiled->run(m_state, begin, end, nullptr);
+	}
+
+	template<class T, class E>
+	inline void Statemaschine<T, E>::runStreams(const E* const* begins, const E* const* ends, uint32_t* states, uint32_t count) const
+	{
+		m_compiled->runStreams(begins, ends, states, count, m_object);
+	}
+
 	template<class T, class E>
 	inline void Statemaschine<T, E>::reset()
 	{
@@ -305,6 +902,346 @@ namespace ds
 		return m_state;
 	}
 
+	template<class T, class E>
+	inline uint32_t Statemaschine<T, E>::startState() const
+	{
+		return m_startState;
+	}
+
+	template<class T, class E>
+	inline CompiledStatemaschine<T, E>::CompiledStatemaschine(uint32_t states, uint32_t startState) : m_accepting(states)
+	{
+		m_numberOfStates = states;
+		m_startState = startState;
+		m_columns = 0;
+		m_stateBits = 0;
+		m_stateMask = 0;
+		m_packed = false;
+	}
+
+	template<class T, class E>
+	inline CompiledStatemaschine<T, E>::~CompiledStatemaschine()
+	{
+
+	}
+
+	template<class T, class E>
+	inline uint32_t CompiledStatemaschine<T, E>::symbolOf(E symbol, std::true_type) const
+	{
+		return m_byteSymbols[uint8_t(symbol)];
+	}
+
+	template<class T, class E>
+	inline uint32_t CompiledStatemaschine<T, E>::symbolOf(E symbol, std::false_type) const
+	{
+		typename std::vector<E>::const_iterator it = std::lower_bound(m_symbols.begin(), m_symbols.end(), symbol);
+		if (it != m_symbols.end() && !(symbol < *it))return uint32_t(it - m_symbols.begin()) + 1;
+		return 0;
+	}
+
+	template<class T, class E>
+	inline uint32_t CompiledStatemaschine<T, E>::symbolOf(E symbol) const
+	{
+		return symbolOf(symbol, std::integral_constant<bool, std::is_integral<E>::value && sizeof(E) == 1>());
+	}
+
+	/*
+		Liest eine Zelle der gepackten Tabelle mit denselben Kernen (unpack), mit denen storeTable sie geschrieben hat.
+	*/
+	template<class T, class E>
+	inline Integer CompiledStatemaschine<T, E>::packedEntry(Integer cell) const
+	{
+		uint64_t entry = 0;
+		m_packedTable.getRange(cell, 1, &entry);
+		return Integer(entry);
+	}
+
+	template<class T, class E>
+	inline Integer CompiledStatemaschine<T, E>::entryOf(uint32_t state, uint32_t symbol) const
+	{
+		Integer cell = Integer(state) * m_columns + symbol;
+		return m_packed ? packedEntry(cell) : Integer(m_table[cell]);
+	}
+
+
+	template<class T, class E>
+	inline uint32_t CompiledStatemaschine<T, E>::transition(uint32_t state, E symbol) const
+	{
+		return uint32_t(entryOf(state, symbolOf(symbol)) & m_stateMask);
+	}
+
+	template<class T, class E>
+	inline uint32_t CompiledStatemaschine<T, E>::step(uint32_t state, E symbol, T* object) const
+	{
+		Integer entry = entryOf(state, symbolOf(symbol));
+		Integer handler = entry >> m_stateBits;
+		if (handler != 0 && object != nullptr)(object->*m_handlers[handler])();
+		return uint32_t(entry & m_stateMask);
+	}
+
+	template<class T, class E>
+	inline uint32_t CompiledStatemaschine<T, E>::run(uint32_t state, const E* begin, const E* end, T* object) const
+	{
+		if (m_handlers.size() > 1 && object != nullptr)
+		{
+			for (const E* symbol = begin; symbol < end; symbol++)state = step(state, *symbol, object);
+			return state;
+		}
+		return runTable(state, begin, end);
+	}
+
+	/*
+		Die Schleife von run ohne Handler.
+	*/
+	template<class T, class E>
+	inline uint32_t CompiledStatemaschine<T, E>::runTable(Integer state, const E* begin, const E* end) const
+	{
+		if (m_packed)
+		{
+			for (const E* symbol = begin; symbol < end; symbol++)state = packedEntry(state * m_columns + symbolOf(*symbol)) & m_stateMask;
+		}
+		else
+		{
+			const uint32_t* table = m_table.data();
+			for (const E* symbol = begin; symbol < end; symbol++)state = table[state * m_columns + symbolOf(*symbol)] & m_stateMask;
+		}
+		return uint32_t(state);
+	}
+
+	/*
+		Schaltet die ersten active Ströme um length Symbole weiter, alle haben noch mindestens length Symbole.
+	*/
+	template<class T, class E>
+	inline void CompiledStatemaschine<T, E>::advanceStreams(const E** positions, uint32_t* states, uint32_t active, Integer length, T* object) const
+	{
+		if (m_handlers.size() > 1 && object != nullptr)
+		{
+			for (Integer i = 0; i < length; i++)
+			{
+				for (uint32_t k = 0; k < active; k++)
+				{
+					Integer entry = entryOf(states[k], symbolOf(positions[k][i]));
+					Integer handler = entry >> m_stateBits;
+					if (handler != 0)(object->*m_handlers[handler])();
+					states[k] = uint32_t(entry & m_stateMask);
+				}
+			}
+		}
+		else if (active == 1)
+		{
+			states[0] = runTable(states[0], positions[0], positions[0] + length);
+		}
+		else if (m_packed)
+		{
+			for (Integer i = 0; i < length; i++)
+			{
+				for (uint32_t k = 0; k < active; k++)states[k] = uint32_t(packedEntry(Integer(states[k]) * m_columns + symbolOf(positions[k][i])) & m_stateMask);
+			}
+		}
+		else
+		{
+			const uint32_t* table = m_table.data();
+			uint32_t first = 0;
+#if STATEMASCHINE_GATHER
+			//je 8 Ströme in einem Register, die Indizes zeile * m_columns + symbol müssen in 31 Bits passen
+			if (std::is_integral<E>::value && sizeof(E) == 1 && active >= 8 && Integer(m_table.size()) < (Integer(1) << 31)
+				&& uint8_t(instructionSet()) >= uint8_t(InstructionSet::AVX2))
+			{
+				first = gatherStreams(positions, states, active, length);
+			}
+#endif
+			for (Integer i = 0; i < length; i++)
+			{
+				for (uint32_t k = first; k < active; k++)states[k] = uint32_t(table[Integer(states[k]) * m_columns + symbolOf(positions[k][i])] & m_stateMask);
+			}
+		}
+		for (uint32_t k = 0; k < active; k++)positions[k] += length;
+	}
+
+	/*
+		Schaltet die ersten 8 * (active / 8) Ströme der ungepackten Tabelle mit AVX2-Gather um length Symbole weiter und liefert
+		die Anzahl dieser Ströme. Wird für die Zielarchitektur AVX2 übersetzt und nur aufgerufen, wenn instructionSet() AVX2
+		meldet (siehe simd.h), die übrige Bibliothek bleibt bei SSE4.2.
+	*/
+	template<class T, class E>
+	SIMD_TARGET("avx2") inline uint32_t CompiledStatemaschine<T, E>::gatherStreams(const E** positions, uint32_t* states, uint32_t active, Integer length) const
+	{
+		const uint32_t* table = m_table.data();
+		__m256i vectorStates[STATEMASCHINE_STREAMS / 8];
+		uint32_t vectors = active / 8;
+		__m256i columns = _mm256_set1_epi32(int32_t(m_columns));
+		__m256i mask = _mm256_set1_epi32(int32_t(uint32_t(m_stateMask)));
+		for (uint32_t v = 0; v < vectors; v++)vectorStates[v] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(states + 8 * v));
+		for (Integer i = 0; i < length; i++)
+		{
+			for (uint32_t v = 0; v < vectors; v++)
+			{
+				const E** p = positions + 8 * v;
+				__m256i symbols = _mm256_setr_epi32(int32_t(symbolOf(p[0][i])), int32_t(symbolOf(p[1][i])), int32_t(symbolOf(p[2][i])), int32_t(symbolOf(p[3][i])),
+					int32_t(symbolOf(p[4][i])), int32_t(symbolOf(p[5][i])), int32_t(symbolOf(p[6][i])), int32_t(symbolOf(p[7][i])));
+				__m256i index = _mm256_add_epi32(_mm256_mullo_epi32(vectorStates[v], columns), symbols);
+				vectorStates[v] = _mm256_and_si256(_mm256_i32gather_epi32(reinterpret_cast<const int*>(table), index, 4), mask);
+			}
+		}
+		for (uint32_t v = 0; v < vectors; v++)_mm256_storeu_si256(reinterpret_cast<__m256i*>(states + 8 * v), vectorStates[v]);
+		return 8 * vectors;
+	}
+
+	template<class T, class E>
+	inline void CompiledStatemaschine<T, E>::runStreams(const E* const* begins, const E* const* ends, uint32_t* states, uint32_t count, T* object) const
+	{
+		for (uint32_t group = 0; group < count; group += STATEMASCHINE_STREAMS)
+		{
+			uint32_t width = count - group < STATEMASCHINE_STREAMS ? count - group : STATEMASCHINE_STREAMS;
+			const E* positions[STATEMASCHINE_STREAMS];
+			const E* limits[STATEMASCHINE_STREAMS];
+			uint32_t current[STATEMASCHINE_STREAMS];
+			uint32_t streams[STATEMASCHINE_STREAMS];
+			uint32_t active = 0;
+			for (uint32_t k = group; k < group + width; k++)
+			{
+				if (begins[k] >= ends[k])continue;
+				positions[active] = begins[k];
+				limits[active] = ends[k];
+				current[active] = states[k];
+				streams[active] = k;
+				active++;
+			}
+			while (active > 0)
+			{
+				//alle Ströme um die kürzeste Restlänge weiterschalten, danach die fertigen entfernen
+				Integer length = limits[0] - positions[0];
+				for (uint32_t k = 1; k < active; k++)
+				{
+					if (Integer(limits[k] - positions[k]) < length)length = limits[k] - positions[k];
+				}
+				advanceStreams(positions, current, active, length, object);
+				uint32_t remaining = 0;
+				for (uint32_t k = 0; k < active; k++)
+				{
+					if (positions[k] == limits[k])
+					{
+						states[streams[k]] = current[k];
+						continue;
+					}
+					positions[remaining] = positions[k];
+					limits[remaining] = limits[k];
+					current[remaining] = current[k];
+					streams[remaining] = streams[k];
+					remaining++;
+				}
+				active = remaining;
+			}
+		}
+	}
+
+
+	template<class T, class E>
+	inline bool CompiledStatemaschine<T, E>::isAccepting(uint32_t state) const
+	{
+		return m_accepting.isBitSet(state);
+	}
+
+	template<class T, class E>
+	inline bool CompiledStatemaschine<T, E>::hasHandlers() const
+	{
+		return m_handlers.size() > 1;
+	}
+
+	template<class T, class E>
+	inline uint32_t CompiledStatemaschine<T, E>::startState() const
+	{
+		return m_startState;
+	}
+
+	template<class T, class E>
+	inline uint32_t CompiledStatemaschine<T, E>::numberOfStates() const
+	{
+		return m_numberOfStates;
+	}
+
+	template<class T, class E>
+	inline Integer CompiledStatemaschine<T, E>::byteSize() const
+	{
+		return Integer(m_table.size()) * sizeof(uint32_t) + (m_packed ? m_packedTable.byteSize() : 0) +
+			m_byteSymbols.size() * sizeof(uint32_t) + m_symbols.size() * sizeof(E) + m_handlers.size() * sizeof(t_memberFunc) + (m_numberOfStates + 7) / 8;
+	}
+
+	template<class T, class E>
+	inline StatemaschineCursor<T, E>::StatemaschineCursor(std::shared_ptr<const CompiledStatemaschine<T, E>> automaton, T* object) : m_automaton(automaton)
+	{
+		m_object = object;
+		m_state = m_automaton->startState();
+	}
+
+	template<class T, class E>
+	inline StatemaschineCursor<T, E>::StatemaschineCursor(std::shared_ptr<const CompiledStatemaschine<T, E>> automaton) : m_automaton(automaton)
+	{
+		m_object = nullptr;
+		m_state = m_automaton->startState();
+	}
+
+	template<class T, class E>
+	inline StatemaschineCursor<T, E>::~StatemaschineCursor()
+	{
+
+	}
+
+	template<class T, class E>
+	inline bool StatemaschineCursor<T, E>::isAbleToCallback() const
+	{
+		return m_object != nullptr;
+	}
+
+	template<class T, class E>
+	inline void StatemaschineCursor<T, E>::setCallbackInstance(T* instance)
+	{
+		m_object = instance;
+		reset();
+	}
+
+	template<class T, class E>
+	inline void StatemaschineCursor<T, E>::step(E symbol)
+	{
+		m_state = m_automaton->step(m_state, symbol, m_object);
+	}
+
+	template<class T, class E>
+	inline void StatemaschineCursor<T, E>::run(const E* begin, const E* end)
+	{
+		if (m_automaton->hasHandlers() && m_object != nullptr)
+		{
+			//mit Handlern muss m_state bei jedem Aufruf aktuell sein
+			for (const E* symbol = begin; symbol < end; symbol++)step(*symbol);
+			return;
+		}
+		m_state = m_automaton->run(m_state, begin, end, nullptr);
+	}
+
+	template<class T, class E>
+	inline void StatemaschineCursor<T, E>::reset()
+	{
+		m_state = m_automaton->startState();
+	}
+
+	template<class T, class E>
+	inline uint32_t StatemaschineCursor<T, E>::stateOf() const
+	{
+		return m_state;
+	}
+
+	template<class T, class E>
+	inline bool StatemaschineCursor<T, E>::isInAcceptingState() const
+	{
+		return m_automaton->isAccepting(m_state);
+	}
+
+	template<class T, class E>
+	inline const CompiledStatemaschine<T, E>& StatemaschineCursor<T, E>::automaton() const
+	{
+		return *m_automaton;
+	}
+
 
 };
 
@@ -0,0 +1,103 @@
+#ifndef __THREADPOOL_H__
+
+#define __THREADPOOL_H__
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "bitmanipulation.h"
+
+namespace ds
+{
+	/**
+	A fixed set of worker threads, which execute the indices of one parallelFor at a time. The calling thread works on the
+	indices as well, so a pool of size 1 has no worker and runs everything inline.
+	*/
+	class ThreadPool
+	{
+	private:
+		std::vector<std::thread> m_workers;
+		std::mutex m_mutex;
+		std::condition_variable m_wake;
+		std::condition_variable m_done;
+		//serializes concurrent calls of parallelFor
+		std::mutex m_jobMutex;
+		const std::function<void(Integer)>* m_task;
+		Integer m_count;
+		std::atomic<Integer> m_next;
+		Integer m_busy;
+		uint64_t m_generation;
+		bool m_stop;
+		std::exception_ptr m_error;
+
+		ThreadPool(const ThreadPool& other) = delete;
+		ThreadPool& operator=(const ThreadPool& other) = delete;
+
+		void work();
+		void drain();
+	public:
+		/**
+		Description: 	Starts threads - 1 workers.
+		Parameter:		threads - The number of threads including the caller, 0 uses std::thread::hardware_concurrency().
+		*/
+		explicit ThreadPool(Integer threads = 0);
+
+		/**
+		Description: 	Stops and joins the workers.
+		*/
+		~ThreadPool();
+
+		/**
+		Description: 	The number of threads, which work on a parallelFor (workers and caller).
+		*/
+		Integer size() const;
+
+		/**
+		Description: 	Calls task(i) for every i in [0, ... , n - 1], distributed over the threads of the pool, and returns
+						after all calls have finished. The first exception thrown by a task is rethrown here.
+		Parameter:		n		- The number of indices.
+						task	- Called once per index, possibly concurrently. The tasks should be coarse (a chunk of work
+								  each), the indices are handed out one at a time.
+						A parallelFor (or parallelSort) of the same pool, which is called from within a task, runs all its
+						indices inline on the calling thread. Concurrent calls from different threads are executed one after
+						another.
+		Complexity: 	O(n / size()) calls per thread.
+		*/
+		void parallelFor(Integer n, const std::function<void(Integer)>& task);
+	};
+
+	/**
+	Description: 	Sorts [first, last) with less: size() chunks are sorted concurrently, then merged pairwise in log(size())
+					rounds, the merges of one round run concurrently.
+	Parameter:		pool	- The threads.
+					first	- Random access iterator to the first element.
+					last	- Random access iterator behind the last element.
+					less	- Strict weak ordering.
+	Complexity: 	O(n log(n) / p + n log(p)) with p = pool.size(), not stable.
+	*/
+	template<typename I, typename C>
+	void parallelSort(ThreadPool& pool, I first, I last, C less)
+	{
+		Integer n = Integer(last - first);
+		Integer chunks = 1;
+		while (chunks < pool.size() && chunks * 2 * 4096 <= n)chunks *= 2;
+		if (chunks == 1)
+		{
+			std::sort(first, last, less);
+			return;
+		}
+		auto bound = [&](Integer c) { return first + (n * c) / chunks; };
+		pool.parallelFor(chunks, [&](Integer c) { std::sort(bound(c), bound(c + 1), less); });
+		for (Integer width = 1; width < chunks; width *= 2)
+		{
+			pool.parallelFor(chunks / (2 * width), [&](Integer m) { std::inplace_merge(bound(2 * m * width), bound((2 * m + 1) * width), bound((2 * m + 2) * width), less); });
+		}
+	}
+};
+
+#endif // !__THREADPOOL_H__
@@ -2,15 +2,113 @@
 
 #define __COMPRESSEDTREE_H__
 
-namespace ds 
+#include "includes.h"
+#include "bitstring.h"
+#include <vector>
+
+/*
+	The range-min-max index of a CompressedTree stores the minimum excess of every block of COMPRESSED_TREE_BLOCK_BITS
+	parentheses in a complete binary tree of 32 bit minima, this costs between 64 and 128 bits per block (6.25% - 12.5%
+	of the parentheses). COMPRESSED_TREE_NONE is returned for a node, which does not exist (parent of the root, first child
+	of a leaf, ...) and marks the root in the parent array.
+*/
+#define COMPRESSED_TREE_BLOCK_BITS 1024
+#define COMPRESSED_TREE_NONE 0xFFFFFFFF
+
+namespace ds
 {
+	/**
+	Static ordinal tree in balanced parentheses: a depth first traversal writes 1 when it enters and 0 when it leaves a
+	node, so a tree with n nodes takes 2n bits. Navigation searches the excess (ones - zeros in front of a position) with
+	the rank directory of the Bitstring and a range-min-max index over blocks of the parentheses. The nodes are identified
+	by their preorder number, the root is 0, the subtree of v are the nodes [v, ... , v + subtreeSize(v) - 1]. The tree
+	holds at most 2^31 - 1 nodes.
+	*/
 	class CompressedTree
 	{
 	private:
-	
+		Bitstring m_parentheses;
+		//m_minTree[m_leaves + b] is the minimum excess behind a parenthesis of block b, the inner nodes hold the minimum of their children
+		std::vector<int32_t> m_minTree;
+		uint32_t m_leaves;
+		uint32_t m_blocks;
+		uint32_t m_nodes;
+
+		void buildIndex();
+		int32_t excessBefore(uint32_t i) const;
+		uint32_t scanForward(uint32_t from, uint32_t to, int32_t target, int32_t& excess) const;
+		uint32_t scanBackward(uint32_t from, uint32_t to, int32_t target, int32_t& excess) const;
+		void scanMinimum(uint32_t from, uint32_t to, int32_t& excess, int32_t& minimum, uint32_t& position) const;
+		uint32_t firstBlockBelow(uint32_t block, int32_t target) const;
+		uint32_t lastBlockBelow(uint32_t block, int32_t target) const;
+		int32_t blockMinimum(uint32_t first, uint32_t last) const;
+		uint32_t forwardSearch(uint32_t from, int32_t target) const;
+		uint32_t backwardSearch(uint32_t to, int32_t target) const;
+		uint32_t minimumPosition(uint32_t from, uint32_t to) const;
+		uint32_t findClose(uint32_t i) const;
+		uint32_t enclose(uint32_t i) const;
 	public:
-	
+		/**
+		Description: 	Builds the tree from the parent of every node.
+		Parameter:		parents - parents[v] is the parent of node v. The nodes have to be numbered in preorder: parents[0] is
+								  COMPRESSED_TREE_NONE (the root) and parents[v] is a node on the path from the root to v - 1.
+		Complexity: 	O(n) time, O(depth) words of temporary space.
+		*/
+		CompressedTree(const std::vector<uint32_t>& parents);
+		/**
+		Description: 	Takes a balanced parentheses sequence of one tree (for example a Bitstring loaded with mapFile). The
+						rank/select directory is built, if the bitstring is not frozen.
+		*/
+		CompressedTree(Bitstring parentheses);
+		/**
+		Result:			The number of nodes.
+		*/
+		uint32_t size() const;
+		/**
+		Result:			The parent of v, COMPRESSED_TREE_NONE for the root.
+		Complexity: 	O(log n).
+		*/
+		uint32_t parent(uint32_t v) const;
+		/**
+		Result:			The leftmost child of v (which is v + 1), COMPRESSED_TREE_NONE for a leaf.
+		Complexity: 	O(1).
+		*/
+		uint32_t firstChild(uint32_t v) const;
+		/**
+		Result:			The next child of the parent of v, COMPRESSED_TREE_NONE, if v is the last child.
+		Complexity: 	O(log n).
+		*/
+		uint32_t nextSibling(uint32_t v) const;
+		/**
+		Result:			The number of nodes in the subtree of v, including v.
+		Complexity: 	O(log n).
+		*/
+		uint32_t subtreeSize(uint32_t v) const;
+		/**
+		Result:			The number of edges between the root and v.
+		Complexity: 	O(1).
+		*/
+		uint32_t depth(uint32_t v) const;
+		/**
+		Result:			The deepest node, which is an ancestor of u and of v (a node is its own ancestor).
+		Complexity: 	O(log n).
+		*/
+		uint32_t lca(uint32_t u, uint32_t v) const;
+		/**
+		Result:			true, if u is an ancestor of v or u == v.
+		Complexity: 	O(log n).
+		*/
+		bool isAncestor(uint32_t u, uint32_t v) const;
+		bool isLeaf(uint32_t v) const;
+		/**
+		Result:			The parentheses, for example to save them (see Bitstring::save).
+		*/
+		const Bitstring& parentheses() const;
+		/**
+		Result:			The memory of the parentheses and of the range-min-max index, without the rank/select directory.
+		*/
+		uint64_t byteSize() const;
 	};
 };
 
-#endif
\ No newline at end of file
+#endif // !__COMPRESSEDTREE_H__
@@ -0,0 +1,187 @@
+#include "ahocorasick.h"
+#include <limits.h>
+
+namespace ds
+{
+	AhoCorasick::AhoCorasick(const std::vector<std::string>& patterns) : m_automaton(2)
+	{
+		m_numberOfPatterns = uint32_t(patterns.size());
+
+		//Alphabet in der Ordnung von char (wie Statemaschine sortiert), Spalte 0 steht für alle anderen Bytes
+		bool used[256] = {};
+		for (const std::string& pattern : patterns)
+		{
+			for (char symbol : pattern)used[uint8_t(symbol)] = true;
+		}
+		std::vector<char> symbols;
+		uint32_t column[256] = {};
+		for (int value = CHAR_MIN; value <= CHAR_MAX; value++)
+		{
+			if (!used[uint8_t(char(value))])continue;
+			symbols.push_back(char(value));
+			column[uint8_t(char(value))] = uint32_t(symbols.size());
+		}
+		Integer width = symbols.size() + 1;
+
+		//Trie, Knoten 0 ist die Wurzel
+		std::vector<uint32_t> next(width, AHO_CORASICK_NONE);
+		std::vector<uint32_t> endNode(patterns.size(), AHO_CORASICK_NONE);
+		uint32_t nodes = 1;
+		for (uint32_t id = 0; id < patterns.size(); id++)
+		{
+			if (patterns[id].empty())continue;
+			uint32_t node = 0;
+			for (char symbol : patterns[id])
+			{
+				Integer cell = node * width + column[uint8_t(symbol)];
+				if (next[cell] == AHO_CORASICK_NONE)
+				{
+					next[cell] = nodes++;
+					next.resize(nodes * width, AHO_CORASICK_NONE);
+				}
+				node = next[cell];
+			}
+			endNode[id] = node;
+		}
+		std::vector<bool> ends(nodes, false);
+		for (uint32_t node : endNode)
+		{
+			if (node != AHO_CORASICK_NONE)ends[node] = true;
+		}
+
+		//Fehlerlinks in Breitensuche: die Zeile des Fehlerlinks ist schon vollständig, fehlende Kanten werden von dort übernommen
+		std::vector<uint32_t> fail(nodes, 0);
+		std::vector<uint32_t> outputLink(nodes, AHO_CORASICK_NONE);
+		std::vector<uint32_t> order(1, 0);
+		for (Integer col = 0; col < width; col++)
+		{
+			if (next[col] == AHO_CORASICK_NONE)next[col] = 0;
+			else order.push_back(next[col]);
+		}
+		for (Integer k = 1; k < order.size(); k++)
+		{
+			uint32_t u = order[k];
+			for (Integer col = 0; col < width; col++)
+			{
+				uint32_t v = next[u * width + col];
+				uint32_t fallback = next[fail[u] * width + col];
+				if (v == AHO_CORASICK_NONE)
+				{
+					next[u * width + col] = fallback;
+					continue;
+				}
+				fail[v] = fallback;
+				outputLink[v] = ends[fail[v]] ? fail[v] : outputLink[fail[v]];
+				order.push_back(v);
+			}
+		}
+
+		//0 Fehlerzustand, 1 Wurzel, dann die nicht akzeptierenden und zuletzt die akzeptierenden Knoten
+		std::vector<uint32_t> number(nodes);
+		uint32_t state = 1;
+		for (uint32_t u : order)
+		{
+			if (!ends[u] && outputLink[u] == AHO_CORASICK_NONE)number[u] = state++;
+		}
+		m_firstAccepting = state;
+		for (uint32_t u : order)
+		{
+			if (ends[u] || outputLink[u] != AHO_CORASICK_NONE)number[u] = state++;
+		}
+		m_numberOfStates = state;
+
+		std::vector<uint32_t> table(Integer(m_numberOfStates) * width);
+		for (uint32_t u = 0; u < nodes; u++)
+		{
+			for (Integer col = 0; col < width; col++)table[number[u] * width + col] = number[next[u * width + col]];
+		}
+		//der Fehlerzustand verhält sich wie die Wurzel
+		for (Integer col = 0; col < width; col++)table[col] = table[width + col];
+
+		//Muster je akzeptierendem Zustand (counting sort nach Zustand)
+		uint32_t accepting = m_numberOfStates - m_firstAccepting;
+		m_patternOffsets.assign(accepting + 1, 0);
+		m_outputLinks.assign(accepting, AHO_CORASICK_NONE);
+		for (uint32_t node : endNode)
+		{
+			if (node != AHO_CORASICK_NONE)m_patternOffsets[number[node] - m_firstAccepting + 1]++;
+		}
+		for (uint32_t a = 0; a < accepting; a++)m_patternOffsets[a + 1] += m_patternOffsets[a];
+		m_patterns.resize(m_patternOffsets[accepting]);
+		{
+			std::vector<uint32_t> fill(m_patternOffsets.begin(), m_patternOffsets.end() - 1);
+			for (uint32_t id = 0; id < endNode.size(); id++)
+			{
+				if (endNode[id] != AHO_CORASICK_NONE)m_patterns[fill[number[endNode[id]] - m_firstAccepting]++] = id;
+			}
+		}
+		for (uint32_t u = 0; u < nodes; u++)
+		{
+			if (number[u] < m_firstAccepting)continue;
+			if (outputLink[u] != AHO_CORASICK_NONE)m_outputLinks[number[u] - m_firstAccepting] = number[outputLink[u]];
+		}
+
+		for (uint32_t s = m_firstAccepting; s < m_numberOfStates; s++)m_automaton.addAcceptingState(s);
+		m_automaton.compile(symbols, table);
+	}
+
+	AhoCorasick::~AhoCorasick()
+	{
+
+	}
+
+	uint32_t AhoCorasick::match(const char* begin, const char* end, uint32_t state, Integer offset, const std::function<void(const AhoCorasickHit*, Integer)>& report) const
+	{
+		const CompiledStatemaschine<AhoCorasick, char>& automaton = *m_automaton.compiled();
+		AhoCorasickHit hits[AHO_CORASICK_BATCH];
+		Integer count = 0;
+		for (const char* symbol = begin; symbol < end; symbol++)
+		{
+			state = automaton.transition(state, *symbol);
+			if (state < m_firstAccepting)continue;
+			//eigene Muster, dann die kürzeren über die Ausgabelinks
+			for (uint32_t s = state; s != AHO_CORASICK_NONE; s = m_outputLinks[s - m_firstAccepting])
+			{
+				for (uint32_t k = m_patternOffsets[s - m_firstAccepting]; k < m_patternOffsets[s - m_firstAccepting + 1]; k++)
+				{
+					hits[count].m_end = offset + Integer(symbol - begin) + 1;
+					hits[count].m_pattern = m_patterns[k];
+					if (++count == AHO_CORASICK_BATCH)
+					{
+						report(hits, count);
+						count = 0;
+					}
+				}
+			}
+		}
+		if (count > 0)report(hits, count);
+		return state;
+	}
+
+	Integer AhoCorasick::count(const char* begin, const char* end) const
+	{
+		Integer result = 0;
+		match(begin, end, start(), 0, [&](const AhoCorasickHit*, Integer n) { result += n; });
+		return result;
+	}
+
+	uint32_t AhoCorasick::start() const
+	{
+		return 1;
+	}
+
+	uint32_t AhoCorasick::numberOfStates() const
+	{
+		return m_numberOfStates;
+	}
+
+	uint32_t AhoCorasick::numberOfPatterns() const
+	{
+		return m_numberOfPatterns;
+	}
+
+	const Statemaschine<AhoCorasick, char>& AhoCorasick::automaton() const
+	{
+		return m_automaton;
+	}
+};
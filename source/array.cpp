@@ -1,5 +1,7 @@
 #include "stdafx.h"
 #include "array.h"
+#include "simd.h"
+#include "fileformat.h"
 
 namespace ds
 {
@@ -8,8 +10,9 @@ namespace ds
 		Integer bitsize = size * tau;
 		//Integer arrLength = (bitsize / 32) + 1;
 		Integer arrLength = (bitsize / (sizeof(Integer) * 8)) + 1;
-		//m_content = (Integer*)aligned_alloc(16, arrLength * sizeof(Integer));
+		m_content = (Integer*)aligned_alloc(16, arrLength * sizeof(Integer));
 		m_length = arrLength;
+		m_numElements = size;
 #pragma loop count(m_length)
 		for (Integer i = 0; i < m_length; i++)m_content[i] = 0;
 		m_tau = tau;
@@ -23,22 +26,24 @@ namespace ds
 		m_numElements = 0;
 	}
 
-	Array::Array(const Array & other)
+	Array::Array(const Array & other) : m_content(nullptr)
 	{
 		*this = other;
 	}
 
-	Array::Array(Array && other)
+	Array::Array(Array && other) : m_content(nullptr)
 	{
-		*this = other;
+		*this = std::move(other);
 	}
 
 	Array & Array::operator=(const Array & other)
 	{
 		if (this == &other)return *this;
+		release();
 		m_tau = other.m_tau;
 		m_length = other.m_length;
-		m_content = new Integer[m_length];
+		//a copy of a mapped array owns its words
+		m_content = (Integer*)aligned_alloc(16, m_length * sizeof(Integer));
 		m_numElements = other.m_numElements;
 #pragma loop count(m_length)
 		for (Integer i = 0; i < m_length; i++)m_content[i] = other.m_content[i];
@@ -48,9 +53,11 @@ namespace ds
 	Array & Array::operator=(Array && other)
 	{
 		if (this == &other)return *this;
+		release();
 		m_tau = other.m_tau;
 		m_length = other.m_length;
 		m_content = other.m_content;
+		m_mapping = std::move(other.m_mapping);
 		other.m_content = nullptr;
 		m_numElements = other.m_numElements;
 		return *this;
@@ -58,7 +65,14 @@ namespace ds
 
 	Array::~Array()
 	{
-		if (m_content)free(m_content);
+		release();
+	}
+
+	void Array::release()
+	{
+		if (m_content && !m_mapping)free(m_content);
+		m_content = nullptr;
+		m_mapping.reset();
 	}
 
 	Integer Array::operator[](Integer i) const
@@ -79,6 +93,48 @@ namespace ds
 		return operator[](i);
 	}
 
+	void Array::getRange(Integer first, Integer n, uint64_t* out) const
+	{
+		if (!m_content || m_tau == 0 || m_tau > IntegerBitSize)return;
+#ifdef SIMD
+		unpackSimd(m_content, m_tau, first, n, out);
+#else
+		s_unpackTable[m_tau](m_content, first, n, out);
+#endif
+	}
+
+	void Array::setRange(Integer first, Integer n, const uint64_t* in)
+	{
+		if (m_content && m_tau > 0 && m_tau <= IntegerBitSize)s_packTable[m_tau](in, first, n, m_content);
+	}
+
+	bool Array::save(const std::string& path) const
+	{
+		if (!m_content)return false;
+		return writePackedFile(path, PackedFileType::Array, sizeof(Integer), m_tau, m_numElements, m_content, m_length * sizeof(Integer));
+	}
+
+	bool Array::mapFile(const std::string& path, bool verify)
+	{
+		PackedFileHeader header;
+		std::shared_ptr<MappedFile> mapping = mapPackedFile(path, PackedFileType::Array, sizeof(Integer), header, verify);
+		if (!mapping)return false;
+		Integer words = header.payloadBytes / sizeof(Integer);
+		if (header.tau == 0 || header.tau > IntegerBitSize || words * IntegerBitSize < header.numberOfElements * header.tau)return false;
+		release();
+		m_tau = header.tau;
+		m_length = words;
+		m_numElements = header.numberOfElements;
+		m_content = reinterpret_cast<Integer*>(mapping->data() + PACKED_FILE_ALIGNMENT);
+		m_mapping = mapping;
+		return true;
+	}
+
+	bool Array::isMapped() const
+	{
+		return m_mapping != nullptr;
+	}
+
 	Integer Array::length() const
 	{
 		return m_numElements;
@@ -94,6 +150,210 @@ namespace ds
 		return 3 * sizeof(Integer) + sizeof(Integer*) + m_numElements * sizeof(Integer);
 	}
 
+	DynamicArray::DynamicArray()
+	{
+		m_tau = 1;
+		m_numElements = 0;
+		m_capacity = 0;
+		m_content = nullptr;
+	}
+
+	DynamicArray::DynamicArray(Integer tau)
+	{
+		m_tau = tau == 0 ? 1 : tau;
+		m_numElements = 0;
+		m_capacity = 0;
+		m_content = nullptr;
+	}
+
+	DynamicArray::DynamicArray(Integer size, Integer tau)
+	{
+		m_tau = tau == 0 ? 1 : tau;
+		m_numElements = size;
+		m_capacity = 0;
+		m_content = nullptr;
+		reallocate(size, m_tau);
+	}
+
+	DynamicArray::DynamicArray(const DynamicArray& other) : m_content(nullptr)
+	{
+		*this = other;
+	}
+
+	DynamicArray::DynamicArray(DynamicArray&& other) : m_content(nullptr)
+	{
+		*this = std::move(other);
+	}
+
+	DynamicArray& DynamicArray::operator=(const DynamicArray& other)
+	{
+		if (this == &other)return *this;
+		if (m_content)free(m_content);
+		m_tau = other.m_tau;
+		m_numElements = other.m_numElements;
+		m_capacity = other.m_capacity;
+		m_content = nullptr;
+		if (other.m_content)
+		{
+			Integer words = wordsFor(m_capacity, m_tau);
+			m_content = (Integer*)aligned_alloc(16, words * sizeof(Integer));
+			for (Integer i = 0; i < words; i++)m_content[i] = other.m_content[i];
+		}
+		return *this;
+	}
+
+	DynamicArray& DynamicArray::operator=(DynamicArray&& other)
+	{
+		if (this == &other)return *this;
+		if (m_content)free(m_content);
+		m_tau = other.m_tau;
+		m_numElements = other.m_numElements;
+		m_capacity = other.m_capacity;
+		m_content = other.m_content;
+		other.m_content = nullptr;
+		other.m_numElements = 0;
+		other.m_capacity = 0;
+		return *this;
+	}
+
+	DynamicArray::~DynamicArray()
+	{
+		if (m_content)free(m_content);
+	}
+
+	Integer DynamicArray::wordsFor(Integer capacity, Integer tau)
+	{
+		return (capacity * tau) / IntegerBitSize + 1;
+	}
+
+	Integer DynamicArray::bitsFor(Integer value)
+	{
+		Integer tau = 1;
+		while (tau < IntegerBitSize && (value >> tau) != 0)tau++;
+		return tau;
+	}
+
+	void DynamicArray::reallocate(Integer capacity, Integer tau)
+	{
+		Integer words = wordsFor(capacity, tau);
+		Integer* content = (Integer*)aligned_alloc(16, words * sizeof(Integer));
+		for (Integer i = 0; i < words; i++)content[i] = 0;
+
+		if (m_content)
+		{
+			Integer count = m_numElements < capacity ? m_numElements : capacity;
+			if (tau == m_tau)
+			{
+				Integer used = (count * tau + IntegerBitSize - 1) / IntegerBitSize;
+				for (Integer i = 0; i < used; i++)content[i] = m_content[i];
+			}
+			else
+			{
+				//bulk repacking, 256 elements per round trip through the buffer
+				uint64_t buffer[256];
+				for (Integer i = 0; i < count; i += 256)
+				{
+					Integer chunk = count - i < 256 ? count - i : 256;
+					s_unpackTable[m_tau](m_content, i, chunk, buffer);
+					s_packTable[tau](buffer, i, chunk, content);
+				}
+			}
+			free(m_content);
+		}
+		m_content = content;
+		m_capacity = capacity;
+		m_tau = tau;
+	}
+
+	Integer DynamicArray::operator[](Integer i) const
+	{
+		uint64_t value = 0;
+		if (m_content)s_unpackTable[m_tau](m_content, i, 1, &value);
+		return Integer(value);
+	}
+
+	Integer DynamicArray::get(Integer i) const
+	{
+		return operator[](i);
+	}
+
+	void DynamicArray::set(Integer i, Integer value)
+	{
+		if ((value >> (m_tau - 1)) > 1)changeTau(bitsFor(value));
+		uint64_t in = value;
+		if (m_content)s_packTable[m_tau](&in, i, 1, m_content);
+	}
+
+	void DynamicArray::push_back(Integer value)
+	{
+		if ((value >> (m_tau - 1)) > 1)changeTau(bitsFor(value));
+		if (m_numElements == m_capacity)reserve(m_capacity < 16 ? 16 : 2 * m_capacity);
+		uint64_t in = value;
+		s_packTable[m_tau](&in, m_numElements, 1, m_content);
+		m_numElements++;
+	}
+
+	void DynamicArray::pop_back()
+	{
+		if (m_numElements > 0)m_numElements--;
+	}
+
+	void DynamicArray::getRange(Integer first, Integer n, uint64_t* out) const
+	{
+		if (m_content)s_unpackTable[m_tau](m_content, first, n, out);
+	}
+
+	void DynamicArray::setRange(Integer first, Integer n, const uint64_t* in)
+	{
+		Integer maximum = 0;
+		for (Integer k = 0; k < n; k++)maximum |= Integer(in[k]);
+		if ((maximum >> (m_tau - 1)) > 1)changeTau(bitsFor(maximum));
+		if (m_content)s_packTable[m_tau](in, first, n, m_content);
+	}
+
+	void DynamicArray::reserve(Integer capacity)
+	{
+		if (capacity > m_capacity)reallocate(capacity, m_tau);
+	}
+
+	void DynamicArray::shrink_to_fit()
+	{
+		if (m_capacity > m_numElements)reallocate(m_numElements, m_tau);
+	}
+
+	void DynamicArray::changeTau(Integer tau)
+	{
+		if (tau == 0 || tau > IntegerBitSize || tau == m_tau)return;
+		if (m_content)
+		{
+			reallocate(m_capacity, tau);
+		}
+		else
+		{
+			m_tau = tau;
+		}
+	}
+
+	Integer DynamicArray::length() const
+	{
+		return m_numElements;
+	}
+
+	Integer DynamicArray::capacity() const
+	{
+		return m_capacity;
+	}
+
+	Integer DynamicArray::tau() const
+	{
+		return m_tau;
+	}
+
+	Integer DynamicArray::byteSize() const
+	{
+		return sizeof(*this) + (m_content ? wordsFor(m_capacity, m_tau) * sizeof(Integer) : 0);
+	}
+
 	Array2D::Array2D(Integer width, Integer height, Integer tau)
 	{
 		m_content = Array(width * height, tau);
@@ -1,160 +1,362 @@
 #include "binaryTree.h"
+#include <algorithm>
 
 namespace ds
 {
-	/*
-	uint32_t BalancedBinaryTree::left(uint32_t c)
+	Integer BalancedBinaryTree::left(Integer c)
 	{
 		return 2 * c + 1;
 	}
 
-	uint32_t BalancedBinaryTree::right(uint32_t c)
+	Integer BalancedBinaryTree::right(Integer c)
 	{
 		return 2 * c + 2;
 	}
 
-	uint32_t BalancedBinaryTree::parent(uint32_t c)
+	Integer BalancedBinaryTree::parent(Integer c)
+	{
+		return (c - 1) / 2;
+	}
+
+	Integer BalancedBinaryTree::depthOf(Integer c)
+	{
+		Integer depth = 0;
+		while (c > 0)
+		{
+			c = parent(c);
+			depth++;
+		}
+		return depth;
+	}
+
+	Integer BalancedBinaryTree::levelsFor(Integer size)
+	{
+		Integer levels = 0;
+		while ((Integer(1) << levels) - 1 < size)levels++;
+		return levels;
+	}
+
+	Integer BalancedBinaryTree::tauFor(Integer value)
 	{
-		return c / 2;
+		//value has to be smaller than the empty mask 2^tau - 1
+		Integer tau = 1;
+		while (tau < IntegerBitSize && value >= (Integer(1) << tau) - 1)tau++;
+		return tau;
 	}
 
-	BalancedBinaryTree::BalancedBinaryTree(uint32_t size, uint8_t tau)
+	BalancedBinaryTree::BalancedBinaryTree(Integer size, Integer tau) : m_count(0)
 	{
-		m_emptyMask = tau == 32 ? ~((uint32_t)0) : (((uint32_t)1) << tau) - 1;
-		m_content = Array(size, tau);
-		for(uint32_t i = 0;i < size;i++)m_content[i] = m_emptyMask;
+		m_emptyMask = tau == IntegerBitSize ? ~Integer(0) : (Integer(1) << tau) - 1;
+		m_levels = levelsFor(size);
+		m_content = Array((Integer(1) << m_levels) - 1, tau);
+		uint64_t buffer[256];
+		std::fill(buffer, buffer + 256, uint64_t(m_emptyMask));
+		for (Integer i = 0; i < m_content.length(); i += 256)m_content.setRange(i, m_content.length() - i < 256 ? m_content.length() - i : 256, buffer);
 	}
 
 	BalancedBinaryTree::~BalancedBinaryTree()
 	{
-		
+
+	}
+
+	/*
+		Single slots are read and written with the same kernels as the bulk accesses (getRange/setRange).
+	*/
+	Integer BalancedBinaryTree::slot(Integer node) const
+	{
+		uint64_t value = 0;
+		m_content.getRange(node, 1, &value);
+		return Integer(value);
 	}
 
-	BalancedBinaryTree::isLeaf(uint32_t node)
+	void BalancedBinaryTree::setSlot(Integer node, Integer value)
 	{
-		if(m_content[node] == m_emptyMask)return true;
-		return false;	
+		uint64_t in = value;
+		m_content.setRange(node, 1, &in);
 	}
 
-	void BalancedBinaryTree::changeTau(uint8_t tau)
+	bool BalancedBinaryTree::isEmpty(Integer node) const
 	{
-		if(tau <= m_content.tau())return;
-		
-		emptyMask = tau == 32 ? ~((uint32_t)0) : (((uint32_t)1) << tau) - 1;
-		Array a = Array(m_content.length(), tau);
-		
-		for(uint32_t i = 0;i < m_content.length();i++)
+		return node >= m_content.length() || slot(node) == m_emptyMask;
+	}
+
+	Integer BalancedBinaryTree::find(Integer value) const
+	{
+		//one slot read per level, the empty check uses the same value
+		Integer node = 0;
+		while (node < m_content.length())
 		{
-			if(a.get(i) == m_emptyMask)
-			{
-				a.set(i, emptyMask);
-			}
-			else
-			{
-				a.set(i, m_content[i]);
-			}
+			Integer content = slot(node);
+			if (content == m_emptyMask)break;
+			if (content == value)return node;
+			node = value < content ? left(node) : right(node);
 		}
-		m_emptyMask = emptyMask;
-		m_content = a;
+		return m_content.length();
 	}
 
-	void BalancedBinaryTree::resize(uint32_t size)
+	/*
+		The slots of the subtree of root in level order, the level k below root are the 2^k slots from (root + 1) * 2^k - 1 on.
+	*/
+	void BalancedBinaryTree::readSubtree(Integer root, std::vector<uint64_t>& slots) const
 	{
-		if(size <= m_content.length())return;
-		Array a = Array(size, m_content.tau());
-		
-		for(uint32_t i = 0;i < m_content.length();i++)
+		slots.clear();
+		for (Integer width = 1; (root + 1) * width - 1 < m_content.length(); width *= 2)
 		{
-			a.set(i, m_content[i]);
+			Integer first = (root + 1) * width - 1;
+			slots.resize(slots.size() + width);
+			m_content.getRange(first, width, slots.data() + slots.size() - width);
 		}
-		for(uint32_t i = m_content.length();i < a.length();i++)
+	}
+
+	Integer BalancedBinaryTree::countNodes(Integer root) const
+	{
+		Integer count = 0;
+		uint64_t buffer[256];
+		for (Integer width = 1; (root + 1) * width - 1 < m_content.length(); width *= 2)
 		{
-			a.set(i, m_emptyMask);
+			Integer first = (root + 1) * width - 1;
+			for (Integer i = 0; i < width; i += 256)
+			{
+				Integer chunk = width - i < 256 ? width - i : 256;
+				m_content.getRange(first + i, chunk, buffer);
+				for (Integer k = 0; k < chunk; k++)count += buffer[k] != m_emptyMask;
+			}
 		}
-		m_content = a;
+		return count;
 	}
 
-	void BalancedBinaryTree::insert(uint32_t value)
+	void BalancedBinaryTree::collect(Integer root, std::vector<Integer>& sorted) const
 	{
-		uint32_t node = 0;
-		while(!(isLeaf(node)))
+		std::vector<uint64_t> slots;
+		readSubtree(root, slots);
+		//inorder on the local indices of the subtree (the children of i are 2i + 1 and 2i + 2 as well)
+		std::vector<Integer> stack;
+		Integer node = 0;
+		while (true)
 		{
-			if(m_content[node] < value)
+			while (node < slots.size() && slots[node] != m_emptyMask)
 			{
+				stack.push_back(node);
 				node = left(node);
 			}
-			else 
+			if (stack.empty())break;
+			node = stack.back();
+			stack.pop_back();
+			sorted.push_back(slots[node]);
+			node = right(node);
+		}
+	}
+
+	/*
+		Writes sorted[first, ... , last - 1] perfectly balanced below the local slot node: the middle element becomes the root,
+		so the free slots of the last level are spread evenly and inserts at both ends find room.
+	*/
+	void BalancedBinaryTree::fill(std::vector<uint64_t>& slots, Integer node, const std::vector<Integer>& sorted, Integer first, Integer last)
+	{
+		if (first >= last)return;
+		Integer middle = first + (last - first) / 2;
+		slots[node] = sorted[middle];
+		fill(slots, left(node), sorted, first, middle);
+		fill(slots, right(node), sorted, middle + 1, last);
+	}
+
+	/*
+		Overwrites the subtree of root with sorted, the slots are written level by level in bulk.
+	*/
+	void BalancedBinaryTree::place(Integer root, const std::vector<Integer>& sorted)
+	{
+		Integer slotCount = (Integer(1) << (m_levels - depthOf(root))) - 1;
+		std::vector<uint64_t> slots(slotCount, m_emptyMask);
+		fill(slots, 0, sorted, 0, sorted.size());
+		Integer offset = 0;
+		for (Integer width = 1; offset < slotCount; width *= 2)
+		{
+			m_content.setRange((root + 1) * width - 1, width, slots.data() + offset);
+			offset += width;
+		}
+	}
+
+	/*
+		Changes the array to 2^levels - 1 slots. More levels keep every node in its slot, fewer levels rebuild the tree.
+	*/
+	void BalancedBinaryTree::resizeLevels(Integer levels)
+	{
+		Array content((Integer(1) << levels) - 1, m_content.tau());
+		uint64_t buffer[256];
+		if (levels > m_levels)
+		{
+			Integer old = m_content.length();
+			for (Integer i = 0; i < content.length(); i += 256)
 			{
-				node = right(node);
+				Integer chunk = content.length() - i < 256 ? content.length() - i : 256;
+				for (Integer k = 0; k < chunk; k++)buffer[k] = m_emptyMask;
+				if (i < old)m_content.getRange(i, (old - i < chunk ? old - i : chunk), buffer);
+				content.setRange(i, chunk, buffer);
 			}
+			m_content = std::move(content);
+			m_levels = levels;
+		}
+		else if (levels < m_levels)
+		{
+			std::vector<Integer> sorted;
+			collect(0, sorted);
+			m_content = std::move(content);
+			m_levels = levels;
+			if (m_levels > 0)place(0, sorted);
 		}
-		m_content[node] = value;
-		balance();
 	}
 
-	uint32_t find(uint32_t start, uint32_t val) const
+	void BalancedBinaryTree::insert(Integer value)
 	{
-		if(start >= m_content.length()) return m_content.length();
-		
-		uint32_t content = m_content[start];
-		if(content < val)
+		if (value >= m_emptyMask)changeTau(tauFor(value));
+
+		Integer node = 0;
+		for (Integer content; node < m_content.length() && (content = slot(node)) != m_emptyMask; )node = value < content ? left(node) : right(node);
+		if (node < m_content.length())
 		{
-			return find(right(start), val);
+			setSlot(node, value);
+			m_count++;
+			return;
 		}
-		else if(content == val)
+
+		//the path is full: look for the lowest ancestor, which can take value below its density threshold
+		Integer child = node;
+		Integer size = 0;
+		while (child > 0)
 		{
-			return start;
+			Integer ancestor = parent(child);
+			Integer sibling = child & 1 ? child + 1 : child - 1;
+			size += 1 + countNodes(sibling);
+			Integer depth = depthOf(ancestor);
+			Integer slots = (Integer(1) << (m_levels - depth)) - 1;
+			//(size + 1) / slots <= 1/2 + depth / (2 levels)
+			if ((size + 1) * 2 * m_levels <= slots * (m_levels + depth))
+			{
+				std::vector<Integer> sorted;
+				collect(ancestor, sorted);
+				sorted.insert(std::upper_bound(sorted.begin(), sorted.end(), value), value);
+				place(ancestor, sorted);
+				m_count++;
+				return;
+			}
+			child = ancestor;
 		}
-		else 
+		resizeLevels(m_levels + 1);
+		setSlot(node, value);
+		m_count++;
+	}
+
+	bool BalancedBinaryTree::remove(Integer value)
+	{
+		Integer node = find(value);
+		if (node >= m_content.length())return false;
+
+		//move the predecessor (or the successor) up, until the freed slot is a leaf
+		while (true)
 		{
-			return find(left(start), val);
+			Integer next = left(node);
+			if (!isEmpty(next))
+			{
+				while (!isEmpty(right(next)))next = right(next);
+			}
+			else
+			{
+				next = right(node);
+				if (isEmpty(next))break;
+				while (!isEmpty(left(next)))next = left(next);
+			}
+			setSlot(node, slot(next));
+			node = next;
 		}
+		setSlot(node, m_emptyMask);
+		m_count--;
+
+		if (m_levels > 1 && 8 * m_count < m_content.length())resizeLevels(levelsFor(2 * m_count));
+		return true;
 	}
 
-	void BalancedBinaryTree::remove(uint32_t value)
+	bool BalancedBinaryTree::contains(Integer value) const
 	{
-		uint32_t index = find(0, value);
-		if(index == m_content.length())return;
-		
-		uint32_t left = left(index);
-		while(left < m_content.length() && m_content[left] != m_empyMask)
+		return find(value) < m_content.length();
+	}
+
+	void BalancedBinaryTree::collect(std::vector<Integer>& sorted) const
+	{
+		if (m_content.length() > 0)collect(0, sorted);
+	}
+
+	Integer BalancedBinaryTree::count() const
+	{
+		return m_count;
+	}
+
+	Integer BalancedBinaryTree::height() const
+	{
+		//the last used slot lies on the deepest level
+		uint64_t buffer[256];
+		Integer i = m_content.length();
+		while (i > 0)
 		{
-			m_content.set(index, m_content[left]);
-			index = left;
-			
+			Integer chunk = i < 256 ? i : 256;
+			i -= chunk;
+			m_content.getRange(i, chunk, buffer);
+			for (Integer k = chunk; k > 0; k--)
+			{
+				if (buffer[k - 1] != m_emptyMask)return depthOf(i + k - 1) + 1;
+			}
 		}
+		return 0;
 	}
 
-	void BalancedBinaryTree::count() const
+	bool BalancedBinaryTree::changeTau(Integer tau)
 	{
-		uint32_t i = 0;
-		uint32_t mask = 0;
-		mask = ~mask;
-		while(i < m_content.length() && m_content[i] == mask)
+		if (tau == 0 || tau > IntegerBitSize)return false;
+		if (tau == m_content.tau())return true;
+		Integer emptyMask = tau == IntegerBitSize ? ~Integer(0) : (Integer(1) << tau) - 1;
+		if (m_count > 0 && tau < m_content.tau())
 		{
-			i++;
+			//the largest value is the rightmost node
+			Integer node = 0;
+			while (!isEmpty(right(node)))node = right(node);
+			if (slot(node) >= emptyMask)return false;
 		}
-		return i;
+
+		//bulk repacking, 256 slots per round trip through the buffer, the empty marks are translated
+		Array content(m_content.length(), tau);
+		uint64_t buffer[256];
+		for (Integer i = 0; i < m_content.length(); i += 256)
+		{
+			Integer chunk = m_content.length() - i < 256 ? m_content.length() - i : 256;
+			m_content.getRange(i, chunk, buffer);
+			for (Integer k = 0; k < chunk; k++)
+			{
+				if (buffer[k] == m_emptyMask)buffer[k] = emptyMask;
+			}
+			content.setRange(i, chunk, buffer);
+		}
+		m_content = std::move(content);
+		m_emptyMask = emptyMask;
+		return true;
 	}
 
-	uint32_t BalancedBinaryTree::height(uint32_t node) const
+	void BalancedBinaryTree::resize(Integer size)
 	{
-		if(isLeaf(node))return 0;
-		
-		uint32_t l = height(left(node));
-		uint32_t r = height(right(node));
-		if(l > r)return l + 1;
-		return r + 1;
+		Integer levels = levelsFor(size < m_count ? m_count : size);
+		resizeLevels(levels);
 	}
 
-	uint32_t BalancedBinaryTree::height() const
+	Integer BalancedBinaryTree::tau() const
 	{
-		return height(0);
+		return m_content.tau();
 	}
 
-	uint8_t BalancedBinaryTree::tau() const
+	Integer BalancedBinaryTree::capacity() const
 	{
-		return m_content.tau();
+		return m_content.length();
 	}
-	*/
-};
\ No newline at end of file
+
+	Integer BalancedBinaryTree::byteSize() const
+	{
+		return sizeof(*this) + (m_content.length() * m_content.tau() / IntegerBitSize + 1) * sizeof(Integer);
+	}
+};
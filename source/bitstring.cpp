@@ -1,47 +1,87 @@
 #include "bitstring.h"
+#include "fileformat.h"
+#if _WIN32 || _WIN64
+#include <intrin.h>
+#endif
 
 ds::Bitstring::Bitstring(uint32_t size)
 {
 	m_numElements = size;
-	m_size = (size + (size - size % 32)) / 32;
-	m_content = (uint32_t*)_aligned_malloc(m_size * sizeof(uint32_t), 16);
+	//whole blocks of RANK_SUBBLOCK_BITS bits, so the directory can read 64 bit words
+	m_size = (size / RANK_SUBBLOCK_BITS + 1) * (RANK_SUBBLOCK_BITS / 32);
+	m_content = (uint32_t*)_aligned_malloc(m_size * sizeof(uint32_t), 64);
 	for (uint32_t i = 0; i < m_size; i++)m_content[i] = 0;
+	m_rankDirectory = nullptr;
+	m_selectSamples = nullptr;
+	m_selectZeroSamples = nullptr;
+	m_numberOfBlocks = 0;
+	m_numberOfSamples = 0;
+	m_numberOfZeroSamples = 0;
+	m_numberOfOnes = 0;
 }
 
 ds::Bitstring::~Bitstring()
 {
-	if (m_content)_aligned_free(m_content);
+	releaseContent();
+	releaseDirectory();
 }
 
-ds::Bitstring::Bitstring(const Bitstring & other)
+ds::Bitstring::Bitstring(const Bitstring & other) : m_content(nullptr), m_rankDirectory(nullptr), m_selectSamples(nullptr), m_selectZeroSamples(nullptr)
 {
 	*this = other;
 }
 
-ds::Bitstring::Bitstring(Bitstring && other)
+ds::Bitstring::Bitstring(Bitstring && other) : m_content(nullptr), m_rankDirectory(nullptr), m_selectSamples(nullptr), m_selectZeroSamples(nullptr)
 {
-	*this = other;
+	*this = std::move(other);
 }
 
 ds::Bitstring & ds::Bitstring::operator=(const Bitstring & other)
 {
 	if (this == &other)return *this;
-	if (m_content)_aligned_free(m_content);
-	m_content = (uint32_t*)_aligned_malloc(other.m_size * sizeof(uint32_t), 16);
+	releaseContent();
+	releaseDirectory();
+	//a copy of a mapped bitstring owns its words
+	m_content = (uint32_t*)_aligned_malloc(other.m_size * sizeof(uint32_t), 64);
 	for (uint32_t i = 0; i < other.m_size; i++)m_content[i] = other.m_content[i];
 	m_size = other.m_size;
 	m_numElements = other.m_numElements;
+	m_numberOfBlocks = other.m_numberOfBlocks;
+	m_numberOfSamples = other.m_numberOfSamples;
+	m_numberOfZeroSamples = other.m_numberOfZeroSamples;
+	m_numberOfOnes = other.m_numberOfOnes;
+	if (other.m_rankDirectory)
+	{
+		m_rankDirectory = (uint64_t*)_aligned_malloc((m_numberOfBlocks + 1) * sizeof(uint64_t), 64);
+		for (uint32_t i = 0; i <= m_numberOfBlocks; i++)m_rankDirectory[i] = other.m_rankDirectory[i];
+		m_selectSamples = (uint32_t*)_aligned_malloc((m_numberOfSamples + 1) * sizeof(uint32_t), 64);
+		for (uint32_t i = 0; i <= m_numberOfSamples; i++)m_selectSamples[i] = other.m_selectSamples[i];
+		m_selectZeroSamples = (uint32_t*)_aligned_malloc((m_numberOfZeroSamples + 1) * sizeof(uint32_t), 64);
+		for (uint32_t i = 0; i <= m_numberOfZeroSamples; i++)m_selectZeroSamples[i] = other.m_selectZeroSamples[i];
+	}
 	return *this;
 }
 
 ds::Bitstring & ds::Bitstring::operator=(Bitstring && other)
 {
 	if (this == &other)return *this;
-	if (m_content)_aligned_free(m_content);
+	releaseContent();
+	releaseDirectory();
 	m_content = other.m_content;
 	other.m_content = nullptr;
+	m_mapping = std::move(other.m_mapping);
+	m_rankDirectory = other.m_rankDirectory;
+	other.m_rankDirectory = nullptr;
+	m_selectSamples = other.m_selectSamples;
+	other.m_selectSamples = nullptr;
+	m_selectZeroSamples = other.m_selectZeroSamples;
+	other.m_selectZeroSamples = nullptr;
 	m_size = other.m_size;
 	m_numElements = other.m_numElements;
+	m_numberOfBlocks = other.m_numberOfBlocks;
+	m_numberOfSamples = other.m_numberOfSamples;
+	m_numberOfZeroSamples = other.m_numberOfZeroSamples;
+	m_numberOfOnes = other.m_numberOfOnes;
 	return *this;
 }
 
@@ -52,15 +92,254 @@ bool ds::Bitstring::isBitSet(uint32_t i) const
 
 void ds::Bitstring::setBit(uint32_t i)
 {
+	if (m_rankDirectory)releaseDirectory();
 	setBit32(i, true, m_content);
 }
 
 void ds::Bitstring::resetBit(uint32_t i)
 {
-	setBit32(i, false, m_content);
+	if (m_rankDirectory)releaseDirectory();
+	resetBit32(i, m_content);
+}
+
+bool ds::Bitstring::testAndSetBit(uint32_t i)
+{
+	uint32_t mask = s_one32 << (i & mod32mask);
+	uint32_t* word = &m_content[i / 32];
+	//the read first avoids the locked instruction for bits, which are set already
+#if _WIN32 || _WIN64
+	if (*reinterpret_cast<volatile uint32_t*>(word) & mask)return false;
+	uint32_t old = uint32_t(_InterlockedOr(reinterpret_cast<volatile long*>(word), long(mask)));
+#else
+	if (__atomic_load_n(word, __ATOMIC_RELAXED) & mask)return false;
+	uint32_t old = __atomic_fetch_or(word, mask, __ATOMIC_RELAXED);
+#endif
+	return (old & mask) == 0;
+}
+
+void ds::Bitstring::clear()
+{
+	if (m_rankDirectory)releaseDirectory();
+	for (uint32_t i = 0; i < m_size; i++)m_content[i] = 0;
 }
 
 uint32_t ds::Bitstring::numberOfElements() const
 {
 	return m_numElements;
 }
+
+uint64_t ds::Bitstring::word64(uint32_t j) const
+{
+	return uint64_t(m_content[2 * j]) | (uint64_t(m_content[2 * j + 1]) << 32);
+}
+
+void ds::Bitstring::releaseContent()
+{
+	if (m_content && !m_mapping)_aligned_free(m_content);
+	m_content = nullptr;
+	m_mapping.reset();
+}
+
+void ds::Bitstring::releaseDirectory()
+{
+	if (m_rankDirectory)_aligned_free(m_rankDirectory);
+	if (m_selectSamples)_aligned_free(m_selectSamples);
+	if (m_selectZeroSamples)_aligned_free(m_selectZeroSamples);
+	m_rankDirectory = nullptr;
+	m_selectSamples = nullptr;
+	m_selectZeroSamples = nullptr;
+}
+
+uint32_t ds::Bitstring::zerosInFrontOf(uint32_t block) const
+{
+	return block * RANK_BLOCK_BITS - uint32_t(m_rankDirectory[block]);
+}
+
+void ds::Bitstring::freeze()
+{
+	releaseDirectory();
+
+	const uint32_t wordsPerBlock = RANK_BLOCK_BITS / 64;
+	const uint32_t wordsPerSubBlock = RANK_SUBBLOCK_BITS / 64;
+	uint32_t numberOfWords = m_size / 2;
+	m_numberOfBlocks = (numberOfWords + wordsPerBlock - 1) / wordsPerBlock;
+
+	//one extra entry holds the total, so rank1 needs no special case at the end
+	m_rankDirectory = (uint64_t*)_aligned_malloc((m_numberOfBlocks + 1) * sizeof(uint64_t), 64);
+	uint32_t ones = 0;
+	for (uint32_t b = 0; b < m_numberOfBlocks; b++)
+	{
+		uint64_t entry = ones;
+		for (uint32_t s = 0; s < RANK_BLOCK_BITS / RANK_SUBBLOCK_BITS; s++)
+		{
+			uint32_t count = 0;
+			for (uint32_t w = 0; w < wordsPerSubBlock; w++)
+			{
+				uint32_t j = b * wordsPerBlock + s * wordsPerSubBlock + w;
+				if (j < numberOfWords)count += popcount64(word64(j));
+			}
+			if (s < 3)entry |= uint64_t(count) << (32 + 10 * s);
+			ones += count;
+		}
+		m_rankDirectory[b] = entry;
+	}
+	m_rankDirectory[m_numberOfBlocks] = ones;
+	m_numberOfOnes = ones;
+
+	//sample s holds the block of the (s * SELECT_SAMPLE_RATE)-th one
+	m_numberOfSamples = (ones + SELECT_SAMPLE_RATE - 1) / SELECT_SAMPLE_RATE;
+	m_selectSamples = (uint32_t*)_aligned_malloc((m_numberOfSamples + 1) * sizeof(uint32_t), 64);
+	uint32_t sample = 0;
+	for (uint32_t b = 0; b < m_numberOfBlocks; b++)
+	{
+		uint32_t next = uint32_t(m_rankDirectory[b + 1]);
+		while (sample < m_numberOfSamples && uint64_t(sample) * SELECT_SAMPLE_RATE < next)
+		{
+			m_selectSamples[sample++] = b;
+		}
+	}
+	m_selectSamples[m_numberOfSamples] = m_numberOfBlocks;
+
+	uint32_t zeros = m_numElements - ones;
+	m_numberOfZeroSamples = (zeros + SELECT_SAMPLE_RATE - 1) / SELECT_SAMPLE_RATE;
+	m_selectZeroSamples = (uint32_t*)_aligned_malloc((m_numberOfZeroSamples + 1) * sizeof(uint32_t), 64);
+	sample = 0;
+	for (uint32_t b = 0; b < m_numberOfBlocks; b++)
+	{
+		uint32_t next = zerosInFrontOf(b + 1);
+		while (sample < m_numberOfZeroSamples && uint64_t(sample) * SELECT_SAMPLE_RATE < next)
+		{
+			m_selectZeroSamples[sample++] = b;
+		}
+	}
+	m_selectZeroSamples[m_numberOfZeroSamples] = m_numberOfBlocks;
+}
+
+bool ds::Bitstring::isFrozen() const
+{
+	return m_rankDirectory != nullptr;
+}
+
+uint32_t ds::Bitstring::rank1(uint32_t i) const
+{
+	uint64_t entry = m_rankDirectory[i / RANK_BLOCK_BITS];
+	uint32_t result = uint32_t(entry);
+	uint32_t subBlock = (i / RANK_SUBBLOCK_BITS) & (RANK_BLOCK_BITS / RANK_SUBBLOCK_BITS - 1);
+	for (uint32_t s = 0; s < subBlock; s++)result += uint32_t(entry >> (32 + 10 * s)) & uint32_t(1023);
+
+	uint32_t word = i / 64;
+	for (uint32_t j = (i / RANK_SUBBLOCK_BITS) * (RANK_SUBBLOCK_BITS / 64); j < word; j++)result += popcount64(word64(j));
+	uint32_t bit = i & mod64mask;
+	if (bit)result += popcount64(word64(word) & ((s_one64 << bit) - 1));
+	return result;
+}
+
+uint32_t ds::Bitstring::select1(uint32_t k) const
+{
+	if (k >= m_numberOfOnes)return m_numElements;
+
+	//last block between the two samples with at most k ones in front of it
+	uint32_t sample = k / SELECT_SAMPLE_RATE;
+	uint32_t lo = m_selectSamples[sample];
+	uint32_t hi = m_selectSamples[sample + 1] + 1;
+	if (hi > m_numberOfBlocks)hi = m_numberOfBlocks;
+	while (hi - lo > 1)
+	{
+		uint32_t mid = lo + (hi - lo) / 2;
+		if (uint32_t(m_rankDirectory[mid]) <= k)lo = mid;
+		else hi = mid;
+	}
+
+	uint64_t entry = m_rankDirectory[lo];
+	uint32_t rest = k - uint32_t(entry);
+	uint32_t subBlock = 0;
+	while (subBlock < 3)
+	{
+		uint32_t count = uint32_t(entry >> (32 + 10 * subBlock)) & uint32_t(1023);
+		if (rest < count)break;
+		rest -= count;
+		subBlock++;
+	}
+
+	uint32_t j = lo * (RANK_BLOCK_BITS / 64) + subBlock * (RANK_SUBBLOCK_BITS / 64);
+	uint64_t word = word64(j);
+	uint32_t count = popcount64(word);
+	while (rest >= count)
+	{
+		rest -= count;
+		word = word64(++j);
+		count = popcount64(word);
+	}
+	return j * 64 + select64(word, rest);
+}
+
+uint32_t ds::Bitstring::select0(uint32_t k) const
+{
+	if (k >= m_numElements - m_numberOfOnes)return m_numElements;
+
+	uint32_t sample = k / SELECT_SAMPLE_RATE;
+	uint32_t lo = m_selectZeroSamples[sample];
+	uint32_t hi = m_selectZeroSamples[sample + 1] + 1;
+	if (hi > m_numberOfBlocks)hi = m_numberOfBlocks;
+	while (hi - lo > 1)
+	{
+		uint32_t mid = lo + (hi - lo) / 2;
+		if (zerosInFrontOf(mid) <= k)lo = mid;
+		else hi = mid;
+	}
+
+	uint64_t entry = m_rankDirectory[lo];
+	uint32_t rest = k - zerosInFrontOf(lo);
+	uint32_t subBlock = 0;
+	while (subBlock < 3)
+	{
+		uint32_t count = RANK_SUBBLOCK_BITS - (uint32_t(entry >> (32 + 10 * subBlock)) & uint32_t(1023));
+		if (rest < count)break;
+		rest -= count;
+		subBlock++;
+	}
+
+	uint32_t j = lo * (RANK_BLOCK_BITS / 64) + subBlock * (RANK_SUBBLOCK_BITS / 64);
+	uint64_t word = ~word64(j);
+	uint32_t count = popcount64(word);
+	while (rest >= count)
+	{
+		rest -= count;
+		word = ~word64(++j);
+		count = popcount64(word);
+	}
+	return j * 64 + select64(word, rest);
+}
+
+uint32_t ds::Bitstring::numberOfOnes() const
+{
+	return m_numberOfOnes;
+}
+
+bool ds::Bitstring::save(const std::string& path) const
+{
+	if (!m_content)return false;
+	return writePackedFile(path, PackedFileType::Bitstring, sizeof(uint32_t), 1, m_numElements, m_content, uint64_t(m_size) * sizeof(uint32_t));
+}
+
+bool ds::Bitstring::mapFile(const std::string& path, bool verify)
+{
+	PackedFileHeader header;
+	std::shared_ptr<MappedFile> mapping = mapPackedFile(path, PackedFileType::Bitstring, sizeof(uint32_t), header, verify);
+	if (!mapping)return false;
+	//the directory reads whole sub-blocks, so the payload has to cover them
+	uint64_t words = (header.numberOfElements / RANK_SUBBLOCK_BITS + 1) * (RANK_SUBBLOCK_BITS / 32);
+	if (header.tau != 1 || header.payloadBytes < words * sizeof(uint32_t))return false;
+	releaseContent();
+	releaseDirectory();
+	m_numElements = uint32_t(header.numberOfElements);
+	m_size = uint32_t(words);
+	m_content = reinterpret_cast<uint32_t*>(mapping->data() + PACKED_FILE_ALIGNMENT);
+	m_mapping = mapping;
+	return true;
+}
+
+bool ds::Bitstring::isMapped() const
+{
+	return m_mapping != nullptr;
+}
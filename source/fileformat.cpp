@@ -0,0 +1,152 @@
+#if _WIN32 || _WIN64
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+#include <cstring>
+#include <fstream>
+#include "fileformat.h"
+
+static const char s_packedFileMagic[8] = { 'D', 'S', 'P', 'A', 'C', 'K', '\0', '\0' };
+
+namespace ds
+{
+	MappedFile::MappedFile()
+	{
+		m_data = nullptr;
+		m_size = 0;
+#if _WIN32 || _WIN64
+		m_file = nullptr;
+		m_mapping = nullptr;
+#endif
+	}
+
+	MappedFile::~MappedFile()
+	{
+#if _WIN32 || _WIN64
+		if (m_data)UnmapViewOfFile(m_data);
+		if (m_mapping)CloseHandle(m_mapping);
+		if (m_file)CloseHandle(m_file);
+#else
+		if (m_data)munmap(m_data, m_size);
+#endif
+	}
+
+	bool MappedFile::open(const std::string& path)
+	{
+#if _WIN32 || _WIN64
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)return false;
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+		{
+			CloseHandle(file);
+			return false;
+		}
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+		if (!mapping)
+		{
+			CloseHandle(file);
+			return false;
+		}
+		void* data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+		if (!data)
+		{
+			CloseHandle(mapping);
+			CloseHandle(file);
+			return false;
+		}
+		m_file = file;
+		m_mapping = mapping;
+		m_data = static_cast<uint8_t*>(data);
+		m_size = uint64_t(size.QuadPart);
+		return true;
+#else
+		int file = ::open(path.c_str(), O_RDONLY);
+		if (file < 0)return false;
+		struct stat info;
+		if (fstat(file, &info) != 0 || info.st_size == 0)
+		{
+			::close(file);
+			return false;
+		}
+		//MAP_PRIVATE: writes go to private copies of the pages, the file and the other processes do not see them
+		void* data = mmap(nullptr, size_t(info.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+		::close(file);
+		if (data == MAP_FAILED)return false;
+		m_data = static_cast<uint8_t*>(data);
+		m_size = uint64_t(info.st_size);
+		return true;
+#endif
+	}
+
+	uint8_t* MappedFile::data() const
+	{
+		return m_data;
+	}
+
+	uint64_t MappedFile::size() const
+	{
+		return m_size;
+	}
+
+	uint64_t packedFileChecksum(const void* data, uint64_t bytes)
+	{
+		const uint8_t* content = static_cast<const uint8_t*>(data);
+		uint64_t hash = uint64_t(14695981039346656037ULL);
+		uint64_t i = 0;
+		for (; i + 8 <= bytes; i += 8)
+		{
+			uint64_t word;
+			memcpy(&word, content + i, 8);
+			hash = (hash ^ word) * uint64_t(0x9e3779b97f4a7c15ULL);
+			hash ^= hash >> 29;
+		}
+		for (; i < bytes; i++)hash = (hash ^ content[i]) * uint64_t(1099511628211ULL);
+		return hash;
+	}
+
+	bool writePackedFile(const std::string& path, PackedFileType type, uint32_t wordBytes, uint64_t tau, uint64_t numberOfElements, const void* payload, uint64_t payloadBytes)
+	{
+		static_assert(sizeof(PackedFileHeader) == PACKED_FILE_ALIGNMENT, "the header has to fill exactly one alignment unit");
+
+		PackedFileHeader header;
+		memset(&header, 0, sizeof(header));
+		memcpy(header.magic, s_packedFileMagic, sizeof(header.magic));
+		header.version = PACKED_FILE_VERSION;
+		header.type = uint32_t(type);
+		header.wordBytes = wordBytes;
+		header.tau = tau;
+		header.numberOfElements = numberOfElements;
+		header.payloadBytes = payloadBytes;
+		header.checksum = packedFileChecksum(payload, payloadBytes);
+
+		std::ofstream file(path.c_str(), std::ios::binary | std::ios::trunc);
+		if (!file)return false;
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(static_cast<const char*>(payload), std::streamsize(payloadBytes));
+		static const char s_zeros[PACKED_FILE_ALIGNMENT] = { 0 };
+		uint64_t padding = (PACKED_FILE_ALIGNMENT - payloadBytes % PACKED_FILE_ALIGNMENT) % PACKED_FILE_ALIGNMENT;
+		file.write(s_zeros, std::streamsize(padding));
+		file.close();
+		return !file.fail();
+	}
+
+	std::shared_ptr<MappedFile> mapPackedFile(const std::string& path, PackedFileType type, uint32_t wordBytes, PackedFileHeader& header, bool verify)
+	{
+		std::shared_ptr<MappedFile> mapping = std::make_shared<MappedFile>();
+		if (!mapping->open(path) || mapping->size() < sizeof(PackedFileHeader))return nullptr;
+
+		memcpy(&header, mapping->data(), sizeof(header));
+		if (memcmp(header.magic, s_packedFileMagic, sizeof(header.magic)) != 0)return nullptr;
+		if (header.version != PACKED_FILE_VERSION || header.type != uint32_t(type) || header.wordBytes != wordBytes)return nullptr;
+		if (header.payloadBytes > mapping->size() - sizeof(PackedFileHeader))return nullptr;
+		if (verify && packedFileChecksum(mapping->data() + PACKED_FILE_ALIGNMENT, header.payloadBytes) != header.checksum)return nullptr;
+		return mapping;
+	}
+};
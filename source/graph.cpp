@@ -1,8 +1,9 @@
 #include "graph.h"
+#include <algorithm>
 
 namespace ds
 {
-	Graphe::Graphe(uint32_t size) : m_edges(size)
+	Graphe::Graphe(uint32_t size) : m_edges(Integer(size) * size, 1)
 	{
 		m_size = size;
 	}
@@ -44,14 +45,15 @@ namespace ds
 
 	bool Graphe::hasEdge(uint32_t i, uint32_t j) const
 	{
-		return m_edges.isBitSet(i + j * m_size);
+		if (i >= m_size || j >= m_size)return false;
+		return m_edges.get(i + Integer(j) * m_size) != 0;
 	}
 
 	bool Graphe::setEdge(uint32_t i, uint32_t j)
 	{
 		if (i < m_size && j < m_size)
 		{
-			m_edges.setBit(i + j * m_size);
+			m_edges.set(i + Integer(j) * m_size, 1);
 			return true;
 		}
 		return false;
@@ -61,7 +63,7 @@ namespace ds
 	{
 		if (i < m_size && j < m_size)
 		{
-			m_edges.resetBit(i + j * m_size);
+			m_edges.set(i + Integer(j) * m_size, 0);
 		}
 	}
 
@@ -219,4 +221,216 @@ namespace ds
 		return m_graph.weight(i, j) * (m_signs.isBitSet(i + j * m_graph.size()) ? -1 : 1);
 	}
 
+
+
+	/*!
+		\brief Die kleinste Bitanzahl (mindestens 1), mit der value dargestellt werden kann.
+	*/
+	static uint8_t bitsFor(Integer value)
+	{
+		uint8_t bits = 1;
+		while (bits < IntegerBitSize && (value >> bits) != 0)bits++;
+		return bits;
+	}
+
+	CompressedGraph::CompressedGraph(uint32_t size, std::vector<Edge> edges, uint8_t tau, bool isSigned)
+	{
+		m_size = size;
+		m_tau = tau > 32 ? 32 : tau;
+		m_isSigned = isSigned;
+
+		//Kanten stabil nach dem Startknoten verteilen (counting sort), dann jede Zeile stabil nach dem Zielknoten sortieren,
+		//bei Duplikaten gewinnt die letzte
+		std::vector<Integer> rows(Integer(size) + 1, 0);
+		for (const Edge& e : edges)
+		{
+			if (e.m_from < size && e.m_to < size)rows[e.m_from + 1]++;
+		}
+		for (uint32_t i = 0; i < size; i++)rows[i + 1] += rows[i];
+		std::vector<Edge> sorted(rows[size]);
+		{
+			std::vector<Integer> next(rows.begin(), rows.end() - 1);
+			for (const Edge& e : edges)
+			{
+				if (e.m_from < size && e.m_to < size)sorted[next[e.m_from]++] = e;
+			}
+		}
+		std::vector<Edge>().swap(edges);
+		Integer count = 0;
+		for (uint32_t i = 0; i < size; i++)
+		{
+			if (rows[i + 1] - rows[i] > 32)
+			{
+				std::stable_sort(sorted.begin() + rows[i], sorted.begin() + rows[i + 1], [](const Edge& a, const Edge& b) { return a.m_to < b.m_to; });
+			}
+			else
+			{
+				//kurze Zeilen: Insertion Sort, stabil und ohne Puffer
+				for (Integer e = rows[i] + 1; e < rows[i + 1]; e++)
+				{
+					Edge edge = sorted[e];
+					Integer k = e;
+					while (k > rows[i] && sorted[k - 1].m_to > edge.m_to)
+					{
+						sorted[k] = sorted[k - 1];
+						k--;
+					}
+					sorted[k] = edge;
+				}
+			}
+			Integer rowStart = count;
+			for (Integer e = rows[i]; e < rows[i + 1]; e++)
+			{
+				if (count > rowStart && sorted[count - 1].m_to == sorted[e].m_to)count--;
+				sorted[count++] = sorted[e];
+			}
+		}
+		sorted.resize(count);
+		edges.swap(sorted);
+
+		m_offsets = Array(Integer(size) + 1, bitsFor(count));
+		m_targets = Array(count, bitsFor(size > 0 ? size - 1 : 0));
+		if (m_tau > 0)m_weights = Array(count, m_tau);
+
+		//in Blöcken von 256 packen
+		uint64_t buffer[256];
+		Integer edge = 0;
+		for (uint32_t i = 0; i <= size; i += 256)
+		{
+			Integer chunk = Integer(size) + 1 - i < 256 ? Integer(size) + 1 - i : 256;
+			for (Integer k = 0; k < chunk; k++)
+			{
+				while (edge < count && edges[edge].m_from < i + k)edge++;
+				buffer[k] = edge;
+			}
+			m_offsets.setRange(i, chunk, buffer);
+		}
+		Integer mask = m_tau == 32 ? ~uint32_t(0) : (Integer(1) << m_tau) - 1;
+		for (Integer e = 0; e < count; e += 256)
+		{
+			Integer chunk = count - e < 256 ? count - e : 256;
+			for (Integer k = 0; k < chunk; k++)buffer[k] = edges[e + k].m_to;
+			m_targets.setRange(e, chunk, buffer);
+			if (m_tau > 0)
+			{
+				for (Integer k = 0; k < chunk; k++)buffer[k] = Integer(uint32_t(edges[e + k].m_weight)) & mask;
+				m_weights.setRange(e, chunk, buffer);
+			}
+		}
+	}
+
+	CompressedGraph::~CompressedGraph()
+	{
+
+	}
+
+	Integer CompressedGraph::findEdge(uint32_t i, uint32_t j) const
+	{
+		if (i >= m_size)return numberOfEdges();
+		uint64_t bounds[2];
+		m_offsets.getRange(i, 2, bounds);
+		Integer lo = bounds[0];
+		Integer hi = bounds[1];
+		uint64_t buffer[256];
+		//lange Listen binaer auf einzelnen Zielknoten eingrenzen, die letzten 256 Kanten am Stueck entpacken und durchsuchen
+		while (hi - lo > 256)
+		{
+			Integer middle = lo + (hi - lo) / 2;
+			m_targets.getRange(middle, 1, buffer);
+			if (buffer[0] < j)lo = middle + 1;
+			else hi = middle + 1;
+		}
+		m_targets.getRange(lo, hi - lo, buffer);
+		Integer k = Integer(std::lower_bound(buffer, buffer + (hi - lo), uint64_t(j)) - buffer);
+		return k < hi - lo && buffer[k] == j ? lo + k : numberOfEdges();
+	}
+
+	bool CompressedGraph::hasEdge(uint32_t i, uint32_t j) const
+	{
+		return findEdge(i, j) < numberOfEdges();
+	}
+
+	int32_t CompressedGraph::weight(uint32_t i, uint32_t j) const
+	{
+		Integer e = findEdge(i, j);
+		return e < numberOfEdges() ? edgeWeight(e) : 0;
+	}
+
+	bool CompressedGraph::setWeight(uint32_t i, uint32_t j, int32_t value)
+	{
+		Integer e = findEdge(i, j);
+		if (m_tau == 0 || e >= numberOfEdges())return false;
+		Integer mask = m_tau == 32 ? ~uint32_t(0) : (Integer(1) << m_tau) - 1;
+		m_weights.set(e, Integer(uint32_t(value)) & mask);
+		return true;
+	}
+
+	uint32_t CompressedGraph::numberOfNodes() const
+	{
+		return m_size;
+	}
+
+	Integer CompressedGraph::numberOfEdges() const
+	{
+		return m_targets.length();
+	}
+
+	uint32_t CompressedGraph::degree(uint32_t i) const
+	{
+		uint64_t bounds[2];
+		m_offsets.getRange(i, 2, bounds);
+		return uint32_t(bounds[1] - bounds[0]);
+	}
+
+	Integer CompressedGraph::firstEdge(uint32_t i) const
+	{
+		uint64_t first = 0;
+		m_offsets.getRange(i, 1, &first);
+		return Integer(first);
+	}
+
+	uint32_t CompressedGraph::target(Integer e) const
+	{
+		return uint32_t(m_targets[e]);
+	}
+
+	int32_t CompressedGraph::edgeWeight(Integer e) const
+	{
+		if (m_tau == 0)return 0;
+		uint32_t value = uint32_t(m_weights[e]);
+		//Vorzeichen aus Bit tau - 1 erweitern
+		if (m_isSigned && m_tau < 32)return int32_t(value << (32 - m_tau)) >> (32 - m_tau);
+		return int32_t(value);
+	}
+
+	void CompressedGraph::targets(Integer first, Integer n, uint64_t* out) const
+	{
+		m_targets.getRange(first, n, out);
+	}
+
+	void CompressedGraph::weights(Integer first, Integer n, int64_t* out) const
+	{
+		if (m_tau == 0)
+		{
+			for (Integer k = 0; k < n; k++)out[k] = 0;
+			return;
+		}
+		m_weights.getRange(first, n, reinterpret_cast<uint64_t*>(out));
+		if (m_isSigned)
+		{
+			for (Integer k = 0; k < n; k++)out[k] = int64_t(uint64_t(out[k]) << (64 - m_tau)) >> (64 - m_tau);
+		}
+	}
+
+	uint8_t CompressedGraph::tau() const
+	{
+		return m_tau;
+	}
+
+	Integer CompressedGraph::byteSize() const
+	{
+		Integer bits = m_offsets.length() * m_offsets.tau() + m_targets.length() * m_targets.tau() + m_weights.length() * m_weights.tau();
+		return sizeof(*this) + (bits + 7) / 8;
+	}
+
 };
\ No newline at end of file
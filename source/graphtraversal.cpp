@@ -0,0 +1,381 @@
+#include "graphtraversal.h"
+#include <algorithm>
+#include <map>
+
+namespace ds
+{
+	/*
+		Die Kanten werden in Blöcken von GRAPH_EDGE_BUFFER über targets/weights entpackt.
+	*/
+	#define GRAPH_EDGE_BUFFER 256
+
+	GraphTraversal::GraphTraversal(const CompressedGraph& graph, ThreadPool& pool, bool symmetric) : m_graph(graph), m_incoming(&graph), m_pool(pool)
+	{
+		if (symmetric)return;
+		//umgedrehte Kanten ohne Gewichte
+		std::vector<CompressedGraph::Edge> edges(m_graph.numberOfEdges());
+		uint64_t buffer[GRAPH_EDGE_BUFFER];
+		for (uint32_t i = 0; i < m_graph.numberOfNodes(); i++)
+		{
+			Integer last = m_graph.firstEdge(i + 1);
+			for (Integer e = m_graph.firstEdge(i); e < last; e += GRAPH_EDGE_BUFFER)
+			{
+				Integer chunk = last - e < GRAPH_EDGE_BUFFER ? last - e : GRAPH_EDGE_BUFFER;
+				m_graph.targets(e, chunk, buffer);
+				for (Integer k = 0; k < chunk; k++)edges[e + k] = { uint32_t(buffer[k]), i, 0 };
+			}
+		}
+		m_reverse.reset(new CompressedGraph(m_graph.numberOfNodes(), std::move(edges)));
+		m_incoming = m_reverse.get();
+	}
+
+	GraphTraversal::~GraphTraversal()
+	{
+
+	}
+
+	/*
+		Jede Aufgabe expandiert GRAPH_TRAVERSAL_CHUNK Knoten der Front in eine eigene Liste, den Knoten bekommt die Aufgabe,
+		deren testAndSetBit ihn setzt. Die Listen werden danach zur neuen Front verkettet.
+	*/
+	Integer GraphTraversal::topDownStep(const std::vector<uint32_t>& frontier, std::vector<uint32_t>& next, Bitstring& visited, std::vector<uint32_t>& levels, uint32_t level, Integer& frontierEdges) const
+	{
+		Integer chunks = (frontier.size() + GRAPH_TRAVERSAL_CHUNK - 1) / GRAPH_TRAVERSAL_CHUNK;
+		std::vector<std::vector<uint32_t>> found(chunks);
+		std::vector<Integer> edges(chunks, 0);
+		m_pool.parallelFor(chunks, [&](Integer c)
+		{
+			uint64_t buffer[GRAPH_EDGE_BUFFER];
+			Integer end = (c + 1) * GRAPH_TRAVERSAL_CHUNK < frontier.size() ? (c + 1) * GRAPH_TRAVERSAL_CHUNK : frontier.size();
+			for (Integer k = c * GRAPH_TRAVERSAL_CHUNK; k < end; k++)
+			{
+				uint32_t u = frontier[k];
+				Integer last = m_graph.firstEdge(u + 1);
+				for (Integer e = m_graph.firstEdge(u); e < last; e += GRAPH_EDGE_BUFFER)
+				{
+					Integer chunk = last - e < GRAPH_EDGE_BUFFER ? last - e : GRAPH_EDGE_BUFFER;
+					m_graph.targets(e, chunk, buffer);
+					for (Integer t = 0; t < chunk; t++)
+					{
+						uint32_t v = uint32_t(buffer[t]);
+						if (visited.testAndSetBit(v))
+						{
+							levels[v] = level;
+							found[c].push_back(v);
+							edges[c] += m_graph.degree(v);
+						}
+					}
+				}
+			}
+		});
+		next.clear();
+		frontierEdges = 0;
+		for (Integer c = 0; c < chunks; c++)
+		{
+			next.insert(next.end(), found[c].begin(), found[c].end());
+			frontierEdges += edges[c];
+		}
+		return next.size();
+	}
+
+	/*
+		Jede Aufgabe prüft GRAPH_TRAVERSAL_CHUNK unbesuchte Knoten, dadurch schreibt sie nur eigene Worte von visited und
+		next und braucht keine atomaren Operationen.
+	*/
+	Integer GraphTraversal::bottomUpStep(const Bitstring& frontier, Bitstring& next, Bitstring& visited, std::vector<uint32_t>& levels, uint32_t level, Integer& frontierEdges) const
+	{
+		uint32_t size = m_graph.numberOfNodes();
+		Integer chunks = (Integer(size) + GRAPH_TRAVERSAL_CHUNK - 1) / GRAPH_TRAVERSAL_CHUNK;
+		std::vector<Integer> counts(chunks, 0);
+		std::vector<Integer> edges(chunks, 0);
+		m_pool.parallelFor(chunks, [&](Integer c)
+		{
+			uint64_t buffer[32];
+			uint32_t first = uint32_t(c * GRAPH_TRAVERSAL_CHUNK);
+			uint32_t end = size - first < GRAPH_TRAVERSAL_CHUNK ? size : first + GRAPH_TRAVERSAL_CHUNK;
+			for (uint32_t v = first; v < end; v++)
+			{
+				if (visited.isBitSet(v))continue;
+				Integer last = m_incoming->firstEdge(v + 1);
+				bool found = false;
+				//kleine Blöcke, meistens trifft eine der ersten Kanten
+				for (Integer e = m_incoming->firstEdge(v); e < last && !found; e += 32)
+				{
+					Integer chunk = last - e < 32 ? last - e : 32;
+					m_incoming->targets(e, chunk, buffer);
+					for (Integer t = 0; t < chunk; t++)
+					{
+						if (frontier.isBitSet(uint32_t(buffer[t])))
+						{
+							found = true;
+							break;
+						}
+					}
+				}
+				if (found)
+				{
+					visited.setBit(v);
+					next.setBit(v);
+					levels[v] = level;
+					counts[c]++;
+					edges[c] += m_graph.degree(v);
+				}
+			}
+		});
+		Integer count = 0;
+		frontierEdges = 0;
+		for (Integer c = 0; c < chunks; c++)
+		{
+			count += counts[c];
+			frontierEdges += edges[c];
+		}
+		return count;
+	}
+
+	std::vector<uint32_t> GraphTraversal::bfs(uint32_t source) const
+	{
+		uint32_t size = m_graph.numberOfNodes();
+		std::vector<uint32_t> levels(size, GRAPH_UNREACHED);
+		if (source >= size)return levels;
+
+		Bitstring visited(size);
+		Bitstring frontierBits(size);
+		Bitstring nextBits(size);
+		std::vector<uint32_t> frontier(1, source);
+		std::vector<uint32_t> next;
+		visited.setBit(source);
+		levels[source] = 0;
+		Integer frontierSize = 1;
+		Integer frontierEdges = m_graph.degree(source);
+		Integer unexploredEdges = m_graph.numberOfEdges() - frontierEdges;
+		bool bottomUp = false;
+		for (uint32_t level = 1; frontierSize > 0; level++)
+		{
+			if (!bottomUp && frontierEdges * GRAPH_BFS_ALPHA > unexploredEdges)
+			{
+				//Liste -> Bitstring
+				bottomUp = true;
+				frontierBits.clear();
+				for (uint32_t v : frontier)frontierBits.setBit(v);
+			}
+			else if (bottomUp && frontierSize * GRAPH_BFS_BETA < size)
+			{
+				//Bitstring -> Liste
+				bottomUp = false;
+				frontier.clear();
+				for (uint32_t j = 0; j < (size + 63) / 64; j++)
+				{
+					uint64_t word = frontierBits.word64(j);
+					while (word != 0)
+					{
+						frontier.push_back(j * 64 + trailingZeros64(word));
+						word &= word - 1;
+					}
+				}
+			}
+
+			if (bottomUp)
+			{
+				nextBits.clear();
+				frontierSize = bottomUpStep(frontierBits, nextBits, visited, levels, level, frontierEdges);
+				std::swap(frontierBits, nextBits);
+			}
+			else
+			{
+				frontierSize = topDownStep(frontier, next, visited, levels, level, frontierEdges);
+				frontier.swap(next);
+			}
+			unexploredEdges = unexploredEdges > frontierEdges ? unexploredEdges - frontierEdges : 0;
+		}
+		return levels;
+	}
+
+	/*
+		Setzt distances[v] atomar auf das Minimum mit distance, true wenn distance kleiner war.
+	*/
+	static bool relax(std::atomic<uint64_t>& distance, uint64_t value)
+	{
+		uint64_t current = distance.load(std::memory_order_relaxed);
+		while (value < current)
+		{
+			if (distance.compare_exchange_weak(current, value, std::memory_order_relaxed))return true;
+		}
+		return false;
+	}
+
+	/*
+		Relaxiert parallel die leichten (weight <= delta) oder die schweren Kanten von nodes. Jede Aufgabe sammelt die
+		verbesserten Knoten in einer eigenen Liste, die am Ende in improved verkettet werden.
+	*/
+	void GraphTraversal::relaxEdges(const std::vector<uint32_t>& nodes, bool light, uint64_t delta, std::vector<std::atomic<uint64_t>>& distances, std::vector<uint32_t>& improved) const
+	{
+		Integer chunks = (nodes.size() + GRAPH_TRAVERSAL_CHUNK - 1) / GRAPH_TRAVERSAL_CHUNK;
+		std::vector<std::vector<uint32_t>> found(chunks);
+		bool weighted = m_graph.tau() > 0;
+		m_pool.parallelFor(chunks, [&](Integer c)
+		{
+			uint64_t targets[GRAPH_EDGE_BUFFER];
+			int64_t weights[GRAPH_EDGE_BUFFER];
+			Integer end = (c + 1) * GRAPH_TRAVERSAL_CHUNK < nodes.size() ? (c + 1) * GRAPH_TRAVERSAL_CHUNK : nodes.size();
+			for (Integer k = c * GRAPH_TRAVERSAL_CHUNK; k < end; k++)
+			{
+				uint32_t u = nodes[k];
+				uint64_t distance = distances[u].load(std::memory_order_relaxed);
+				Integer last = m_graph.firstEdge(u + 1);
+				for (Integer e = m_graph.firstEdge(u); e < last; e += GRAPH_EDGE_BUFFER)
+				{
+					Integer chunk = last - e < GRAPH_EDGE_BUFFER ? last - e : GRAPH_EDGE_BUFFER;
+					m_graph.targets(e, chunk, targets);
+					if (weighted)m_graph.weights(e, chunk, weights);
+					for (Integer t = 0; t < chunk; t++)
+					{
+						uint64_t weight = weighted ? uint64_t(weights[t]) : 1;
+						if ((weight <= delta) != light)continue;
+						uint32_t v = uint32_t(targets[t]);
+						if (relax(distances[v], distance + weight))found[c].push_back(v);
+					}
+				}
+			}
+		});
+		improved.clear();
+		for (Integer c = 0; c < chunks; c++)improved.insert(improved.end(), found[c].begin(), found[c].end());
+	}
+
+	std::vector<uint64_t> GraphTraversal::shortestPaths(uint32_t source, uint64_t delta) const
+	{
+		uint32_t size = m_graph.numberOfNodes();
+		std::vector<uint64_t> result(size, GRAPH_INFINITY);
+		if (source >= size)return result;
+
+		if (delta == 0)
+		{
+			//größtes Gewicht / mittlerer Grad
+			uint64_t maxWeight = 1;
+			if (m_graph.tau() > 0)
+			{
+				int64_t weights[GRAPH_EDGE_BUFFER];
+				for (Integer e = 0; e < m_graph.numberOfEdges(); e += GRAPH_EDGE_BUFFER)
+				{
+					Integer chunk = m_graph.numberOfEdges() - e < GRAPH_EDGE_BUFFER ? m_graph.numberOfEdges() - e : GRAPH_EDGE_BUFFER;
+					m_graph.weights(e, chunk, weights);
+					for (Integer k = 0; k < chunk; k++)
+					{
+						if (uint64_t(weights[k]) > maxWeight)maxWeight = uint64_t(weights[k]);
+					}
+				}
+			}
+			delta = m_graph.numberOfEdges() > 0 ? maxWeight * size / m_graph.numberOfEdges() : maxWeight;
+			if (delta == 0)delta = 1;
+		}
+
+		std::vector<std::atomic<uint64_t>> distances(size);
+		for (uint32_t v = 0; v < size; v++)distances[v].store(GRAPH_INFINITY, std::memory_order_relaxed);
+		distances[source].store(0, std::memory_order_relaxed);
+
+		//nur belegte Eimer, ein Knoten kann mehrfach und in veralteten Eimern liegen
+		std::map<uint64_t, std::vector<uint32_t>> buckets;
+		buckets[0].push_back(source);
+		std::vector<uint32_t> current;
+		std::vector<uint32_t> settled;
+		std::vector<uint32_t> improved;
+		while (!buckets.empty())
+		{
+			uint64_t bucket = buckets.begin()->first;
+			settled.clear();
+			//leichte Kanten, bis der Eimer leer bleibt
+			while (buckets.begin() != buckets.end() && buckets.begin()->first == bucket)
+			{
+				current.swap(buckets.begin()->second);
+				buckets.erase(buckets.begin());
+				std::sort(current.begin(), current.end());
+				current.erase(std::unique(current.begin(), current.end()), current.end());
+				Integer count = 0;
+				for (uint32_t v : current)
+				{
+					if (distances[v].load(std::memory_order_relaxed) / delta == bucket)current[count++] = v;
+				}
+				current.resize(count);
+				settled.insert(settled.end(), current.begin(), current.end());
+				relaxEdges(current, true, delta, distances, improved);
+				for (uint32_t v : improved)buckets[distances[v].load(std::memory_order_relaxed) / delta].push_back(v);
+			}
+			//schwere Kanten einmal, sie führen nur in spätere Eimer
+			std::sort(settled.begin(), settled.end());
+			settled.erase(std::unique(settled.begin(), settled.end()), settled.end());
+			relaxEdges(settled, false, delta, distances, improved);
+			for (uint32_t v : improved)buckets[distances[v].load(std::memory_order_relaxed) / delta].push_back(v);
+		}
+
+		for (uint32_t v = 0; v < size; v++)result[v] = distances[v].load(std::memory_order_relaxed);
+		return result;
+	}
+
+	/*
+		Die Wurzel von x mit Pfadhalbierung: jeder besuchte Knoten wird auf seinen Großvater umgehängt.
+	*/
+	static uint32_t findRoot(std::vector<std::atomic<uint32_t>>& parents, uint32_t x)
+	{
+		while (true)
+		{
+			uint32_t parent = parents[x].load(std::memory_order_relaxed);
+			if (parent == x)return x;
+			uint32_t grandparent = parents[parent].load(std::memory_order_relaxed);
+			if (grandparent != parent)parents[x].compare_exchange_weak(parent, grandparent, std::memory_order_relaxed);
+			x = grandparent;
+		}
+	}
+
+	/*
+		Hängt die größere Wurzel unter die kleinere, die Wurzel einer Menge ist daher immer ihr kleinster Knoten.
+		Schlägt das compare-and-swap fehl, hat ein anderer Thread die Wurzel umgehängt und die Suche beginnt neu.
+	*/
+	static void unite(std::vector<std::atomic<uint32_t>>& parents, uint32_t a, uint32_t b)
+	{
+		while (true)
+		{
+			a = findRoot(parents, a);
+			b = findRoot(parents, b);
+			if (a == b)return;
+			if (a < b)std::swap(a, b);
+			uint32_t expected = a;
+			if (parents[a].compare_exchange_strong(expected, b, std::memory_order_relaxed))return;
+		}
+	}
+
+	std::vector<uint32_t> GraphTraversal::connectedComponents() const
+	{
+		uint32_t size = m_graph.numberOfNodes();
+		Integer chunks = (Integer(size) + GRAPH_TRAVERSAL_CHUNK - 1) / GRAPH_TRAVERSAL_CHUNK;
+		std::vector<std::atomic<uint32_t>> parents(size);
+		m_pool.parallelFor(chunks, [&](Integer c)
+		{
+			uint32_t first = uint32_t(c * GRAPH_TRAVERSAL_CHUNK);
+			uint32_t end = size - first < GRAPH_TRAVERSAL_CHUNK ? size : first + GRAPH_TRAVERSAL_CHUNK;
+			for (uint32_t v = first; v < end; v++)parents[v].store(v, std::memory_order_relaxed);
+		});
+		m_pool.parallelFor(chunks, [&](Integer c)
+		{
+			uint64_t buffer[GRAPH_EDGE_BUFFER];
+			uint32_t first = uint32_t(c * GRAPH_TRAVERSAL_CHUNK);
+			uint32_t end = size - first < GRAPH_TRAVERSAL_CHUNK ? size : first + GRAPH_TRAVERSAL_CHUNK;
+			for (uint32_t u = first; u < end; u++)
+			{
+				Integer last = m_graph.firstEdge(u + 1);
+				for (Integer e = m_graph.firstEdge(u); e < last; e += GRAPH_EDGE_BUFFER)
+				{
+					Integer chunk = last - e < GRAPH_EDGE_BUFFER ? last - e : GRAPH_EDGE_BUFFER;
+					m_graph.targets(e, chunk, buffer);
+					for (Integer t = 0; t < chunk; t++)unite(parents, u, uint32_t(buffer[t]));
+				}
+			}
+		});
+		std::vector<uint32_t> labels(size);
+		m_pool.parallelFor(chunks, [&](Integer c)
+		{
+			uint32_t first = uint32_t(c * GRAPH_TRAVERSAL_CHUNK);
+			uint32_t end = size - first < GRAPH_TRAVERSAL_CHUNK ? size : first + GRAPH_TRAVERSAL_CHUNK;
+			for (uint32_t v = first; v < end; v++)labels[v] = findRoot(parents, v);
+		});
+		return labels;
+	}
+};
@@ -0,0 +1,240 @@
+#include "simd.h"
+#include <atomic>
+#include <immintrin.h>
+#if _MSC_VER
+	#include <intrin.h>
+#else
+	#include <cpuid.h>
+#endif
+
+namespace ds
+{
+	typedef void(*SimdUnpackFunction)(const Integer*, Integer, Integer, Integer, uint64_t*);
+
+	static void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t* regs)
+	{
+#if _MSC_VER
+		int info[4];
+		__cpuidex(info, int(leaf), int(subleaf));
+		for (int i = 0; i < 4; i++)regs[i] = uint32_t(info[i]);
+#else
+		__cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+	}
+
+	static uint64_t xgetbv0()
+	{
+#if _MSC_VER
+		return _xgetbv(0);
+#else
+		uint32_t lo, hi;
+		__asm__ __volatile__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+		return (uint64_t(hi) << 32) | lo;
+#endif
+	}
+
+	static InstructionSet queryInstructionSet()
+	{
+		uint32_t regs[4];
+		cpuid(0, 0, regs);
+		uint32_t maxLeaf = regs[0];
+		if (maxLeaf < 1)return InstructionSet::Scalar;
+
+		cpuid(1, 0, regs);
+		bool sse42 = (regs[2] & (s_one32 << 20)) != 0;
+		bool osxsave = (regs[2] & (s_one32 << 27)) != 0;
+		bool avx = (regs[2] & (s_one32 << 28)) != 0;
+
+		//the operating system has to save the ymm (bits 1, 2) and zmm registers (bits 5, 6, 7)
+		uint64_t xcr0 = osxsave ? xgetbv0() : 0;
+		bool ymmState = (xcr0 & 0x6) == 0x6;
+		bool zmmState = (xcr0 & 0xe6) == 0xe6;
+
+		bool avx2 = false;
+		bool avx512 = false;
+		if (maxLeaf >= 7)
+		{
+			cpuid(7, 0, regs);
+			avx2 = (regs[1] & (s_one32 << 5)) != 0;
+			avx512 = (regs[1] & (s_one32 << 16)) != 0 && (regs[1] & (s_one32 << 30)) != 0;
+		}
+
+		if (avx && avx512 && zmmState)return InstructionSet::AVX512;
+		if (avx && avx2 && ymmState)return InstructionSet::AVX2;
+		if (sse42)return InstructionSet::SSE42;
+		return InstructionSet::Scalar;
+	}
+
+	static std::atomic<uint8_t> s_instructionSet(static_cast<uint8_t>(detectInstructionSet()));
+
+	/*
+		Number of bytes, which may be read behind src without leaving the words holding the elements [0, ... , last - 1].
+	*/
+	static Integer byteLimit(Integer tau, Integer last)
+	{
+		return ((last * tau + IntegerBitSize - 1) / IntegerBitSize) * sizeof(Integer);
+	}
+
+	/*
+		Fills the byte shuffle and the shift for lanes * 4 elements starting at a byte aligned bit. The elements are split into
+		segments of 4 elements, every segment is loaded at its own byte offset (segmentBytes * segment), so it fits into 16 bytes.
+		Lane k of segment q starts at bit r = (4q + k) * tau - 8 * q * segmentBytes of its segment.
+	*/
+	static void buildShuffle(Integer tau, Integer segments, uint8_t* shuffle, uint32_t* shift)
+	{
+		Integer segmentBytes = (4 * tau) / 8;
+		for (Integer q = 0; q < segments; q++)
+		{
+			for (Integer k = 0; k < 4; k++)
+			{
+				Integer r = (4 * q + k) * tau - 8 * q * segmentBytes;
+				for (Integer b = 0; b < 4; b++)shuffle[16 * q + 4 * k + b] = uint8_t(r / 8 + b);
+				shift[4 * q + k] = uint32_t(r & 7);
+			}
+		}
+	}
+
+	static void unpackScalar(const Integer* src, Integer tau, Integer first, Integer n, uint64_t* out)
+	{
+		s_unpackTable[tau](src, first, n, out);
+	}
+
+	SIMD_TARGET("sse4.2")
+	static void unpackSSE42(const Integer* src, Integer tau, Integer first, Integer n, uint64_t* out)
+	{
+		const uint8_t* bytes = reinterpret_cast<const uint8_t*>(src);
+		Integer last = first + n;
+		Integer limit = byteLimit(tau, last);
+		Integer segmentBytes = (4 * tau) / 8;
+		Integer i = (first + 7) & ~Integer(7);
+		if (i > last)i = last;
+		s_unpackTable[tau](src, first, i - first, out);
+		out += i - first;
+
+		alignas(16) uint8_t shuffle[32];
+		alignas(16) uint32_t shift[8];
+		alignas(16) uint32_t multiplier[8];
+		buildShuffle(tau, 2, shuffle, shift);
+		//SSE has no variable shifts: x >> s = (x * 2^(7 - s)) >> 7, as long as tau + 7 <= 32
+		for (Integer k = 0; k < 8; k++)multiplier[k] = s_one32 << (7 - shift[k]);
+
+		const __m128i shuffle0 = _mm_load_si128(reinterpret_cast<const __m128i*>(shuffle));
+		const __m128i shuffle1 = _mm_load_si128(reinterpret_cast<const __m128i*>(shuffle + 16));
+		const __m128i multiplier0 = _mm_load_si128(reinterpret_cast<const __m128i*>(multiplier));
+		const __m128i multiplier1 = _mm_load_si128(reinterpret_cast<const __m128i*>(multiplier + 4));
+		const __m128i mask = _mm_set1_epi32(int((s_one32 << tau) - 1));
+
+		for (; i + 8 <= last && i * tau / 8 + segmentBytes + 16 <= limit; i += 8)
+		{
+			const uint8_t* group = bytes + i * tau / 8;
+			__m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+			__m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group + segmentBytes));
+			lo = _mm_and_si128(_mm_srli_epi32(_mm_mullo_epi32(_mm_shuffle_epi8(lo, shuffle0), multiplier0), 7), mask);
+			hi = _mm_and_si128(_mm_srli_epi32(_mm_mullo_epi32(_mm_shuffle_epi8(hi, shuffle1), multiplier1), 7), mask);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_cvtepu32_epi64(lo));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2), _mm_cvtepu32_epi64(_mm_srli_si128(lo, 8)));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4), _mm_cvtepu32_epi64(hi));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 6), _mm_cvtepu32_epi64(_mm_srli_si128(hi, 8)));
+			out += 8;
+		}
+		s_unpackTable[tau](src, i, last - i, out);
+	}
+
+	SIMD_TARGET("avx2")
+	static void unpackAVX2(const Integer* src, Integer tau, Integer first, Integer n, uint64_t* out)
+	{
+		const uint8_t* bytes = reinterpret_cast<const uint8_t*>(src);
+		Integer last = first + n;
+		Integer limit = byteLimit(tau, last);
+		Integer segmentBytes = (4 * tau) / 8;
+		Integer i = (first + 7) & ~Integer(7);
+		if (i > last)i = last;
+		s_unpackTable[tau](src, first, i - first, out);
+		out += i - first;
+
+		alignas(32) uint8_t shuffle[32];
+		alignas(32) uint32_t shift[8];
+		buildShuffle(tau, 2, shuffle, shift);
+
+		const __m256i shuffleMask = _mm256_load_si256(reinterpret_cast<const __m256i*>(shuffle));
+		const __m256i shiftMask = _mm256_load_si256(reinterpret_cast<const __m256i*>(shift));
+		const __m256i mask = _mm256_set1_epi32(int((s_one32 << tau) - 1));
+
+		for (; i + 8 <= last && i * tau / 8 + segmentBytes + 16 <= limit; i += 8)
+		{
+			const uint8_t* group = bytes + i * tau / 8;
+			__m256i data = _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(group)));
+			data = _mm256_inserti128_si256(data, _mm_loadu_si128(reinterpret_cast<const __m128i*>(group + segmentBytes)), 1);
+			data = _mm256_and_si256(_mm256_srlv_epi32(_mm256_shuffle_epi8(data, shuffleMask), shiftMask), mask);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_cvtepu32_epi64(_mm256_castsi256_si128(data)));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 4), _mm256_cvtepu32_epi64(_mm256_extracti128_si256(data, 1)));
+			out += 8;
+		}
+		s_unpackTable[tau](src, i, last - i, out);
+	}
+
+	SIMD_TARGET("avx512f,avx512bw")
+	static void unpackAVX512(const Integer* src, Integer tau, Integer first, Integer n, uint64_t* out)
+	{
+		const uint8_t* bytes = reinterpret_cast<const uint8_t*>(src);
+		Integer last = first + n;
+		Integer limit = byteLimit(tau, last);
+		Integer segmentBytes = (4 * tau) / 8;
+		Integer i = (first + 15) & ~Integer(15);
+		if (i > last)i = last;
+		s_unpackTable[tau](src, first, i - first, out);
+		out += i - first;
+
+		alignas(64) uint8_t shuffle[64];
+		alignas(64) uint32_t shift[16];
+		buildShuffle(tau, 4, shuffle, shift);
+
+		const __m512i shuffleMask = _mm512_load_si512(shuffle);
+		const __m512i shiftMask = _mm512_load_si512(shift);
+		const __m512i mask = _mm512_set1_epi32(int((s_one32 << tau) - 1));
+
+		for (; i + 16 <= last && i * tau / 8 + 3 * segmentBytes + 16 <= limit; i += 16)
+		{
+			const uint8_t* group = bytes + i * tau / 8;
+			__m512i data = _mm512_castsi128_si512(_mm_loadu_si128(reinterpret_cast<const __m128i*>(group)));
+			data = _mm512_inserti32x4(data, _mm_loadu_si128(reinterpret_cast<const __m128i*>(group + segmentBytes)), 1);
+			data = _mm512_inserti32x4(data, _mm_loadu_si128(reinterpret_cast<const __m128i*>(group + 2 * segmentBytes)), 2);
+			data = _mm512_inserti32x4(data, _mm_loadu_si128(reinterpret_cast<const __m128i*>(group + 3 * segmentBytes)), 3);
+			data = _mm512_and_si512(_mm512_srlv_epi32(_mm512_shuffle_epi8(data, shuffleMask), shiftMask), mask);
+			_mm512_storeu_si512(out, _mm512_cvtepu32_epi64(_mm512_castsi512_si256(data)));
+			_mm512_storeu_si512(out + 8, _mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(data, 1)));
+			out += 16;
+		}
+		s_unpackTable[tau](src, i, last - i, out);
+	}
+
+	static const SimdUnpackFunction s_simdUnpackTable[4] = { unpackScalar, unpackSSE42, unpackAVX2, unpackAVX512 };
+
+	InstructionSet detectInstructionSet()
+	{
+		static const InstructionSet s_detected = queryInstructionSet();
+		return s_detected;
+	}
+
+	InstructionSet instructionSet()
+	{
+		return InstructionSet(s_instructionSet.load(std::memory_order_relaxed));
+	}
+
+	void setInstructionSet(InstructionSet set)
+	{
+		if (uint8_t(set) > uint8_t(detectInstructionSet()))set = detectInstructionSet();
+		s_instructionSet.store(uint8_t(set), std::memory_order_relaxed);
+	}
+
+	void unpackSimd(InstructionSet set, const Integer* src, Integer tau, Integer first, Integer n, uint64_t* out)
+	{
+		if (tau > SIMD_MAX_TAU || n < SIMD_MIN_ELEMENTS)set = InstructionSet::Scalar;
+		s_simdUnpackTable[uint8_t(set)](src, tau, first, n, out);
+	}
+
+	void unpackSimd(const Integer* src, Integer tau, Integer first, Integer n, uint64_t* out)
+	{
+		unpackSimd(instructionSet(), src, tau, first, n, out);
+	}
+};
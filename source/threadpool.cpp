@@ -0,0 +1,96 @@
+#include "threadpool.h"
+
+namespace ds
+{
+	//the pool, whose task the current thread executes, a parallelFor of this pool from within the task runs inline
+	static thread_local const ThreadPool* s_currentPool = nullptr;
+
+	ThreadPool::ThreadPool(Integer threads) : m_task(nullptr), m_count(0), m_next(0), m_busy(0), m_generation(0), m_stop(false)
+	{
+		if (threads == 0)threads = Integer(std::thread::hardware_concurrency());
+		if (threads == 0)threads = 1;
+		for (Integer i = 1; i < threads; i++)m_workers.emplace_back([this] { work(); });
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+		}
+		m_wake.notify_all();
+		for (std::thread& worker : m_workers)worker.join();
+	}
+
+	Integer ThreadPool::size() const
+	{
+		return Integer(m_workers.size()) + 1;
+	}
+
+	void ThreadPool::drain()
+	{
+		const ThreadPool* outer = s_currentPool;
+		s_currentPool = this;
+		for (Integer i = m_next++; i < m_count; i = m_next++)
+		{
+			try
+			{
+				(*m_task)(i);
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				if (!m_error)m_error = std::current_exception();
+			}
+		}
+		s_currentPool = outer;
+	}
+
+	void ThreadPool::work()
+	{
+		uint64_t seen = 0;
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_wake.wait(lock, [&] { return m_stop || m_generation != seen; });
+				if (m_stop)return;
+				seen = m_generation;
+			}
+			drain();
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (--m_busy == 0)m_done.notify_one();
+		}
+	}
+
+	void ThreadPool::parallelFor(Integer n, const std::function<void(Integer)>& task)
+	{
+		//nested in a task of this pool the outer call holds m_jobMutex and occupies the workers
+		if (s_currentPool == this || m_workers.empty() || n <= 1)
+		{
+			for (Integer i = 0; i < n; i++)task(i);
+			return;
+		}
+		std::lock_guard<std::mutex> job(m_jobMutex);
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_task = &task;
+			m_count = n;
+			m_next = 0;
+			m_busy = Integer(m_workers.size());
+			m_error = nullptr;
+			m_generation++;
+		}
+		m_wake.notify_all();
+		drain();
+		std::exception_ptr error;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_done.wait(lock, [&] { return m_busy == 0; });
+			m_task = nullptr;
+			error = m_error;
+			m_error = nullptr;
+		}
+		if (error)std::rethrow_exception(error);
+	}
+};
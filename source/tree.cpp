@@ -0,0 +1,421 @@
+#include "tree.h"
+#include <algorithm>
+#include <climits>
+
+namespace ds
+{
+	/*
+		Excess of the 8 parentheses of a byte (bit 0 first): the excess behind the byte, the minimum excess behind one of
+		its parentheses and the leftmost position of that minimum, all relative to the excess in front of the byte.
+	*/
+	struct ExcessTable
+	{
+		int8_t m_excess[256];
+		int8_t m_minimum[256];
+		uint8_t m_position[256];
+
+		ExcessTable()
+		{
+			for (uint32_t byte = 0; byte < 256; byte++)
+			{
+				int32_t excess = 0;
+				int32_t minimum = 8;
+				uint32_t position = 0;
+				for (uint32_t k = 0; k < 8; k++)
+				{
+					excess += (byte >> k) & 1 ? 1 : -1;
+					if (excess < minimum)
+					{
+						minimum = excess;
+						position = k;
+					}
+				}
+				m_excess[byte] = int8_t(excess);
+				m_minimum[byte] = int8_t(minimum);
+				m_position[byte] = uint8_t(position);
+			}
+		}
+	};
+
+	static const ExcessTable& excessTable()
+	{
+		static const ExcessTable s_table;
+		return s_table;
+	}
+};
+
+ds::CompressedTree::CompressedTree(const std::vector<uint32_t>& parents) : m_parentheses(uint32_t(2 * parents.size()))
+{
+	//the path from the root to the last node, every node is closed when the traversal leaves its subtree
+	std::vector<uint32_t> path;
+	uint32_t position = 0;
+	for (uint32_t v = 0; v < parents.size(); v++)
+	{
+		while (!path.empty() && path.back() != parents[v])
+		{
+			path.pop_back();
+			position++;
+		}
+		m_parentheses.setBit(position++);
+		path.push_back(v);
+	}
+	buildIndex();
+}
+
+ds::CompressedTree::CompressedTree(Bitstring parentheses) : m_parentheses(std::move(parentheses))
+{
+	buildIndex();
+}
+
+void ds::CompressedTree::buildIndex()
+{
+	if (!m_parentheses.isFrozen())m_parentheses.freeze();
+	m_nodes = m_parentheses.numberOfOnes();
+	uint32_t n = m_parentheses.numberOfElements();
+	m_blocks = (n + COMPRESSED_TREE_BLOCK_BITS - 1) / COMPRESSED_TREE_BLOCK_BITS;
+	m_leaves = 1;
+	while (m_leaves < m_blocks)m_leaves *= 2;
+	m_minTree.assign(2 * m_leaves, INT32_MAX);
+
+	int32_t excess = 0;
+	for (uint32_t b = 0; b < m_blocks; b++)
+	{
+		uint32_t end = (b + 1) * COMPRESSED_TREE_BLOCK_BITS;
+		int32_t minimum = INT32_MAX;
+		uint32_t position = 0;
+		scanMinimum(b * COMPRESSED_TREE_BLOCK_BITS, end < n ? end : n, excess, minimum, position);
+		m_minTree[m_leaves + b] = minimum;
+	}
+	for (uint32_t v = m_leaves - 1; v > 0; v--)
+	{
+		m_minTree[v] = std::min(m_minTree[2 * v], m_minTree[2 * v + 1]);
+	}
+}
+
+int32_t ds::CompressedTree::excessBefore(uint32_t i) const
+{
+	return int32_t(2 * int64_t(m_parentheses.rank1(i)) - int64_t(i));
+}
+
+/*
+	The first position j in [from, to) with an excess <= target behind it, to if there is none. excess is the excess in
+	front of from and is advanced with the scan. Whole bytes, which can not contain j, are skipped with the table, the
+	bytes of one word are taken from a single load.
+*/
+uint32_t ds::CompressedTree::scanForward(uint32_t from, uint32_t to, int32_t target, int32_t& excess) const
+{
+	const ExcessTable& table = excessTable();
+	uint32_t j = from;
+	while (j < to)
+	{
+		if ((j & 7) == 0 && to - j >= 8)
+		{
+			uint64_t word = m_parentheses.word64(j / 64) >> (j & 63);
+			uint32_t end = std::min((j | 63) + 1, to & ~uint32_t(7));
+			while (j < end && excess + table.m_minimum[word & 255] > target)
+			{
+				excess += table.m_excess[word & 255];
+				word >>= 8;
+				j += 8;
+			}
+			if (j == end)continue;
+			//the byte at j contains the position
+			for (uint32_t k = 0; k < 8; k++, j++)
+			{
+				excess += (word >> k) & 1 ? 1 : -1;
+				if (excess <= target)return j;
+			}
+		}
+		excess += m_parentheses.isBitSet(j) ? 1 : -1;
+		if (excess <= target)return j;
+		j++;
+	}
+	return to;
+}
+
+/*
+	The last position j in [from, to) with an excess <= target behind it, COMPRESSED_TREE_NONE if there is none. excess is
+	the excess in front of to and is moved back with the scan.
+*/
+uint32_t ds::CompressedTree::scanBackward(uint32_t from, uint32_t to, int32_t target, int32_t& excess) const
+{
+	const ExcessTable& table = excessTable();
+	uint32_t j = to;
+	while (j > from)
+	{
+		if ((j & 7) == 0 && j - from >= 8)
+		{
+			uint64_t word = m_parentheses.word64((j - 1) / 64);
+			uint32_t begin = std::max((j - 1) & ~uint32_t(63), (from + 7) & ~uint32_t(7));
+			uint32_t byte = 0;
+			while (j > begin)
+			{
+				byte = uint32_t(word >> ((j - 8) & 63)) & 255;
+				if (excess - table.m_excess[byte] + table.m_minimum[byte] <= target)break;
+				excess -= table.m_excess[byte];
+				j -= 8;
+			}
+			if (j == begin)continue;
+			//the byte in front of j contains the position
+			for (uint32_t k = 8; k > 0; k--, j--)
+			{
+				if (excess <= target)return j - 1;
+				excess -= (byte >> (k - 1)) & 1 ? 1 : -1;
+			}
+		}
+		//excess is the excess behind j - 1
+		if (excess <= target)return j - 1;
+		excess -= m_parentheses.isBitSet(j - 1) ? 1 : -1;
+		j--;
+	}
+	return COMPRESSED_TREE_NONE;
+}
+
+/*
+	Lowers minimum to the smallest excess behind a position in [from, to), position is the leftmost position with it. Only
+	a strictly smaller excess replaces minimum, so the leftmost position wins across several calls.
+*/
+void ds::CompressedTree::scanMinimum(uint32_t from, uint32_t to, int32_t& excess, int32_t& minimum, uint32_t& position) const
+{
+	const ExcessTable& table = excessTable();
+	uint32_t j = from;
+	while (j < to)
+	{
+		if ((j & 7) == 0 && to - j >= 8)
+		{
+			uint64_t word = m_parentheses.word64(j / 64) >> (j & 63);
+			uint32_t end = std::min((j | 63) + 1, to & ~uint32_t(7));
+			for (; j < end; j += 8, word >>= 8)
+			{
+				uint32_t byte = uint32_t(word) & 255;
+				if (excess + table.m_minimum[byte] < minimum)
+				{
+					minimum = excess + table.m_minimum[byte];
+					position = j + table.m_position[byte];
+				}
+				excess += table.m_excess[byte];
+			}
+			continue;
+		}
+		excess += m_parentheses.isBitSet(j) ? 1 : -1;
+		if (excess < minimum)
+		{
+			minimum = excess;
+			position = j;
+		}
+		j++;
+	}
+}
+
+/*
+	The first block >= block with a minimum <= target, m_blocks if there is none: up the tree until a right neighbour
+	subtree qualifies, then down to its leftmost qualifying leaf.
+*/
+uint32_t ds::CompressedTree::firstBlockBelow(uint32_t block, int32_t target) const
+{
+	if (block >= m_blocks)return m_blocks;
+	uint32_t v = m_leaves + block;
+	while (m_minTree[v] > target)
+	{
+		while (v & 1)v >>= 1;
+		if (v == 0)return m_blocks;
+		v++;
+	}
+	while (v < m_leaves)
+	{
+		v *= 2;
+		if (m_minTree[v] > target)v++;
+	}
+	return v - m_leaves;
+}
+
+/*
+	The last block <= block with a minimum <= target, COMPRESSED_TREE_NONE if there is none.
+*/
+uint32_t ds::CompressedTree::lastBlockBelow(uint32_t block, int32_t target) const
+{
+	uint32_t v = m_leaves + block;
+	while (m_minTree[v] > target)
+	{
+		while (v > 1 && !(v & 1))v >>= 1;
+		if (v <= 1)return COMPRESSED_TREE_NONE;
+		v--;
+	}
+	while (v < m_leaves)
+	{
+		v = 2 * v + 1;
+		if (m_minTree[v] > target)v--;
+	}
+	return v - m_leaves;
+}
+
+/*
+	The minimum of the blocks [first, ... , last].
+*/
+int32_t ds::CompressedTree::blockMinimum(uint32_t first, uint32_t last) const
+{
+	int32_t minimum = INT32_MAX;
+	uint32_t l = m_leaves + first;
+	uint32_t r = m_leaves + last + 1;
+	while (l < r)
+	{
+		if (l & 1)minimum = std::min(minimum, m_minTree[l++]);
+		if (r & 1)minimum = std::min(minimum, m_minTree[--r]);
+		l >>= 1;
+		r >>= 1;
+	}
+	return minimum;
+}
+
+/*
+	The first position j >= from with an excess <= target behind it, COMPRESSED_TREE_NONE if there is none.
+*/
+uint32_t ds::CompressedTree::forwardSearch(uint32_t from, int32_t target) const
+{
+	uint32_t n = m_parentheses.numberOfElements();
+	if (from >= n)return COMPRESSED_TREE_NONE;
+	int32_t excess = excessBefore(from);
+	uint32_t end = std::min(n, (from / COMPRESSED_TREE_BLOCK_BITS + 1) * COMPRESSED_TREE_BLOCK_BITS);
+	uint32_t j = scanForward(from, end, target, excess);
+	if (j < end)return j;
+
+	uint32_t block = firstBlockBelow(from / COMPRESSED_TREE_BLOCK_BITS + 1, target);
+	if (block >= m_blocks)return COMPRESSED_TREE_NONE;
+	uint32_t begin = block * COMPRESSED_TREE_BLOCK_BITS;
+	end = std::min(n, begin + COMPRESSED_TREE_BLOCK_BITS);
+	excess = excessBefore(begin);
+	return scanForward(begin, end, target, excess);
+}
+
+/*
+	The last position j < to with an excess <= target behind it, COMPRESSED_TREE_NONE if there is none.
+*/
+uint32_t ds::CompressedTree::backwardSearch(uint32_t to, int32_t target) const
+{
+	if (to == 0)return COMPRESSED_TREE_NONE;
+	int32_t excess = excessBefore(to);
+	uint32_t block = (to - 1) / COMPRESSED_TREE_BLOCK_BITS;
+	uint32_t j = scanBackward(block * COMPRESSED_TREE_BLOCK_BITS, to, target, excess);
+	if (j != COMPRESSED_TREE_NONE || block == 0)return j;
+
+	block = lastBlockBelow(block - 1, target);
+	if (block == COMPRESSED_TREE_NONE)return COMPRESSED_TREE_NONE;
+	uint32_t end = std::min(m_parentheses.numberOfElements(), (block + 1) * COMPRESSED_TREE_BLOCK_BITS);
+	excess = excessBefore(end);
+	return scanBackward(block * COMPRESSED_TREE_BLOCK_BITS, end, target, excess);
+}
+
+/*
+	The leftmost position in [from, to] with the smallest excess behind it.
+*/
+uint32_t ds::CompressedTree::minimumPosition(uint32_t from, uint32_t to) const
+{
+	uint32_t first = from / COMPRESSED_TREE_BLOCK_BITS;
+	uint32_t last = to / COMPRESSED_TREE_BLOCK_BITS;
+	int32_t excess = excessBefore(from);
+	int32_t minimum = INT32_MAX;
+	uint32_t position = from;
+	if (first == last)
+	{
+		scanMinimum(from, to + 1, excess, minimum, position);
+		return position;
+	}
+	scanMinimum(from, (first + 1) * COMPRESSED_TREE_BLOCK_BITS, excess, minimum, position);
+	if (last - first > 1)
+	{
+		int32_t inner = blockMinimum(first + 1, last - 1);
+		if (inner < minimum)
+		{
+			//the first inner block, which reaches the minimum, and in it the first position
+			uint32_t block = firstBlockBelow(first + 1, inner);
+			uint32_t begin = block * COMPRESSED_TREE_BLOCK_BITS;
+			excess = excessBefore(begin);
+			position = scanForward(begin, begin + COMPRESSED_TREE_BLOCK_BITS, inner, excess);
+			minimum = inner;
+		}
+	}
+	uint32_t begin = last * COMPRESSED_TREE_BLOCK_BITS;
+	excess = excessBefore(begin);
+	scanMinimum(begin, to + 1, excess, minimum, position);
+	return position;
+}
+
+uint32_t ds::CompressedTree::findClose(uint32_t i) const
+{
+	return forwardSearch(i + 1, excessBefore(i));
+}
+
+/*
+	The opening parenthesis of the parent of the node opened at i > 0: the excess drops to depth - 1 last right in front of it.
+*/
+uint32_t ds::CompressedTree::enclose(uint32_t i) const
+{
+	uint32_t j = backwardSearch(i, excessBefore(i) - 1);
+	return j == COMPRESSED_TREE_NONE ? 0 : j + 1;
+}
+
+uint32_t ds::CompressedTree::size() const
+{
+	return m_nodes;
+}
+
+uint32_t ds::CompressedTree::parent(uint32_t v) const
+{
+	if (v == 0)return COMPRESSED_TREE_NONE;
+	return m_parentheses.rank1(enclose(m_parentheses.select1(v)));
+}
+
+uint32_t ds::CompressedTree::firstChild(uint32_t v) const
+{
+	uint32_t i = m_parentheses.select1(v);
+	return m_parentheses.isBitSet(i + 1) ? v + 1 : COMPRESSED_TREE_NONE;
+}
+
+uint32_t ds::CompressedTree::nextSibling(uint32_t v) const
+{
+	uint32_t i = m_parentheses.select1(v);
+	uint32_t close = findClose(i);
+	//the close of the root is the last parenthesis, the bits behind it are unset
+	return m_parentheses.isBitSet(close + 1) ? v + (close - i + 1) / 2 : COMPRESSED_TREE_NONE;
+}
+
+uint32_t ds::CompressedTree::subtreeSize(uint32_t v) const
+{
+	uint32_t i = m_parentheses.select1(v);
+	return (findClose(i) - i + 1) / 2;
+}
+
+uint32_t ds::CompressedTree::depth(uint32_t v) const
+{
+	return uint32_t(excessBefore(m_parentheses.select1(v)));
+}
+
+uint32_t ds::CompressedTree::lca(uint32_t u, uint32_t v) const
+{
+	if (u > v)std::swap(u, v);
+	uint32_t i = m_parentheses.select1(u);
+	uint32_t j = m_parentheses.select1(v);
+	if (j <= findClose(i))return u;
+	//the first minimum between them closes the child of the lca, which contains u, its next sibling opens right behind it
+	return parent(m_parentheses.rank1(minimumPosition(i, j) + 1));
+}
+
+bool ds::CompressedTree::isAncestor(uint32_t u, uint32_t v) const
+{
+	return u <= v && v - u < subtreeSize(u);
+}
+
+bool ds::CompressedTree::isLeaf(uint32_t v) const
+{
+	return !m_parentheses.isBitSet(m_parentheses.select1(v) + 1);
+}
+
+const ds::Bitstring& ds::CompressedTree::parentheses() const
+{
+	return m_parentheses;
+}
+
+uint64_t ds::CompressedTree::byteSize() const
+{
+	return (uint64_t(m_parentheses.numberOfElements()) + 7) / 8 + m_minTree.size() * sizeof(int32_t);
+}